@@ -32,6 +32,7 @@ CHECK_NEW_VERSION=true
 SOFTWARE_RENDERING=false
 UI_SCALE=4
 TRIM_ON_SAVE=false
+COVER_CACHE_KB=4096
 
 ---------------------------
 function TIC()
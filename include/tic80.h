@@ -48,6 +48,9 @@ extern "C" {
 #define TIC80_SAMPLE_CHANNELS   2
 #define TIC80_FRAMERATE         60
 
+#define TIC80_DIRTY_BITS        32
+#define TIC80_DIRTY_ROW(tic, row) ((tic)->dirty.rows[(row) / TIC80_DIRTY_BITS] >> ((row) % TIC80_DIRTY_BITS) & 1)
+
 typedef enum {
     TIC80_PIXEL_COLOR_ARGB8888 = (1 << 8) | 32,
     TIC80_PIXEL_COLOR_ABGR8888 = (2 << 8) | 32,
@@ -71,6 +74,13 @@ typedef struct
     } samples;
 
     u32 *screen;
+
+    // screen rows changed by the last blit, see TIC80_DIRTY_ROW()
+    struct
+    {
+        u32 rows[(TIC80_FULLHEIGHT + TIC80_DIRTY_BITS - 1) / TIC80_DIRTY_BITS];
+        bool unchanged;
+    } dirty;
 } tic80;
 
 typedef union
@@ -180,6 +190,66 @@ TIC80_API void tic80_tick(tic80* tic, tic80_input input, u64 (*counter)(), u64 (
 TIC80_API void tic80_sound(tic80* tic);
 TIC80_API void tic80_delete(tic80* tic);
 
+// frames kept by the phase profiler, the oldest ones are dropped
+#define TIC80_PERF_FRAMES       256
+
+typedef enum {
+    // script callbacks without the draw calls made from them
+    TIC80_PERF_SCRIPT,
+    // draw api calls
+    TIC80_PERF_DRAW,
+    // SCN and BDR callbacks called during the blit
+    TIC80_PERF_CALLBACKS,
+    TIC80_PERF_BLIT,
+    TIC80_PERF_SOUND,
+    // studio screens and overlays
+    TIC80_PERF_STUDIO,
+    // screen texture upload, reported by the frontend
+    TIC80_PERF_UPLOAD,
+    TIC80_PERF_PHASES
+} tic80_perf_phase;
+
+typedef struct
+{
+    u64 ns[TIC80_PERF_PHASES];
+} tic80_perf_frame;
+
+TIC80_API void tic80_perf_enable(tic80* tic, bool enable);
+// copies up to count of the last finished frames, oldest first, and returns how many were copied
+TIC80_API s32 tic80_perf_frames(tic80* tic, tic80_perf_frame* frames, s32 count);
+// adds time measured by the embedder, e.g. TIC80_PERF_UPLOAD, to the current frame
+TIC80_API void tic80_perf_add(tic80* tic, tic80_perf_phase phase, u64 ns);
+
+// counts, time and size of every api call the cart makes, per frame and in total
+TIC80_API void tic80_api_stats_enable(tic80* tic, bool enable);
+// writes the recorded stats as chrome trace json, returns the length like snprintf does
+TIC80_API s32 tic80_api_stats_trace(tic80* tic, char* buffer, s32 size);
+
+// a batch owns many instances and steps them all one frame at a time on a worker pool,
+// their frames are written back to back into one buffer
+// instances can tick on different threads, except janet and python carts: their vms keep
+// process wide state, so every instance running them has to be ticked from the same thread
+typedef struct tic80_batch tic80_batch;
+
+typedef enum {
+    // composited palette indices, 4 bits per pixel with even pixels in the low nibble
+    TIC80_BATCH_FRAME_INDEXED,
+    // RGB888 colors averaged over scale x scale blocks of the visible screen
+    TIC80_BATCH_FRAME_RGB,
+} tic80_batch_frame_format;
+
+// scale is 1, 2, 4 or 8 and only applies to RGB frames, threads <= 0 uses every cpu
+TIC80_API tic80_batch* tic80_batch_create(s32 count, s32 samplerate, tic80_batch_frame_format format, s32 scale, s32 threads);
+// loads the cart into every instance, janet and python carts are then stepped one
+// instance after another on the calling thread
+TIC80_API void tic80_batch_load(tic80_batch* batch, void* cart, s32 size);
+TIC80_API void tic80_batch_reset(tic80_batch* batch, s32 index);
+TIC80_API tic80* tic80_batch_get(tic80_batch* batch, s32 index);
+// inputs holds one entry per instance or is NULL, the returned frames stay valid until the next step
+TIC80_API const u8* tic80_batch_step(tic80_batch* batch, const tic80_input* inputs, u64 (*counter)(), u64 (*freq)());
+TIC80_API s32 tic80_batch_frame_size(const tic80_batch* batch);
+TIC80_API void tic80_batch_delete(tic80_batch* batch);
+
 #ifdef __cplusplus
 }
 #endif
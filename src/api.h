@@ -110,6 +110,9 @@ typedef struct
     tic_lang_isalnum lang_isalnum;
     bool useStructuredEdition;
 
+    // the vm keeps process wide state, instances running it can't tick on different threads
+    bool singleThreaded;
+
     s32 api_keywordsCount;
     const char** api_keywords;
     
@@ -293,6 +296,22 @@ enum
         u8* trans_colors, u8 trans_count, s32 scale, tic_flip flip, tic_rotate rotate)                                  \
                                                                                                                         \
                                                                                                                         \
+    macro(sprs,                                                                                                         \
+        "sprs(addr count)",                                                                                             \
+                                                                                                                        \
+        "Draws `count` sprites from a table of 8 byte records in RAM starting at `addr`, in a single call.\n"           \
+        "Each record holds the sprite id (2 bytes), x and y (2 signed bytes each), "                                    \
+        "flip + rotate * 4 + scale * 16 (1 byte) and the colorkey (1 byte), in little endian order.\n"                  \
+        "A scale of 0 draws at 1 and a colorkey over 15 leaves every color opaque.\n"                                   \
+        "The sprites are drawn in the table order, the same as calling `spr()` for each record, "                       \
+        "which makes it a cheap way to draw particles and other large groups of sprites.",                              \
+        2,                                                                                                              \
+        2,                                                                                                              \
+        0,                                                                                                              \
+        void,                                                                                                           \
+        tic_mem*, s32 address, s32 count)                                                                               \
+                                                                                                                        \
+                                                                                                                        \
     macro(btn,                                                                                                          \
         "btn(id) -> pressed",                                                                                           \
                                                                                                                         \
@@ -367,8 +386,11 @@ enum
         "The map function's last parameter is a powerful callback function "                                            \
         "for changing how map cells (sprites) are drawn when map is called.\n"                                          \
         "It can be used to rotate, flip and replace sprites while the game is running.\n"                               \
+        "The callback is called for every cell of the area, even the ones outside the clip rect.\n"                     \
         "Unlike mset, which saves changes to the map, this special function can be used to create "                     \
         "animated tiles or replace them completely.\n"                                                                  \
+        "Instead of a function, remap can be the RAM address of a 512 byte table, two bytes per sprite: "              \
+        "the new index and flip + rotate * 4. It's much faster than a callback for large maps.\n"                     \
         "Some examples include changing sprites to open doorways, "                                                     \
         "hiding sprites used to spawn objects in your game and even to emit the objects themselves.\n"                  \
         "The tilemap is laid out sequentially in RAM - writing 1 to 0x08000 "                                           \
@@ -513,6 +535,33 @@ enum
         tic_mem*, s32 address, u8 value)                                                                                \
                                                                                                                         \
                                                                                                                         \
+    macro(peeks,                                                                                                        \
+        "peeks(addr count bits=8) -> values",                                                                           \
+                                                                                                                        \
+        "This function reads `count` values in a row starting at `addr`, in a single call.\n"                           \
+        "It returns the same values as calling `peek()` for each address, 0 for the ones outside of RAM.\n"             \
+        "Use it instead of a loop of `peek4()` calls, e.g. to read the screen for software rendering.\n"                \
+        "`bits` allowed to be 1,2,4,8 and addresses count in units of `bits`, like in `peek()`.",                       \
+        3,                                                                                                              \
+        2,                                                                                                              \
+        0,                                                                                                              \
+        void,                                                                                                           \
+        tic_mem*, s32 address, s32 count, s32 bits, u8* values)                                                         \
+                                                                                                                        \
+                                                                                                                        \
+    macro(pokes,                                                                                                        \
+        "pokes(addr values bits=8)",                                                                                    \
+                                                                                                                        \
+        "This function writes an array of values in a row starting at `addr`, in a single call.\n"                      \
+        "It does the same as calling `poke()` for each value, values outside of RAM are skipped.\n"                     \
+        "`bits` allowed to be 1,2,4,8 and addresses count in units of `bits`, like in `poke()`.",                       \
+        3,                                                                                                              \
+        2,                                                                                                              \
+        0,                                                                                                              \
+        void,                                                                                                           \
+        tic_mem*, s32 address, const u8* values, s32 count, s32 bits)                                                   \
+                                                                                                                        \
+                                                                                                                        \
     macro(memcpy,                                                                                                       \
         "memcpy(dest source size)",                                                                                     \
                                                                                                                         \
@@ -835,6 +884,27 @@ enum
 TIC_API_LIST(TIC_API_DEF)
 #undef TIC_API_DEF
 
+typedef enum
+{
+#define TIC_API_DEF(name, ...) tic_api_id_##name,
+    TIC_API_LIST(TIC_API_DEF)
+#undef TIC_API_DEF
+    tic_api_id_count
+} tic_api_id;
+
+// log2 buckets of the call time, the first one holds calls under 128ns, the last one calls over 1ms
+#define TIC_API_STATS_BUCKETS 15
+
+typedef struct
+{
+    u64 calls;
+    u64 ns;
+    // size is the work a call asked for: pixels for spr/map/rect/..., bytes for memcpy/memset, chars for trace
+    u64 size;
+    u64 maxSize;
+    u32 hist[TIC_API_STATS_BUCKETS];
+} tic_api_stat;
+
 struct tic_mem
 {
     tic80           product;
@@ -876,8 +946,42 @@ void tic_core_tick_end(tic_mem* memory);
 void tic_core_synth_sound(tic_mem* tic);
 void tic_core_blit(tic_mem* tic);
 void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb);
+// composites both vbanks into 4bpp palette indices, TIC80_WIDTH * TIC80_HEIGHT / 2 bytes, without callbacks
+void tic_core_blit_indexed(tic_mem* tic, u8* dst);
+void tic_core_invalidate(tic_mem* tic);
+void tic_core_invalidate_rows(tic_mem* tic, s32 from, s32 to);
 const tic_script_config* tic_core_script_config(tic_mem* memory);
 
+// monotonic clock in ns for the profiler
+u64 tic_core_perf_now();
+void tic_core_perf_enable(tic_mem* tic, bool enable);
+bool tic_core_perf_enabled(tic_mem* tic);
+s32 tic_core_perf_frames(tic_mem* tic, tic80_perf_frame* frames, s32 count);
+void tic_core_perf_add(tic_mem* tic, tic80_perf_phase phase, u64 ns);
+s32 tic_core_perf_begin(tic_mem* tic, tic80_perf_phase phase);
+void tic_core_perf_end(tic_mem* tic, s32 prev);
+
+// most values peeks()/pokes() move in one call, every bit of ram
+#define TIC_PEEKS_MAX (TIC_RAM_SIZE * BITS_IN_BYTE)
+
+// sprs() record in ram, little endian: u16 index, s16 x, s16 y,
+// u8 flip | rotate << 2 | scale << 4 where 0 draws at 1, u8 colorkey where values over 15 mean none
+#define TIC_SPRITE_RECORD_SIZE 8
+
+// map() remapped by a table in ram instead of a script callback, TIC_REMAP_TABLE_SIZE bytes at address,
+// two per tile: the new index and flip | rotate << 2, addresses out of ram or 0 mean no remap
+#define TIC_REMAP_TABLE_SIZE (TIC_BANK_SPRITES * 2)
+void tic_core_map_table(tic_mem* tic, s32 x, s32 y, s32 width, s32 height, s32 sx, s32 sy, u8* colors, u8 count, s32 scale, s32 address);
+
+// per api call stats, recorded for the calls a cart makes from scripts
+void tic_core_api_stats_enable(tic_mem* tic, bool enable);
+bool tic_core_api_stats_enabled(tic_mem* tic);
+// totals since the stats were enabled, NULL when disabled, frames gets the number of finished frames
+const tic_api_stat* tic_core_api_stats(tic_mem* tic, s32* frames);
+const char* tic_core_api_name(tic_api_id id);
+// writes the recorded frames as chrome trace json, returns the length like snprintf does
+s32 tic_core_api_trace(tic_mem* tic, char* buffer, s32 size);
+
 #define VBANK(tic, bank)                                \
     bool MACROVAR(_bank_) = tic_api_vbank(tic, bank);   \
     SCOPE(tic_api_vbank(tic, MACROVAR(_bank_)))
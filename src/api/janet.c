@@ -39,6 +39,7 @@ static Janet janet_line(int32_t argc, Janet* argv);
 static Janet janet_rect(int32_t argc, Janet* argv);
 static Janet janet_rectb(int32_t argc, Janet* argv);
 static Janet janet_spr(int32_t argc, Janet* argv);
+static Janet janet_sprs(int32_t argc, Janet* argv);
 static Janet janet_btn(int32_t argc, Janet* argv);
 static Janet janet_btnp(int32_t argc, Janet* argv);
 static Janet janet_sfx(int32_t argc, Janet* argv);
@@ -53,6 +54,8 @@ static Janet janet_peek2(int32_t argc, Janet* argv);
 static Janet janet_poke2(int32_t argc, Janet* argv);
 static Janet janet_peek4(int32_t argc, Janet* argv);
 static Janet janet_poke4(int32_t argc, Janet* argv);
+static Janet janet_peeks(int32_t argc, Janet* argv);
+static Janet janet_pokes(int32_t argc, Janet* argv);
 static Janet janet_memcpy(int32_t argc, Janet* argv);
 static Janet janet_memset(int32_t argc, Janet* argv);
 static Janet janet_trace(int32_t argc, Janet* argv);
@@ -101,6 +104,7 @@ static const JanetReg janet_c_functions[] =
     {"rect", janet_rect, NULL},
     {"rectb", janet_rectb, NULL},
     {"spr", janet_spr, NULL},
+    {"sprs", janet_sprs, NULL},
     {"btn", janet_btn, NULL},
     {"btnp", janet_btnp, NULL},
     {"sfx", janet_sfx, NULL},
@@ -115,6 +119,8 @@ static const JanetReg janet_c_functions[] =
     {"poke2", janet_poke2, NULL},
     {"peek4", janet_peek4, NULL},
     {"poke4", janet_poke4, NULL},
+    {"peeks", janet_peeks, NULL},
+    {"pokes", janet_pokes, NULL},
     {"memcpy", janet_memcpy, NULL},
     {"memset", janet_memset, NULL},
     {"trace", janet_trace, NULL},
@@ -159,10 +165,32 @@ static const char* const JanetKeywords[] =
     "splice", ";"
 };
 
-static JanetFiber* GameFiber = NULL;
-static JanetBuffer *errBuffer;
+// janet is built single threaded, its vm lives in globals and every instance
+// keeps a copy of its own, loaded back whenever the instance runs
+typedef struct
+{
+    JanetVM* vm;
+    JanetTable* env;
+    JanetFiber* fiber;
+    JanetBuffer* err;
+} JanetState;
+
+// the instance the janet globals currently belong to
 static tic_core* CurrentMachine = NULL;
 
+static void switchJanetMachine(tic_core* core)
+{
+    if(CurrentMachine != core)
+    {
+        if(CurrentMachine)
+            janet_vm_save(((JanetState*)CurrentMachine->currentVM)->vm);
+
+        if(core)
+            janet_vm_load(((JanetState*)core->currentVM)->vm);
+
+        CurrentMachine = core;
+    }
+}
 
 static inline tic_core* getJanetMachine(void)
 {
@@ -396,6 +424,19 @@ static Janet janet_spr(int32_t argc, Janet* argv)
     return janet_wrap_nil();
 }
 
+static Janet janet_sprs(int32_t argc, Janet* argv)
+{
+    janet_fixarity(argc, 2);
+
+    s32 address = (s32)janet_getinteger(argv, 0);
+    s32 count = (s32)janet_getinteger(argv, 1);
+
+    tic_mem* memory = (tic_mem*)getJanetMachine();
+    tic_api_sprs(memory, address, count);
+
+    return janet_wrap_nil();
+}
+
 static Janet janet_btn(int32_t argc, Janet* argv)
 {
     janet_fixarity(argc, 1);
@@ -512,6 +553,12 @@ static Janet janet_map(int32_t argc, Janet* argv)
                     colorkey.colors, colorkey.count,
                     scale, NULL, NULL);
     }
+    else if (janet_checktype(argv[8], JANET_NUMBER))
+    {
+        tic_core_map_table(memory, x, y, w, h, sx, sy,
+                    colorkey.colors, colorkey.count,
+                    scale, (s32)janet_getinteger(argv, 8));
+    }
     else
     {
         JanetFunction *remap = janet_getfunction(argv, 8);
@@ -637,6 +684,54 @@ static Janet janet_poke4(int32_t argc, Janet* argv)
     return janet_wrap_nil();
 }
 
+static Janet janet_peeks(int32_t argc, Janet* argv)
+{
+    janet_arity(argc, 2, 3);
+    s32 address = (s32)janet_getinteger(argv, 0);
+    s32 count = MIN(MAX((s32)janet_getinteger(argv, 1), 0), TIC_PEEKS_MAX);
+    s32 bits = (s32)janet_optinteger(argv, argc, 2, BITS_IN_BYTE);
+
+    u8* values = malloc(count);
+
+    tic_mem* memory = (tic_mem*)getJanetMachine();
+    tic_api_peeks(memory, address, count, bits, values);
+
+    Janet* result = janet_tuple_begin(count);
+    for (s32 i = 0; i < count; i++)
+        result[i] = janet_wrap_integer(values[i]);
+
+    free(values);
+    return janet_wrap_tuple(janet_tuple_end(result));
+}
+
+static Janet janet_pokes(int32_t argc, Janet* argv)
+{
+    janet_arity(argc, 2, 3);
+    s32 address = (s32)janet_getinteger(argv, 0);
+    JanetView view = janet_getindexed(argv, 1);
+    s32 bits = (s32)janet_optinteger(argv, argc, 2, BITS_IN_BYTE);
+
+    s32 count = MIN(view.len, TIC_PEEKS_MAX);
+    u8* values = malloc(count);
+
+    for (s32 i = 0; i < count; i++)
+    {
+        if (!janet_checktype(view.items[i], JANET_NUMBER))
+        {
+            free(values);
+            janet_panicf("bad slot #1, expected a list of numbers");
+        }
+
+        values[i] = (u8)janet_unwrap_integer(view.items[i]);
+    }
+
+    tic_mem* memory = (tic_mem*)getJanetMachine();
+    tic_api_pokes(memory, address, values, count, bits);
+
+    free(values);
+    return janet_wrap_nil();
+}
+
 static Janet janet_memcpy(int32_t argc, Janet* argv)
 {
     janet_fixarity(argc, 3);
@@ -1039,9 +1134,11 @@ static Janet janet_fset(int32_t argc, Janet* argv)
 /* ***************** */
 static void reportError(tic_core* core, Janet result)
 {
-    janet_stacktrace(GameFiber, result);
-    janet_buffer_push_u8(errBuffer, 0);
-    core->data->error(core->data->data, errBuffer->data);
+    JanetState* state = core->currentVM;
+
+    janet_stacktrace(state->fiber, result);
+    janet_buffer_push_u8(state->err, 0);
+    core->data->error(core->data->data, state->err->data);
 }
 
 
@@ -1050,17 +1147,24 @@ static void closeJanet(tic_mem* tic)
     tic_core* core = (tic_core*)tic;
 
     if (core->currentVM) {
+        JanetState* state = core->currentVM;
+
+        switchJanetMachine(core);
         janet_deinit();
+        janet_vm_free(state->vm);
+        free(state);
+
         core->currentVM = NULL;
         CurrentMachine = NULL;
-        errBuffer = NULL;
-        GameFiber = NULL;
     }
 }
 
 static bool initJanet(tic_mem* tic, const char* code)
 {
     closeJanet(tic);
+
+    // park the vm of another instance before janet_init() overwrites it
+    switchJanetMachine(NULL);
     janet_init();
     janet_sandbox(JANET_SANDBOX_ALL);
 
@@ -1073,19 +1177,22 @@ static bool initJanet(tic_mem* tic, const char* code)
     janet_table_put(janet_unwrap_table(module_cache), janet_cstringv("tic80"), janet_wrap_table(sub_env));
 
     tic_core* core = (tic_core*)tic;
+    JanetState* state = core->currentVM = calloc(1, sizeof(JanetState));
+    state->vm = janet_vm_alloc();
+    state->env = janet_core_env(NULL);
     CurrentMachine = core;
-    core->currentVM = (JanetTable*)janet_core_env(NULL);
 
     // override the dynamic err to a buffer, so that we can get errors later
-    errBuffer = janet_buffer(1028);
-    janet_setdyn("err", janet_wrap_buffer(errBuffer));
+    state->err = janet_buffer(1028);
+    janet_setdyn("err", janet_wrap_buffer(state->err));
 
-    GameFiber = janet_current_fiber();
+    state->fiber = janet_current_fiber();
     Janet result;
 
     // Load the game source code
-    if (janet_dostring(core->currentVM, code, "main", &result)) {
+    if (janet_dostring(state->env, code, "main", &result)) {
         reportError(core, result);
+        closeJanet(tic);
         return false;
     }
 
@@ -1096,9 +1203,12 @@ static bool initJanet(tic_mem* tic, const char* code)
 static void evalJanet(tic_mem* tic, const char* code)
 {
   tic_core* core = (tic_core*)tic;
+  JanetState* state = core->currentVM;
+
+  switchJanetMachine(core);
 
   Janet result = janet_wrap_nil();
-  if (janet_dostring(core->currentVM, code, "main", &result)) {
+  if (janet_dostring(state->env, code, "main", &result)) {
       reportError(core, result);
   }
 }
@@ -1111,10 +1221,13 @@ static void evalJanet(tic_mem* tic, const char* code)
 static void callJanetTick(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
+    JanetState* state = core->currentVM;
+
+    switchJanetMachine(core);
 
     // Load the TIC function
     Janet pre_fn;
-    (void)janet_resolve(core->currentVM, janet_csymbol(TIC_FN), &pre_fn);
+    (void)janet_resolve(state->env, janet_csymbol(TIC_FN), &pre_fn);
 
     if (janet_type(pre_fn) != JANET_FUNCTION) {
         core->data->error(core->data->data, "(TIC) isn't found :(");
@@ -1123,7 +1236,7 @@ static void callJanetTick(tic_mem* tic)
 
     JanetFunction *tic_fn = janet_unwrap_function(pre_fn);
     Janet result = janet_wrap_nil();
-    JanetSignal status = janet_pcall(tic_fn, 0, NULL, &result, &GameFiber);
+    JanetSignal status = janet_pcall(tic_fn, 0, NULL, &result, &state->fiber);
 
     if (status != JANET_SIGNAL_OK) {
         reportError(core, result);
@@ -1131,10 +1244,10 @@ static void callJanetTick(tic_mem* tic)
 
 #if defined(BUILD_DEPRECATED)
     // call OVR() callback for backward compatibility
-    (void)janet_resolve(core->currentVM, janet_csymbol(OVR_FN), &pre_fn);
+    (void)janet_resolve(state->env, janet_csymbol(OVR_FN), &pre_fn);
     if (janet_type(pre_fn) == JANET_FUNCTION) {
         JanetFunction *ovr_fn = janet_unwrap_function(pre_fn);
-        JanetSignal status = janet_pcall(ovr_fn, 0, NULL, &result, &GameFiber);
+        JanetSignal status = janet_pcall(ovr_fn, 0, NULL, &result, &state->fiber);
 
         if (status != JANET_SIGNAL_OK) {
             reportError(core, result);
@@ -1150,9 +1263,12 @@ static void callJanetTick(tic_mem* tic)
 static void callJanetBoot(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
+    JanetState* state = core->currentVM;
+
+    switchJanetMachine(core);
 
     Janet pre_fn;
-    (void)janet_resolve(core->currentVM, janet_csymbol(BOOT_FN), &pre_fn);
+    (void)janet_resolve(state->env, janet_csymbol(BOOT_FN), &pre_fn);
 
     if (janet_type(pre_fn) != JANET_FUNCTION) {
         return;
@@ -1160,7 +1276,7 @@ static void callJanetBoot(tic_mem* tic)
 
     Janet result = janet_wrap_nil();
     JanetFunction *boot_fn = janet_unwrap_function(pre_fn);
-    JanetSignal status = janet_pcall(boot_fn, 0, NULL, &result, &GameFiber);
+    JanetSignal status = janet_pcall(boot_fn, 0, NULL, &result, &state->fiber);
 
     if (status != JANET_SIGNAL_OK) {
         reportError(core, result);
@@ -1174,9 +1290,12 @@ static void callJanetBoot(tic_mem* tic)
 static void callJanetIntCallback(tic_mem* tic, s32 value, void* data, const char* name)
 {
     tic_core* core = (tic_core*)tic;
+    JanetState* state = core->currentVM;
+
+    switchJanetMachine(core);
 
     Janet pre_fn;
-    (void)janet_resolve(core->currentVM, janet_csymbol(name), &pre_fn);
+    (void)janet_resolve(state->env, janet_csymbol(name), &pre_fn);
 
     if (janet_type(pre_fn) != JANET_FUNCTION) {
         return;
@@ -1185,7 +1304,7 @@ static void callJanetIntCallback(tic_mem* tic, s32 value, void* data, const char
     Janet result = janet_wrap_nil();
     Janet argv[] = { janet_wrap_integer(value), };
     JanetFunction *fn = janet_unwrap_function(pre_fn);
-    JanetSignal status = janet_pcall(fn, 1, argv, &result, &GameFiber);
+    JanetSignal status = janet_pcall(fn, 1, argv, &result, &state->fiber);
 
     if (status != JANET_SIGNAL_OK) {
         reportError(core, result);
@@ -1300,6 +1419,9 @@ const tic_script_config JanetSyntaxConfig =
 
     .keywords           = JanetKeywords,
     .keywordsCount      = COUNT_OF(JanetKeywords),
+
+    // janet is built with JANET_SINGLE_THREADED
+    .singleThreaded     = true,
 };
 
 #endif /* defined(TIC_BUILD_WITH_JANET) */
@@ -219,7 +219,7 @@ static JSValue js_rectb(JSContext *ctx, JSValueConst this_val, s32 argc, JSValue
 
 static JSValue js_spr(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
 {
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     s32 index = getInteger2(ctx, argv[0], 0);
@@ -257,6 +257,17 @@ static JSValue js_spr(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueCo
     return JS_UNDEFINED;
 }
 
+static JSValue js_sprs(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
+{
+    s32 address = getInteger2(ctx, argv[0], 0);
+    s32 count = getInteger2(ctx, argv[1], 0);
+
+    tic_mem* tic = (tic_mem*)getCore(ctx);
+    tic_api_sprs(tic, address, count);
+
+    return JS_UNDEFINED;
+}
+
 static JSValue js_btn(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
 {
     tic_mem* tic = (tic_mem*)getCore(ctx);
@@ -449,7 +460,7 @@ static JSValue js_map(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueCo
     s32 sy = getInteger2(ctx, argv[5], 0);
     s32 scale = getInteger2(ctx, argv[7], 1);
 
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     if(JS_IsArray(ctx, argv[6]))
@@ -474,6 +485,10 @@ static JSValue js_map(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueCo
         RemapData data = {ctx, argv[8]};
         tic_api_map((tic_mem*)getCore(ctx), x, y, w, h, sx, sy, colors, count, scale, remapCallback, &data);
     }
+    else if(JS_IsNumber(argv[8]))
+    {
+        tic_core_map_table(tic, x, y, w, h, sx, sy, colors, count, scale, getInteger2(ctx, argv[8], 0));
+    }
     else
     {
         tic_api_map(tic, x, y, w, h, sx, sy, colors, count, scale, NULL, NULL);
@@ -588,6 +603,46 @@ static JSValue js_poke4(JSContext *ctx, JSValueConst this_val, s32 argc, JSValue
     return JS_UNDEFINED;
 }
 
+static JSValue js_peeks(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
+{
+    s32 address = getInteger(ctx, argv[0]);
+    s32 count = MIN(MAX(getInteger(ctx, argv[1]), 0), TIC_PEEKS_MAX);
+    s32 bits = getInteger2(ctx, argv[2], BITS_IN_BYTE);
+
+    tic_mem* tic = (tic_mem*)getCore(ctx);
+
+    u8* values = malloc(count);
+    tic_api_peeks(tic, address, count, bits, values);
+
+    JSValue arr = JS_NewArray(ctx);
+    for(s32 i = 0; i < count; i++)
+        JS_SetPropertyUint32(ctx, arr, i, JS_NewInt32(ctx, values[i]));
+
+    free(values);
+    return arr;
+}
+
+static JSValue js_pokes(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
+{
+    s32 address = getInteger(ctx, argv[0]);
+    s32 bits = getInteger2(ctx, argv[2], BITS_IN_BYTE);
+
+    if(JS_IsArray(ctx, argv[1]))
+    {
+        s32 count = MIN(MAX(getInteger(ctx, JS_GetPropertyStr(ctx, argv[1], "length")), 0), TIC_PEEKS_MAX);
+
+        u8* values = malloc(count);
+        for(s32 i = 0; i < count; i++)
+            values[i] = getInteger(ctx, JS_GetPropertyUint32(ctx, argv[1], i));
+
+        tic_mem* tic = (tic_mem*)getCore(ctx);
+        tic_api_pokes(tic, address, values, count, bits);
+        free(values);
+    }
+
+    return JS_UNDEFINED;
+}
+
 static JSValue js_memcpy(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueConst *argv)
 {
     s32 dest = getInteger(ctx, argv[0]);
@@ -810,7 +865,7 @@ static JSValue js_textri(JSContext *ctx, JSValueConst this_val, s32 argc, JSValu
     tic_mem* tic = (tic_mem*)getCore(ctx);
     bool use_map = JS_ToBool(ctx, argv[12]);
 
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
     if(JS_IsArray(ctx, argv[13]))
     {
@@ -852,7 +907,7 @@ static JSValue js_ttri(JSContext *ctx, JSValueConst this_val, s32 argc, JSValueC
     tic_mem* tic = (tic_mem*)getCore(ctx);
     tic_texture_src src = getInteger(ctx, argv[12]);
 
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
     if(JS_IsArray(ctx, argv[13]))
     {
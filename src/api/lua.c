@@ -192,6 +192,68 @@ static s32 lua_poke4(lua_State* lua)
     return 0;
 }
 
+static s32 lua_peeks(lua_State* lua)
+{
+    s32 top = lua_gettop(lua);
+    tic_mem* tic = (tic_mem*)getLuaCore(lua);
+
+    if(top >= 2)
+    {
+        s32 address = getLuaNumber(lua, 1);
+        s32 count = MIN(MAX(getLuaNumber(lua, 2), 0), TIC_PEEKS_MAX);
+        s32 bits = BITS_IN_BYTE;
+
+        if(top == 3)
+            bits = getLuaNumber(lua, 3);
+
+        u8* values = malloc(count);
+        tic_api_peeks(tic, address, count, bits, values);
+
+        lua_createtable(lua, count, 0);
+        for(s32 i = 0; i < count; i++)
+        {
+            lua_pushinteger(lua, values[i]);
+            lua_rawseti(lua, -2, i + 1);
+        }
+
+        free(values);
+        return 1;
+    }
+    else luaL_error(lua, "invalid parameters, peeks(addr,count,bits)\n");
+
+    return 0;
+}
+
+static s32 lua_pokes(lua_State* lua)
+{
+    s32 top = lua_gettop(lua);
+    tic_mem* tic = (tic_mem*)getLuaCore(lua);
+
+    if(top >= 2 && lua_istable(lua, 2))
+    {
+        s32 address = getLuaNumber(lua, 1);
+        s32 count = (s32)MIN(lua_rawlen(lua, 2), TIC_PEEKS_MAX);
+        s32 bits = BITS_IN_BYTE;
+
+        if(top == 3)
+            bits = getLuaNumber(lua, 3);
+
+        u8* values = malloc(count);
+        for(s32 i = 0; i < count; i++)
+        {
+            lua_rawgeti(lua, 2, i + 1);
+            values[i] = getLuaNumber(lua, -1);
+            lua_pop(lua, 1);
+        }
+
+        tic_api_pokes(tic, address, values, count, bits);
+        free(values);
+    }
+    else luaL_error(lua, "invalid parameters, pokes(addr,values,bits)\n");
+
+    return 0;
+}
+
 static s32 lua_cls(lua_State* lua)
 {
     s32 top = lua_gettop(lua);
@@ -434,7 +496,7 @@ static s32 lua_textri(lua_State* lua)
             pt[i] = (float)lua_tonumber(lua, i + 1);
 
         tic_mem* tic = (tic_mem*)getLuaCore(lua);
-        static u8 colors[TIC_PALETTE_SIZE];
+        u8 colors[TIC_PALETTE_SIZE];
         s32 count = 0;
         bool use_map = false;
 
@@ -498,7 +560,7 @@ static s32 lua_ttri(lua_State* lua)
             pt[i] = (float)lua_tonumber(lua, i + 1);
 
         tic_mem* tic = (tic_mem*)getLuaCore(lua);
-        static u8 colors[TIC_PALETTE_SIZE];
+        u8 colors[TIC_PALETTE_SIZE];
         s32 count = 0;
         tic_texture_src src = tic_tiles_texture;
 
@@ -660,7 +722,7 @@ static s32 lua_spr(lua_State* lua)
     s32 scale = 1;
     tic_flip flip = tic_no_flip;
     tic_rotate rotate = tic_no_rotate;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     if(top >= 1) 
@@ -729,6 +791,24 @@ static s32 lua_spr(lua_State* lua)
     return 0;
 }
 
+static s32 lua_sprs(lua_State* lua)
+{
+    s32 top = lua_gettop(lua);
+
+    if(top == 2)
+    {
+        s32 address = getLuaNumber(lua, 1);
+        s32 count = getLuaNumber(lua, 2);
+
+        tic_mem* tic = (tic_mem*)getLuaCore(lua);
+
+        tic_api_sprs(tic, address, count);
+    }
+    else luaL_error(lua, "invalid params, sprs(addr,count)\n");
+
+    return 0;
+}
+
 static s32 lua_mget(lua_State* lua)
 {
     s32 top = lua_gettop(lua);
@@ -799,7 +879,7 @@ static s32 lua_map(lua_State* lua)
     s32 sx = 0;
     s32 sy = 0;
     s32 scale = 1;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     s32 top = lua_gettop(lua);
@@ -864,7 +944,13 @@ static s32 lua_map(lua_State* lua)
                                 luaL_unref(lua, LUA_REGISTRYINDEX, data.reg);
 
                                 return 0;
-                            }                           
+                            }
+                            else if (lua_isnumber(lua, 9))
+                            {
+                                tic_core_map_table((tic_mem*)getLuaCore(lua), x, y, w, h, sx, sy, colors, count, scale, getLuaNumber(lua, 9));
+
+                                return 0;
+                            }
                         }
                     }
                 }
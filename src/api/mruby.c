@@ -44,10 +44,9 @@ typedef struct {
     struct mrbc_context* mrb_cxt;
 } mrbVm;
 
-static tic_core* CurrentMachine = NULL;
 static inline tic_core* getMRubyMachine(mrb_state* mrb)
 {
-    return CurrentMachine;
+    return mrb->ud;
 }
 
 static mrb_value mrb_peek(mrb_state* mrb, mrb_value self)
@@ -148,6 +147,50 @@ static mrb_value mrb_poke4(mrb_state* mrb, mrb_value self)
     return mrb_nil_value();
 }
 
+static mrb_value mrb_peeks(mrb_state* mrb, mrb_value self)
+{
+    tic_core* machine = getMRubyMachine(mrb);
+    tic_mem* tic = (tic_mem*)machine;
+
+    mrb_int address, count;
+    mrb_int bits = BITS_IN_BYTE;
+    mrb_get_args(mrb, "ii|i", &address, &count, &bits);
+
+    count = MIN(MAX(count, 0), TIC_PEEKS_MAX);
+
+    u8* values = malloc(count);
+    tic_api_peeks(tic, address, count, bits, values);
+
+    mrb_value arr = mrb_ary_new_capa(mrb, count);
+    for(mrb_int i = 0; i < count; i++)
+        mrb_ary_push(mrb, arr, mrb_fixnum_value(values[i]));
+
+    free(values);
+    return arr;
+}
+
+static mrb_value mrb_pokes(mrb_state* mrb, mrb_value self)
+{
+    tic_core* machine = getMRubyMachine(mrb);
+    tic_mem* tic = (tic_mem*)machine;
+
+    mrb_int address;
+    mrb_value arr;
+    mrb_int bits = BITS_IN_BYTE;
+    mrb_get_args(mrb, "iA|i", &address, &arr, &bits);
+
+    mrb_int count = MIN(ARY_LEN(RARRAY(arr)), TIC_PEEKS_MAX);
+
+    u8* values = malloc(count);
+    for(mrb_int i = 0; i < count; i++)
+        values[i] = mrb_integer(mrb_ary_entry(arr, i));
+
+    tic_api_pokes(tic, address, values, count, bits);
+    free(values);
+
+    return mrb_nil_value();
+}
+
 static mrb_value mrb_cls(mrb_state* mrb, mrb_value self)
 {
     mrb_int color = 0;
@@ -418,7 +461,7 @@ static mrb_value mrb_spr(mrb_state* mrb, mrb_value self)
     mrb_int w = 1, h = 1, scale = 1;
     mrb_int flip = tic_no_flip, rotate = tic_no_rotate;
     mrb_value colors_obj;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     mrb_int count = 0;
 
     mrb_int argc = mrb_get_args(mrb, "iii|oiiiii", &index, &x, &y, &colors_obj, &scale, &flip, &rotate, &w, &h);
@@ -447,6 +490,18 @@ static mrb_value mrb_spr(mrb_state* mrb, mrb_value self)
     return mrb_nil_value();
 }
 
+static mrb_value mrb_sprs(mrb_state* mrb, mrb_value self)
+{
+    mrb_int address, count;
+    mrb_get_args(mrb, "ii", &address, &count);
+
+    tic_mem* memory = (tic_mem*)getMRubyMachine(mrb);
+
+    tic_api_sprs(memory, address, count);
+
+    return mrb_nil_value();
+}
+
 static mrb_value mrb_mget(mrb_state* mrb, mrb_value self)
 {
     mrb_int x, y;
@@ -987,7 +1042,7 @@ static void closeMRuby(tic_mem* tic)
         currentVM->mrb = NULL;
 
         free(currentVM);
-        CurrentMachine = machine->currentVM = NULL;
+        machine->currentVM = NULL;
     }
 }
 
@@ -1019,12 +1074,11 @@ static bool initMRuby(tic_mem* tic, const char* code)
 
     closeMRuby(tic);
 
-    CurrentMachine = machine;
-
     machine->currentVM = malloc(sizeof(mrbVm));
     mrbVm *currentVM = (mrbVm*)machine->currentVM;
 
     mrb_state* mrb = currentVM->mrb = mrb_open();
+    mrb->ud = machine;
     mrbc_context* mrb_cxt = currentVM->mrb_cxt = mrbc_context_new(mrb);
     mrb_cxt->capture_errors = 1;
     mrbc_filename(mrb, mrb_cxt, "user code");
@@ -10,6 +10,8 @@ struct CachedNames{
     pkpy_CName _tic_core;
     pkpy_CName len;
     pkpy_CName __getitem__;
+    pkpy_CName list;
+    pkpy_CName append;
     pkpy_CName TIC;
     pkpy_CName BOOT;
     pkpy_CName SCN;
@@ -455,7 +457,7 @@ static int py_map(pkpy_vm* vm)
     int scale;
     bool used_remap;
 
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
 
     pkpy_to_int(vm, 0, &x);
     pkpy_to_int(vm, 1, &y);
@@ -470,8 +472,14 @@ static int py_map(pkpy_vm* vm)
     if(pkpy_check_error(vm)) 
         return 0;
 
+    if (used_remap && pkpy_is_int(vm, 8))
+    {
+        int address;
+        pkpy_to_int(vm, 8, &address);
+        tic_core_map_table(tic, x, y, w, h, sx, sy, colors, color_count, scale, address);
+    }
     //last element on the stack should be the function, so no need to adjust anything
-    if (used_remap) 
+    else if (used_remap) 
         tic_api_map(tic, x, y, w, h, sx, sy, colors, color_count, scale, remap_callback, vm);
     else 
         tic_api_map(tic, x, y, w, h, sx, sy, colors, color_count, scale, NULL, NULL);
@@ -800,6 +808,88 @@ static int py_poke4(pkpy_vm* vm) {
     return 0;
 }
 
+static int py_peeks(pkpy_vm* vm) {
+
+    tic_mem* tic;
+    int address;
+    int count;
+    int bits;
+
+    pkpy_to_int(vm, 0, &address);
+    pkpy_to_int(vm, 1, &count);
+    pkpy_to_int(vm, 2, &bits);
+    get_core(vm, (tic_core**) &tic);
+    if(pkpy_check_error(vm)) 
+        return 0;
+
+    count = MIN(MAX(count, 0), TIC_PEEKS_MAX);
+
+    u8* values = malloc(count);
+    tic_api_peeks(tic, address, count, bits, values);
+
+    pkpy_getglobal(vm, N.list);
+    pkpy_push_null(vm);
+    pkpy_vectorcall(vm, 0);
+
+    for(int i = 0; i < count; i++)
+    {
+        pkpy_dup(vm, -1); //get the list
+        pkpy_get_unbound_method(vm, N.append);
+        pkpy_push_int(vm, values[i]);
+        pkpy_vectorcall(vm, 1);
+        pkpy_pop_top(vm);
+    }
+
+    free(values);
+
+    return 1;
+}
+
+static int py_pokes(pkpy_vm* vm) {
+
+    tic_mem* tic;
+    int address;
+    int bits;
+
+    pkpy_to_int(vm, 0, &address);
+    pkpy_to_int(vm, 2, &bits);
+    get_core(vm, (tic_core**) &tic);
+    if(pkpy_check_error(vm)) 
+        return 0;
+
+    pkpy_getglobal(vm, N.len);
+    pkpy_push_null(vm);
+    pkpy_dup(vm, 1); //get the list
+    pkpy_vectorcall(vm, 1);
+
+    int count = 0;
+    pkpy_to_int(vm, -1, &count);
+    pkpy_pop_top(vm);
+
+    count = MIN(count, TIC_PEEKS_MAX);
+
+    u8* values = malloc(count);
+
+    for(int i = 0; i < count; i++) 
+    {
+        int value;
+        pkpy_dup(vm, 1); //get the list
+        pkpy_get_unbound_method(vm, N.__getitem__);
+        pkpy_push_int(vm, i);
+        pkpy_vectorcall(vm, 1);
+        pkpy_to_int(vm, -1, &value);
+        values[i] = value;
+        pkpy_pop_top(vm);
+    }
+
+    if(!pkpy_check_error(vm))
+        tic_api_pokes(tic, address, values, count, bits);
+
+    free(values);
+
+    return 0;
+}
+
 static int py_print(pkpy_vm* vm) {
     
     tic_mem* tic;
@@ -956,7 +1046,7 @@ static int py_spr(pkpy_vm* vm)
     int w;
     int h;
 
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
 
     pkpy_to_int(vm, 0, &spr_id);
     pkpy_to_int(vm, 1, &x);
@@ -976,6 +1066,23 @@ static int py_spr(pkpy_vm* vm)
     return 0;
 }
 
+static int py_sprs(pkpy_vm* vm) 
+{
+    tic_mem* tic;
+    int address;
+    int count;
+
+    pkpy_to_int(vm, 0, &address);
+    pkpy_to_int(vm, 1, &count);
+    get_core(vm, (tic_core**) &tic);
+    if(pkpy_check_error(vm)) 
+        return 0;
+
+    tic_api_sprs(tic, address, count);
+
+    return 0;
+}
+
 static int py_reset(pkpy_vm* vm) {
     tic_core* core;
     get_core(vm, &core);
@@ -1108,7 +1215,7 @@ static int py_ttri(pkpy_vm* vm)
     double z2;
     double z3;
 
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
 
     pkpy_to_float(vm, 0, &x1);
     pkpy_to_float(vm, 1, &y1);
@@ -1254,6 +1361,12 @@ static bool setup_c_bindings(pkpy_vm* vm) {
     pkpy_push_function(vm, "poke4(addr: int, value: int)", py_poke4);
     pkpy_setglobal_2(vm, "poke4");
 
+    pkpy_push_function(vm, "peeks(addr: int, count: int, bits=8) -> list", py_peeks);
+    pkpy_setglobal_2(vm, "peeks");
+
+    pkpy_push_function(vm, "pokes(addr: int, values: list, bits=8)", py_pokes);
+    pkpy_setglobal_2(vm, "pokes");
+
     pkpy_push_function(vm, "print(text, x=0, y=0, color=15, fixed=False, scale=1, alt=False)", py_print);
     pkpy_setglobal_2(vm, "print");
 
@@ -1271,6 +1384,9 @@ static bool setup_c_bindings(pkpy_vm* vm) {
     pkpy_push_function(vm, "spr(id: int, x: int, y: int, colorkey=-1, scale=1, flip=0, rotate=0, w=1, h=1)", py_spr);
     pkpy_setglobal_2(vm, "spr");
 
+    pkpy_push_function(vm, "sprs(addr: int, count: int)", py_sprs);
+    pkpy_setglobal_2(vm, "sprs");
+
     pkpy_push_function(vm, "sync(mask=0, bank=0, tocart=False)", py_sync);
     pkpy_setglobal_2(vm, "sync");
 
@@ -1326,6 +1442,8 @@ static bool initPython(tic_mem* tic, const char* code)
     N._tic_core = pkpy_name("_tic_core");
     N.len = pkpy_name("len");
     N.__getitem__ = pkpy_name("__getitem__");
+    N.list = pkpy_name("list");
+    N.append = pkpy_name("append");
     N.TIC = pkpy_name("TIC");
     N.BOOT = pkpy_name("BOOT");
     N.SCN = pkpy_name("SCN");
@@ -1569,6 +1687,9 @@ const tic_script_config PythonSyntaxConfig =
 
     .keywords           = PythonKeywords,
     .keywordsCount      = COUNT_OF(PythonKeywords),
+
+    // pocketpy interns names in a process wide table
+    .singleThreaded     = true,
 };
 
 #endif/* defined(TIC_BUILD_WITH_PYTHON) */
@@ -150,7 +150,7 @@ s7_pointer scheme_spr(s7_scheme* sc, s7_pointer args)
     const s32 x         = s7_integer(s7_cadr(args));
     const s32 y         = s7_integer(s7_caddr(args));
 
-    static u8 trans_colors[TIC_PALETTE_SIZE];
+    u8 trans_colors[TIC_PALETTE_SIZE];
     u8 trans_count = 0;
     if (argn > 3)
     {
@@ -166,6 +166,15 @@ s7_pointer scheme_spr(s7_scheme* sc, s7_pointer args)
     tic_api_spr(tic, id, x, y, w, h, trans_colors, trans_count, scale, (tic_flip)flip, (tic_rotate) rotate);
     return s7_nil(sc);
 }
+s7_pointer scheme_sprs(s7_scheme* sc, s7_pointer args)
+{
+    // sprs(addr count)
+    tic_mem* tic = (tic_mem*)getSchemeCore(sc);
+    const s32 addr  = s7_integer(s7_car(args));
+    const s32 count = s7_integer(s7_cadr(args));
+    tic_api_sprs(tic, addr, count);
+    return s7_nil(sc);
+}
 s7_pointer scheme_btn(s7_scheme* sc, s7_pointer args)
 {
     // btn(id) -> pressed
@@ -316,7 +325,7 @@ s7_pointer scheme_map(s7_scheme* sc, s7_pointer args)
 
     const int argn = s7_list_length(sc, args);
 
-    static u8 trans_colors[TIC_PALETTE_SIZE];
+    u8 trans_colors[TIC_PALETTE_SIZE];
     u8 trans_count = 0;
     if (argn > 6) {
         s7_pointer colorkey = s7_list_ref(sc, args, 6);
@@ -325,6 +334,12 @@ s7_pointer scheme_map(s7_scheme* sc, s7_pointer args)
 
     const s32 scale = argn > 7 ? s7_integer(s7_list_ref(sc, args, 7)) : 1;
 
+    if (argn > 8 && s7_is_integer(s7_list_ref(sc, args, 8)))
+    {
+        tic_core_map_table(tic, x, y, w, h, sx, sy, trans_colors, trans_count, scale, s7_integer(s7_list_ref(sc, args, 8)));
+        return s7_nil(sc);
+    }
+
     RemapFunc remap = NULL;
     RemapData data;
     if (argn > 8)
@@ -422,6 +437,51 @@ s7_pointer scheme_poke4(s7_scheme* sc, s7_pointer args)
     tic_api_poke4(tic, addr, value);
     return s7_nil(sc);
 }
+s7_pointer scheme_peeks(s7_scheme* sc, s7_pointer args)
+{
+    // peeks(addr count bits=8)
+    tic_mem* tic = (tic_mem*)getSchemeCore(sc);
+    const int argn = s7_list_length(sc, args);
+    const s32 addr = s7_integer(s7_car(args));
+    const s32 count = MIN(MAX(s7_integer(s7_cadr(args)), 0), TIC_PEEKS_MAX);
+    const s32 bits = argn > 2 ? s7_integer(s7_caddr(args)) : BITS_IN_BYTE;
+
+    u8* values = malloc(count);
+    tic_api_peeks(tic, addr, count, bits, values);
+
+    s7_pointer result = s7_nil(sc);
+    for (s32 i = count - 1; i >= 0; --i)
+        result = s7_cons(sc, s7_make_integer(sc, values[i]), result);
+
+    free(values);
+    return result;
+}
+s7_pointer scheme_pokes(s7_scheme* sc, s7_pointer args)
+{
+    // pokes(addr values bits=8)
+    tic_mem* tic = (tic_mem*)getSchemeCore(sc);
+    const int argn = s7_list_length(sc, args);
+    const s32 addr = s7_integer(s7_car(args));
+    s7_pointer list = s7_cadr(args);
+    const s32 bits = argn > 2 ? s7_integer(s7_caddr(args)) : BITS_IN_BYTE;
+
+    if (!s7_is_list(sc, list))
+        return s7_nil(sc);
+
+    const s32 count = MIN(s7_list_length(sc, list), TIC_PEEKS_MAX);
+
+    u8* values = malloc(count);
+    for (s32 i = 0; i < count; ++i, list = s7_cdr(list))
+    {
+        s7_pointer value = s7_car(list);
+        values[i] = s7_is_integer(value) ? s7_integer(value) : 0;
+    }
+
+    tic_api_pokes(tic, addr, values, count, bits);
+    free(values);
+
+    return s7_nil(sc);
+}
 s7_pointer scheme_memcpy(s7_scheme* sc, s7_pointer args)
 {
     // memcpy(dest source size)
@@ -495,7 +555,7 @@ s7_pointer scheme_font(s7_scheme* sc, s7_pointer args)
     const s32 x = s7_integer(s7_cadr(args));
     const s32 y = s7_integer(s7_caddr(args));
 
-    static u8 trans_colors[TIC_PALETTE_SIZE];
+    u8 trans_colors[TIC_PALETTE_SIZE];
     u8 trans_count = 0;
     s7_pointer colorkey = s7_cadddr(args);
     parseTransparentColorsArg(sc, colorkey, trans_colors, &trans_count);
@@ -620,7 +680,7 @@ s7_pointer scheme_ttri(s7_scheme* sc, s7_pointer args)
     const int argn = s7_list_length(sc, args);
     const tic_texture_src texsrc = (tic_texture_src)(argn > 12 ? s7_integer(s7_list_ref(sc, args, 12)) : 0);
     
-    static u8 trans_colors[TIC_PALETTE_SIZE];
+    u8 trans_colors[TIC_PALETTE_SIZE];
     u8 trans_count = 0;
 
     if (argn > 13)
@@ -241,6 +241,59 @@ static SQInteger squirrel_poke4(HSQUIRRELVM vm)
     return 0;
 }
 
+static SQInteger squirrel_peeks(HSQUIRRELVM vm)
+{
+    tic_mem* tic = (tic_mem*)getSquirrelCore(vm);
+    SQInteger top = sq_gettop(vm);
+
+    if (top < 3)
+        return sq_throwerror( vm, "invalid parameters, peeks(address,count,bits)" );
+
+    s32 address = getSquirrelNumber(vm, 2);
+    s32 count = MIN(MAX(getSquirrelNumber(vm, 3), 0), TIC_PEEKS_MAX);
+    s32 bits = top >= 4 ? getSquirrelNumber(vm, 4) : BITS_IN_BYTE;
+
+    u8* values = malloc(count);
+    tic_api_peeks(tic, address, count, bits, values);
+
+    sq_newarray(vm, 0);
+    for(s32 i = 0; i < count; i++)
+    {
+        sq_pushinteger(vm, values[i]);
+        sq_arrayappend(vm, -2);
+    }
+
+    free(values);
+    return 1;
+}
+
+static SQInteger squirrel_pokes(HSQUIRRELVM vm)
+{
+    tic_mem* tic = (tic_mem*)getSquirrelCore(vm);
+    SQInteger top = sq_gettop(vm);
+
+    if (top < 3 || sq_gettype(vm, 3) != OT_ARRAY)
+        return sq_throwerror( vm, "invalid parameters, pokes(address,values,bits)" );
+
+    s32 address = getSquirrelNumber(vm, 2);
+    s32 count = (s32)MIN(sq_getsize(vm, 3), TIC_PEEKS_MAX);
+    s32 bits = top >= 4 ? getSquirrelNumber(vm, 4) : BITS_IN_BYTE;
+
+    u8* values = malloc(count);
+    for(s32 i = 0; i < count; i++)
+    {
+        sq_pushinteger(vm, (SQInteger)i);
+        sq_rawget(vm, 3);
+        values[i] = getSquirrelNumber(vm, -1);
+        sq_poptop(vm);
+    }
+
+    tic_api_pokes(tic, address, values, count, bits);
+    free(values);
+
+    return 0;
+}
+
 static SQInteger squirrel_cls(HSQUIRRELVM vm)
 {
     SQInteger top = sq_gettop(vm);
@@ -481,7 +534,7 @@ static SQInteger squirrel_ttri(HSQUIRRELVM vm)
             pt[i] = getSquirrelFloat(vm, i + 2);
 
         tic_mem* tic = (tic_mem*)getSquirrelCore(vm);
-        static u8 colors[TIC_PALETTE_SIZE];
+        u8 colors[TIC_PALETTE_SIZE];
         s32 count = 0;
         tic_texture_src src = tic_tiles_texture;
 
@@ -637,7 +690,7 @@ static SQInteger squirrel_spr(HSQUIRRELVM vm)
     s32 scale = 1;
     tic_flip flip = tic_no_flip;
     tic_rotate rotate = tic_no_rotate;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     if(top >= 2) 
@@ -707,6 +760,24 @@ static SQInteger squirrel_spr(HSQUIRRELVM vm)
     return 0;
 }
 
+static SQInteger squirrel_sprs(HSQUIRRELVM vm)
+{
+    SQInteger top = sq_gettop(vm);
+
+    if(top == 3)
+    {
+        s32 address = getSquirrelNumber(vm, 2);
+        s32 count = getSquirrelNumber(vm, 3);
+
+        tic_mem* tic = (tic_mem*)getSquirrelCore(vm);
+
+        tic_api_sprs(tic, address, count);
+    }
+    else return sq_throwerror(vm, "invalid params, sprs(addr,count)\n");
+
+    return 0;
+}
+
 static SQInteger squirrel_mget(HSQUIRRELVM vm)
 {
     SQInteger top = sq_gettop(vm);
@@ -800,7 +871,7 @@ static SQInteger squirrel_map(HSQUIRRELVM vm)
     s32 sx = 0;
     s32 sy = 0;
     s32 scale = 1;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     SQInteger top = sq_gettop(vm);
@@ -869,7 +940,13 @@ static SQInteger squirrel_map(HSQUIRRELVM vm)
                                 sq_release(vm, &data.reg);
 
                                 return 0;
-                            }                           
+                            }
+                            else if (type & (OT_INTEGER|OT_FLOAT))
+                            {
+                                tic_core_map_table((tic_mem*)getSquirrelCore(vm), x, y, w, h, sx, sy, colors, count, scale, getSquirrelNumber(vm, 10));
+
+                                return 0;
+                            }
                         }
                     }
                 }
@@ -48,11 +48,17 @@ typedef float           f32;
 
 static const char TicCore[] = "_TIC80";
 
-IM3Function BDR_function;
-IM3Function SCN_function;
-IM3Function TIC_function;
-IM3Function BOOT_function;
-IM3Function MENU_function;
+// the runtime and its exported callbacks, kept per instance
+typedef struct
+{
+    IM3Runtime runtime;
+
+    IM3Function BDR_function;
+    IM3Function SCN_function;
+    IM3Function TIC_function;
+    IM3Function BOOT_function;
+    IM3Function MENU_function;
+} WasmVM;
 
 #define FATAL(msg, ...) { printf("Error: [Fatal] " msg "\n", ##__VA_ARGS__); goto _onfatal; }
 #define WASM_STACK_SIZE 64*1024
@@ -644,6 +650,18 @@ m3ApiRawFunction(wasmtic_spr)
     m3ApiSuccess();
 }
 
+m3ApiRawFunction(wasmtic_sprs)
+{
+    m3ApiGetArg      (int32_t, address)
+    m3ApiGetArg      (int32_t, count)
+
+    tic_mem* tic = (tic_mem*)getWasmCore(runtime);
+
+    tic_api_sprs(tic, address, count);
+
+    m3ApiSuccess();
+}
+
 m3ApiRawFunction(wasmtic_clip)
 {
     m3ApiGetArg      (int32_t, x)
@@ -677,7 +695,7 @@ m3ApiRawFunction(wasmtic_map)
     if (trans_colors == NULL) {
         colorCount = 0;
     }    m3ApiGetArg      (int8_t, scale)
-    // TODO: actually test that this works
+    // ram address of a remap table, 0 for none
     m3ApiGetArg      (int32_t, remap)
 
     // defaults
@@ -689,7 +707,7 @@ m3ApiRawFunction(wasmtic_map)
 
     tic_mem* tic = (tic_mem*)getWasmCore(runtime);
 
-    tic_api_map(tic, x, y, w, h, sx, sy, trans_colors, colorCount, scale, NULL, NULL);
+    tic_core_map_table(tic, x, y, w, h, sx, sy, trans_colors, colorCount, scale, remap);
 
     m3ApiSuccess();
 }
@@ -997,6 +1015,7 @@ M3Result linkTicAPI(IM3Module module)
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "rectb",   "v(iiiii)",      &wasmtic_rectb)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "sfx",     "v(iiiiiiii)",   &wasmtic_sfx)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "spr",     "v(iiiiiiiiii)", &wasmtic_spr)));
+    _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "sprs",    "v(ii)",         &wasmtic_sprs)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "sync",    "v(iii)",        &wasmtic_sync)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "time",    "f()",           &wasmtic_time)));
     _   (SuppressLookupFailure (m3_LinkRawFunction (module, "env", "tstamp",  "i()",           &wasmtic_tstamp)));
@@ -1032,6 +1051,8 @@ static void closeWasm(tic_mem* tic)
 
     if(core->currentVM)
     {
+        WasmVM* vm = core->currentVM;
+
         // this is necessary because when TIC-80 calls tic_reset_api, we
         // may not even have a VM.  Because the [non WASM] VM isn't
         // initialized yet when loading a new cartridge the "init" steps
@@ -1045,9 +1066,10 @@ static void closeWasm(tic_mem* tic)
         // less if one assumes (like before) that all the VMs share a
         // common memory area.
         u8* low_ram =  (u8*)core->memory.base_ram;
-        u8* wasm_ram = m3_GetMemory(core->currentVM, NULL, 0);
+        u8* wasm_ram = m3_GetMemory(vm->runtime, NULL, 0);
         memcpy(low_ram, wasm_ram, TIC_RAM_SIZE);
-        deinitWasmRuntime(core->currentVM);
+        deinitWasmRuntime(vm->runtime);
+        free(vm);
         core->currentVM = NULL;
         core->memory.ram = NULL;
     }
@@ -1092,7 +1114,8 @@ static bool initWasm(tic_mem* tic, const char* code)
     memcpy(wasm_ram, low_ram, TIC_RAM_SIZE);
     core->memory.ram = (tic_ram*)wasm_ram;
 
-    core->currentVM = runtime;
+    WasmVM* vm = core->currentVM = calloc(1, sizeof(WasmVM));
+    vm->runtime = runtime;
 
     // TODO: if compiling from WAT is an option where should this
     // code go?
@@ -1134,11 +1157,11 @@ static bool initWasm(tic_mem* tic, const char* code)
         return false;
     }
 
-    m3_FindFunction (&BDR_function, runtime, BDR_FN);
-    m3_FindFunction (&SCN_function, runtime, SCN_FN);
-    m3_FindFunction (&BOOT_function, runtime, BOOT_FN);
-    m3_FindFunction (&MENU_function, runtime, MENU_FN);
-    result = m3_FindFunction (&TIC_function, runtime, TIC_FN);
+    m3_FindFunction (&vm->BDR_function, runtime, BDR_FN);
+    m3_FindFunction (&vm->SCN_function, runtime, SCN_FN);
+    m3_FindFunction (&vm->BOOT_function, runtime, BOOT_FN);
+    m3_FindFunction (&vm->MENU_function, runtime, MENU_FN);
+    result = m3_FindFunction (&vm->TIC_function, runtime, TIC_FN);
 
     if (result)
     {
@@ -1155,27 +1178,30 @@ static void callWasmTick(tic_mem* tic)
 
     tic_core* core = (tic_core*)tic;
 
-    IM3Runtime runtime = core->currentVM;
+    WasmVM* vm = core->currentVM;
 
-    if(!runtime) { return; }
+    if(!vm) { return; }
 
-    M3Result res = m3_CallV(TIC_function);
+    M3Result res = m3_CallV(vm->TIC_function);
     if(res)
     {
         core->data->error(core->data->data, res);
     }
+
+    // the cart writes its RAM directly, bypassing the dirty rows
+    tic_core_invalidate(tic);
 }
 
 static void callWasmBoot(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
 
-    IM3Runtime runtime = core->currentVM;
+    WasmVM* vm = core->currentVM;
 
-    if(!runtime) { return; }
-    if (BOOT_function == NULL) { return; }
+    if(!vm) { return; }
+    if (vm->BOOT_function == NULL) { return; }
 
-    M3Result res = m3_CallV(BOOT_function);
+    M3Result res = m3_CallV(vm->BOOT_function);
     if(res)
     {
         core->data->error(core->data->data, res);
@@ -1186,9 +1212,6 @@ static void callWasmIntFunc(tic_mem* tic, IM3Function func, s32 value, void* dat
 {
     tic_core* core = (tic_core*)tic;
 
-    IM3Runtime runtime = core->currentVM;
-
-    if(!runtime) { return; }
     if (func == NULL) { return; }
 
     M3Result res = m3_CallV(func, value);
@@ -1196,21 +1219,32 @@ static void callWasmIntFunc(tic_mem* tic, IM3Function func, s32 value, void* dat
     {
         core->data->error(core->data->data, res);
     }
+
+    tic_core_invalidate(tic);
 }
 
 static void callWasmScanline(tic_mem* tic, s32 row, void* data)
 {
-    callWasmIntFunc(tic, SCN_function, row, data);
+    WasmVM* vm = ((tic_core*)tic)->currentVM;
+
+    if(vm)
+        callWasmIntFunc(tic, vm->SCN_function, row, data);
 }
 
 static void callWasmBorder(tic_mem* tic, s32 row, void* data)
 {
-    callWasmIntFunc(tic, BDR_function, row, data);
+    WasmVM* vm = ((tic_core*)tic)->currentVM;
+
+    if(vm)
+        callWasmIntFunc(tic, vm->BDR_function, row, data);
 }
 
 static void callWasmMenu(tic_mem* tic, s32 index, void* data)
 {
-    callWasmIntFunc(tic, MENU_function, index, data);
+    WasmVM* vm = ((tic_core*)tic)->currentVM;
+
+    if(vm)
+        callWasmIntFunc(tic, vm->MENU_function, index, data);
 }
 
 static inline bool isalnum_(char c) {return isalnum(c) || c == '_';}
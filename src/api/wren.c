@@ -32,16 +32,21 @@
 #include "tools.h"
 #include "wren.h"
 
-static WrenHandle* game_class       = NULL;
-static WrenHandle* new_handle       = NULL;
-static WrenHandle* update_handle    = NULL;
-static WrenHandle* boot_handle    = NULL;
-static WrenHandle* scanline_handle  = NULL;
-static WrenHandle* border_handle    = NULL;
-static WrenHandle* menu_handle  = NULL;
-static WrenHandle* overline_handle  = NULL;
-
-static bool loaded = false;
+// the vm user data, every instance keeps its own game object and call handles
+typedef struct
+{
+    tic_core* core;
+    bool loaded;
+
+    WrenHandle* game_class;
+    WrenHandle* new_handle;
+    WrenHandle* update_handle;
+    WrenHandle* boot_handle;
+    WrenHandle* scanline_handle;
+    WrenHandle* border_handle;
+    WrenHandle* menu_handle;
+    WrenHandle* overline_handle;
+} WrenState;
 
 static char const* tic_wren_api = "\n\
 class TIC {\n\
@@ -66,6 +71,7 @@ class TIC {\n\
     foreign static spr(id, x, y, alpha_color, scale, flip)\n\
     foreign static spr(id, x, y, alpha_color, scale, flip, rotate)\n\
     foreign static spr(id, x, y, alpha_color, scale, flip, rotate, cell_width, cell_height)\n\
+    foreign static sprs(addr, count)\n\
     foreign static map(cell_x, cell_y)\n\
     foreign static map(cell_x, cell_y, cell_w, cell_h)\n\
     foreign static map(cell_x, cell_y, cell_w, cell_h, x, y)\n\
@@ -113,6 +119,10 @@ class TIC {\n\
     foreign static poke2(addr, val)\n\
     foreign static peek4(addr)\n\
     foreign static poke4(addr, val)\n\
+    foreign static peeks(addr, count)\n\
+    foreign static peeks(addr, count, bits)\n\
+    foreign static pokes(addr, values)\n\
+    foreign static pokes(addr, values, bits)\n\
     foreign static memcpy(dst, src, size)\n\
     foreign static memset(dst, src, size)\n\
     foreign static pmem(index)\n\
@@ -226,39 +236,46 @@ static inline bool isList(WrenVM* vm, s32 index)
     return wrenGetSlotType(vm, index) == WREN_TYPE_LIST;
 }
 
+static WrenState* getWrenState(tic_core* core)
+{
+    return core->currentVM ? wrenGetUserData(core->currentVM) : NULL;
+}
+
 static void closeWren(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
     if(core->currentVM)
     {
+        WrenState* state = getWrenState(core);
+
         // release handles
-        if (loaded)
+        if (state->loaded)
         {
-            wrenReleaseHandle(core->currentVM, new_handle);
-            wrenReleaseHandle(core->currentVM, update_handle);
-            wrenReleaseHandle(core->currentVM, boot_handle);
-            wrenReleaseHandle(core->currentVM, scanline_handle);
-            wrenReleaseHandle(core->currentVM, border_handle);
-            wrenReleaseHandle(core->currentVM, menu_handle);
-            wrenReleaseHandle(core->currentVM, overline_handle);
-            if (game_class != NULL)
+            wrenReleaseHandle(core->currentVM, state->new_handle);
+            wrenReleaseHandle(core->currentVM, state->update_handle);
+            wrenReleaseHandle(core->currentVM, state->boot_handle);
+            wrenReleaseHandle(core->currentVM, state->scanline_handle);
+            wrenReleaseHandle(core->currentVM, state->border_handle);
+            wrenReleaseHandle(core->currentVM, state->menu_handle);
+            wrenReleaseHandle(core->currentVM, state->overline_handle);
+            if (state->game_class != NULL)
             {
-                wrenReleaseHandle(core->currentVM, game_class);
+                wrenReleaseHandle(core->currentVM, state->game_class);
             }
         }
 
         wrenFreeVM(core->currentVM);
         core->currentVM = NULL;
 
+        free(state);
     }
-    loaded = false;
 }
 
 static tic_core* getWrenCore(WrenVM* vm)
 {
-    tic_core* core = wrenGetUserData(vm);
+    WrenState* state = wrenGetUserData(vm);
 
-    return core;
+    return state->core;
 }
 
 static void wren_map_width(WrenVM* vm)
@@ -544,7 +561,7 @@ static void wren_spr(WrenVM* vm)
     s32 scale = 1;
     tic_flip flip = tic_no_flip;
     tic_rotate rotate = tic_no_rotate;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     if(top > 1)
@@ -619,7 +636,7 @@ static void wren_spr_internal(WrenVM* vm)
     s32 x = getWrenNumber(vm, 2);
     s32 y = getWrenNumber(vm, 3);
 
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     if(isList(vm, 4))
@@ -655,6 +672,16 @@ static void wren_spr_internal(WrenVM* vm)
     tic_api_spr(tic, index, x, y, 1, 1, colors, count, scale, flip, rotate);
 }
 
+static void wren_sprs(WrenVM* vm)
+{
+    s32 address = getWrenNumber(vm, 1);
+    s32 count = getWrenNumber(vm, 2);
+
+    tic_mem* tic = (tic_mem*)getWrenCore(vm);
+
+    tic_api_sprs(tic, address, count);
+}
+
 static void wren_map(WrenVM* vm)
 {
     s32 x = 0;
@@ -664,7 +691,7 @@ static void wren_map(WrenVM* vm)
     s32 sx = 0;
     s32 sy = 0;
     s32 scale = 1;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
 
     s32 top = wrenGetSlotCount(vm);
@@ -779,7 +806,7 @@ static void wren_ttri(WrenVM* vm)
     }
 
     tic_mem* tic = (tic_mem*)getWrenCore(vm);
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
     tic_texture_src src = tic_tiles_texture;
 
@@ -841,7 +868,7 @@ static void wren_textri(WrenVM* vm)
 
     tic_core* core = getWrenCore(vm);
     tic_mem* tic = (tic_mem*)core;
-    static u8 colors[TIC_PALETTE_SIZE];
+    u8 colors[TIC_PALETTE_SIZE];
     s32 count = 0;
     tic_texture_src src = tic_tiles_texture;
 
@@ -1143,6 +1170,69 @@ static void wren_poke4(WrenVM* vm)
     tic_api_poke4(tic, address, value);
 }
 
+static void wren_peeks(WrenVM* vm)
+{
+    tic_mem* tic = (tic_mem*)getWrenCore(vm);
+
+    s32 top = wrenGetSlotCount(vm);
+
+    s32 address = getWrenNumber(vm, 1);
+    s32 count = getWrenNumber(vm, 2);
+    s32 bits = BITS_IN_BYTE;
+
+    if(top > 3)
+        bits = getWrenNumber(vm, 3);
+
+    count = MIN(MAX(count, 0), TIC_PEEKS_MAX);
+
+    u8* values = malloc(count);
+    tic_api_peeks(tic, address, count, bits, values);
+
+    wrenEnsureSlots(vm, top+1);
+    wrenSetSlotNewList(vm, 0);
+
+    for(s32 i = 0; i < count; i++)
+    {
+        wrenSetSlotDouble(vm, top, values[i]);
+        wrenInsertInList(vm, 0, i, top);
+    }
+
+    free(values);
+}
+
+static void wren_pokes(WrenVM* vm)
+{
+    tic_mem* tic = (tic_mem*)getWrenCore(vm);
+
+    s32 top = wrenGetSlotCount(vm);
+
+    s32 address = getWrenNumber(vm, 1);
+    s32 bits = BITS_IN_BYTE;
+
+    if(top > 3)
+        bits = getWrenNumber(vm, 3);
+
+    if(!isList(vm, 2))
+    {
+        wrenError(vm, "values must be a list of numbers\n");
+        return;
+    }
+
+    s32 count = MIN(wrenGetListCount(vm, 2), TIC_PEEKS_MAX);
+    u8* values = malloc(count);
+
+    wrenEnsureSlots(vm, top+1);
+    for(s32 i = 0; i < count; i++)
+    {
+        wrenGetListElement(vm, 2, i, top);
+        values[i] = isNumber(vm, top) ? getWrenNumber(vm, top) : 0;
+    }
+
+    tic_api_pokes(tic, address, values, count, bits);
+
+    free(values);
+}
+
 static void wren_memcpy(WrenVM* vm)
 {
     s32 dest = getWrenNumber(vm, 1);
@@ -1467,6 +1557,7 @@ static WrenForeignMethodFn foreignTicMethods(const char* signature)
     if (strcmp(signature, "static TIC.spr(_,_,_,_,_,_)"         ) == 0) return wren_spr;
     if (strcmp(signature, "static TIC.spr(_,_,_,_,_,_,_)"       ) == 0) return wren_spr;
     if (strcmp(signature, "static TIC.spr(_,_,_,_,_,_,_,_,_)"   ) == 0) return wren_spr;
+    if (strcmp(signature, "static TIC.sprs(_,_)"                ) == 0) return wren_sprs;
 
     if (strcmp(signature, "static TIC.map(_,_)"                 ) == 0) return wren_map;
     if (strcmp(signature, "static TIC.map(_,_,_,_)"             ) == 0) return wren_map;
@@ -1515,6 +1606,10 @@ static WrenForeignMethodFn foreignTicMethods(const char* signature)
     if (strcmp(signature, "static TIC.poke2(_,_)"               ) == 0) return wren_poke2;
     if (strcmp(signature, "static TIC.peek4(_)"                 ) == 0) return wren_peek4;
     if (strcmp(signature, "static TIC.poke4(_,_)"               ) == 0) return wren_poke4;
+    if (strcmp(signature, "static TIC.peeks(_,_)"               ) == 0) return wren_peeks;
+    if (strcmp(signature, "static TIC.peeks(_,_,_)"             ) == 0) return wren_peeks;
+    if (strcmp(signature, "static TIC.pokes(_,_)"               ) == 0) return wren_pokes;
+    if (strcmp(signature, "static TIC.pokes(_,_,_)"             ) == 0) return wren_pokes;
     if (strcmp(signature, "static TIC.memcpy(_,_,_)"            ) == 0) return wren_memcpy;
     if (strcmp(signature, "static TIC.memset(_,_,_)"            ) == 0) return wren_memset;
     if (strcmp(signature, "static TIC.pmem(_)"                  ) == 0) return wren_pmem;
@@ -1583,7 +1678,9 @@ static WrenForeignMethodFn bindForeignMethod(
 
 static void initAPI(tic_core* core)
 {
-    wrenSetUserData(core->currentVM, core);
+    WrenState* state = calloc(1, sizeof(WrenState));
+    state->core = core;
+    wrenSetUserData(core->currentVM, state);
 
     if (wrenInterpret(core->currentVM, "main", tic_wren_api) != WREN_RESULT_SUCCESS)
     {
@@ -1636,35 +1733,36 @@ static bool initWren(tic_mem* tic, const char* code)
         return false;
     }
 
-    loaded = true;
+    WrenState* state = getWrenState(core);
+    state->loaded = true;
 
     // make handles
     wrenEnsureSlots(vm, 1);
     wrenGetVariable(vm, "main", "Game", 0);
-    game_class = wrenGetSlotHandle(vm, 0); // handle from game class
+    state->game_class = wrenGetSlotHandle(vm, 0); // handle from game class
 
-    new_handle = wrenMakeCallHandle(vm, "new()");
-    update_handle = wrenMakeCallHandle(vm, TIC_FN "()");
-    boot_handle = wrenMakeCallHandle(vm, BOOT_FN "()");
-    scanline_handle = wrenMakeCallHandle(vm, SCN_FN "(_)");
-    border_handle = wrenMakeCallHandle(vm, BDR_FN "(_)");
-    menu_handle = wrenMakeCallHandle(vm, MENU_FN "(_)");
-    overline_handle = wrenMakeCallHandle(vm, OVR_FN "()");
+    state->new_handle = wrenMakeCallHandle(vm, "new()");
+    state->update_handle = wrenMakeCallHandle(vm, TIC_FN "()");
+    state->boot_handle = wrenMakeCallHandle(vm, BOOT_FN "()");
+    state->scanline_handle = wrenMakeCallHandle(vm, SCN_FN "(_)");
+    state->border_handle = wrenMakeCallHandle(vm, BDR_FN "(_)");
+    state->menu_handle = wrenMakeCallHandle(vm, MENU_FN "(_)");
+    state->overline_handle = wrenMakeCallHandle(vm, OVR_FN "()");
 
     // create game class
-    if (game_class)
+    if (state->game_class)
     {
         wrenEnsureSlots(vm, 1);
-        wrenSetSlotHandle(vm, 0, game_class);
-        wrenCall(vm, new_handle);
-        wrenReleaseHandle(core->currentVM, game_class); // release game class handle
-        game_class = NULL;
+        wrenSetSlotHandle(vm, 0, state->game_class);
+        wrenCall(vm, state->new_handle);
+        wrenReleaseHandle(core->currentVM, state->game_class); // release game class handle
+        state->game_class = NULL;
         if (wrenGetSlotCount(vm) == 0)
         {
             core->data->error(core->data->data, "Error in game class :(");
             return false;
         }
-        game_class = wrenGetSlotHandle(vm, 0); // handle from game object
+        state->game_class = wrenGetSlotHandle(vm, 0); // handle from game object
     } else {
         core->data->error(core->data->data, "'Game class' isn't found :(");
         return false;
@@ -1677,22 +1775,23 @@ static void callWrenTick(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
     WrenVM* vm = core->currentVM;
+    WrenState* state = getWrenState(core);
 
-    if(vm && game_class)
+    if(vm && state->game_class)
     {
         wrenEnsureSlots(vm, 1);
-        wrenSetSlotHandle(vm, 0, game_class);
-        wrenCall(vm, update_handle);
+        wrenSetSlotHandle(vm, 0, state->game_class);
+        wrenCall(vm, state->update_handle);
 
 #if defined(BUILD_DEPRECATED)
         // call OVR() callback for backward compatibility
-        if(overline_handle)
+        if(state->overline_handle)
         {
             OVR(core)
             {
                 wrenEnsureSlots(vm, 1);
-                wrenSetSlotHandle(vm, 0, game_class);
-                wrenCall(vm, overline_handle);
+                wrenSetSlotHandle(vm, 0, state->game_class);
+                wrenCall(vm, state->overline_handle);
             }
         }
 #endif
@@ -1703,12 +1802,13 @@ static void callWrenBoot(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
     WrenVM* vm = core->currentVM;
+    WrenState* state = getWrenState(core);
 
-    if(vm && game_class)
+    if(vm && state->game_class)
     {
         wrenEnsureSlots(vm, 1);
-        wrenSetSlotHandle(vm, 0, game_class);
-        wrenCall(vm, boot_handle);
+        wrenSetSlotHandle(vm, 0, state->game_class);
+        wrenCall(vm, state->boot_handle);
     }
 }
 
@@ -1716,11 +1816,12 @@ static void callWrenIntCallback(tic_mem* tic, s32 value, WrenHandle* handle, voi
 {
     tic_core* core = (tic_core*)tic;
     WrenVM* vm = core->currentVM;
+    WrenState* state = getWrenState(core);
 
-    if(vm && game_class)
+    if(vm && state->game_class && handle)
     {
         wrenEnsureSlots(vm, 2);
-        wrenSetSlotHandle(vm, 0, game_class);
+        wrenSetSlotHandle(vm, 0, state->game_class);
         wrenSetSlotDouble(vm, 1, value);
         wrenCall(vm, handle);
     }
@@ -1728,17 +1829,26 @@ static void callWrenIntCallback(tic_mem* tic, s32 value, WrenHandle* handle, voi
 
 static void callWrenScanline(tic_mem* tic, s32 row, void* data)
 {
-    callWrenIntCallback(tic, row, scanline_handle, data);
+    WrenState* state = getWrenState((tic_core*)tic);
+
+    if(state)
+        callWrenIntCallback(tic, row, state->scanline_handle, data);
 }
 
 static void callWrenBorder(tic_mem* tic, s32 row, void* data)
 {
-    callWrenIntCallback(tic, row, border_handle, data);
+    WrenState* state = getWrenState((tic_core*)tic);
+
+    if(state)
+        callWrenIntCallback(tic, row, state->border_handle, data);
 }
 
 static void callWrenMenu(tic_mem* tic, s32 index, void* data)
 {
-    callWrenIntCallback(tic, index, menu_handle, data);
+    WrenState* state = getWrenState((tic_core*)tic);
+
+    if(state)
+        callWrenIntCallback(tic, index, state->menu_handle, data);
 }
 
 static const char* const WrenKeywords [] =
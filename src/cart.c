@@ -76,6 +76,10 @@ static_assert(sizeof(Chunk) == 4, "tic_chunk_size");
 static const u8 Sweetie16[] = {0x1a, 0x1c, 0x2c, 0x5d, 0x27, 0x5d, 0xb1, 0x3e, 0x53, 0xef, 0x7d, 0x57, 0xff, 0xcd, 0x75, 0xa7, 0xf0, 0x70, 0x38, 0xb7, 0x64, 0x25, 0x71, 0x79, 0x29, 0x36, 0x6f, 0x3b, 0x5d, 0xc9, 0x41, 0xa6, 0xf6, 0x73, 0xef, 0xf7, 0xf4, 0xf4, 0xf4, 0x94, 0xb0, 0xc2, 0x56, 0x6c, 0x86, 0x33, 0x3c, 0x57};
 static const u8 Waveforms[] = {0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe, 0xef, 0xcd, 0xab, 0x89, 0x67, 0x45, 0x23, 0x01, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe, 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe};
 
+#if defined(BUILD_DEPRECATED)
+static const u8 DB16[] = {0x14, 0x0c, 0x1c, 0x44, 0x24, 0x34, 0x30, 0x34, 0x6d, 0x4e, 0x4a, 0x4e, 0x85, 0x4c, 0x30, 0x34, 0x65, 0x24, 0xd0, 0x46, 0x48, 0x75, 0x71, 0x61, 0x59, 0x7d, 0xce, 0xd2, 0x7d, 0x2c, 0x85, 0x95, 0xa1, 0x6d, 0xaa, 0x2c, 0xd2, 0xaa, 0x99, 0x6d, 0xc2, 0xca, 0xda, 0xd4, 0x5e, 0xde, 0xee, 0xd6};
+#endif
+
 static s32 chunkSize(const Chunk* chunk)
 {
     return chunk->size == 0 && (chunk->type == CHUNK_CODE || chunk->type == CHUNK_BINARY) ? TIC_BANK_SIZE : retro_le_to_cpu16(chunk->size);
@@ -144,7 +148,6 @@ void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
         // load DB16 palette if it not exists
         if (EMPTY(cart->bank0.palette.vbank0.data))
         {
-            static const u8 DB16[] = { 0x14, 0x0c, 0x1c, 0x44, 0x24, 0x34, 0x30, 0x34, 0x6d, 0x4e, 0x4a, 0x4e, 0x85, 0x4c, 0x30, 0x34, 0x65, 0x24, 0xd0, 0x46, 0x48, 0x75, 0x71, 0x61, 0x59, 0x7d, 0xce, 0xd2, 0x7d, 0x2c, 0x85, 0x95, 0xa1, 0x6d, 0xaa, 0x2c, 0xd2, 0xaa, 0x99, 0x6d, 0xc2, 0xca, 0xda, 0xd4, 0x5e, 0xde, 0xee, 0xd6 };
             memcpy(cart->bank0.palette.vbank0.data, DB16, sizeof DB16);
         }
 #endif
@@ -253,6 +256,171 @@ void tic_cart_load(tic_cartridge* cart, const u8* buffer, s32 size)
         free(chunk_cart);
 }
 
+typedef struct
+{
+    const u8* ptr;
+    const u8* end;
+    tic_unzip* zip;
+} PeekStream;
+
+static s32 peekRead(PeekStream* stream, void* dest, s32 size)
+{
+    if(stream->zip)
+        return tic_tool_unzip_read(stream->zip, dest, size);
+
+    size = MIN(size, (s32)(stream->end - stream->ptr));
+
+    if(dest)
+        memcpy(dest, stream->ptr, size);
+
+    stream->ptr += size;
+    return size;
+}
+
+#if defined(BUILD_DEPRECATED)
+static void* peekAlloc(PeekStream* stream, s32 size)
+{
+    u8* data = malloc(size);
+
+    if(data && peekRead(stream, data, size) != size)
+    {
+        free(data);
+        data = NULL;
+    }
+
+    return data;
+}
+#endif
+
+bool tic_cart_peek(tic_cart_info* info, const u8* buffer, s32 size)
+{
+    memset(info, 0, sizeof(tic_cart_info));
+
+    PeekStream stream = {buffer, buffer + size};
+
+    // only the cartridge chunk of a PNG is inflated, the image isn't decoded at all
+    if (size > 8 && !memcmp(buffer, "\x89PNG", 4))
+    {
+        const u8* ptr = buffer + 8;
+        while (ptr + 12 <= stream.end)
+        {
+            s32 siz = ((ptr[0] << 24) | (ptr[1] << 16) | (ptr[2] << 8) | ptr[3]);
+            if (!memcmp(ptr + 4, "caRt", 4) && siz > 0 && siz <= stream.end - ptr - 8)
+            {
+                stream.zip = tic_tool_unzip_open(ptr + 8, siz);
+                break;
+            }
+            ptr += siz + 12;
+        }
+
+        if (!stream.zip)
+            return false;
+    }
+
+    s32 codeBank = -1;
+    bool codeZip = false;
+
+#if defined(BUILD_DEPRECATED)
+    u8* coverDep = NULL;
+    s32 coverDepSize = 0;
+#endif
+
+    Chunk chunk;
+    while (peekRead(&stream, &chunk, sizeof chunk) == sizeof chunk)
+    {
+        s32 size = chunkSize(&chunk);
+        void* dest = NULL;
+        s32 destSize = 0;
+
+        switch (chunk.bank == 0 ? chunk.type : CHUNK_DUMMY)
+        {
+        case CHUNK_PALETTE:
+            dest = &info->palette;
+            destSize = sizeof info->palette;
+            break;
+        case CHUNK_DEFAULT:
+            memcpy(&info->palette, Sweetie16, sizeof Sweetie16);
+            break;
+        case CHUNK_SCREEN:
+            dest = &info->screen;
+            destSize = sizeof info->screen;
+            break;
+        case CHUNK_LANG:
+            dest = &info->lang;
+            destSize = sizeof info->lang;
+            break;
+#if defined(BUILD_DEPRECATED)
+        case CHUNK_CODE_ZIP:
+            {
+                u8* data = peekAlloc(&stream, size);
+                size = 0;
+
+                if (data)
+                {
+                    tic_unzip* zip = tic_tool_unzip_open(data, chunkSize(&chunk));
+
+                    if (zip)
+                    {
+                        memset(info->code, 0, sizeof info->code);
+                        tic_tool_unzip_read(zip, info->code, sizeof info->code - 1);
+                        tic_tool_unzip_close(zip);
+                        codeZip = true;
+                    }
+
+                    free(data);
+                }
+            }
+            break;
+        case CHUNK_COVER_DEP:
+            FREE(coverDep);
+            coverDep = peekAlloc(&stream, coverDepSize = size);
+            size = 0;
+            break;
+#endif
+        default: break;
+        }
+
+        // code is saved from the last bank down to the first one, the header is in the last bank
+        if (chunk.type == CHUNK_CODE && !codeZip && (s32)chunk.bank > codeBank)
+        {
+            codeBank = chunk.bank;
+            memset(info->code, 0, sizeof info->code);
+            dest = info->code;
+            destSize = sizeof info->code - 1;
+        }
+
+        s32 read = dest ? peekRead(&stream, dest, MIN(size, destSize)) : 0;
+        peekRead(&stream, NULL, size - read);
+    }
+
+    if (stream.zip)
+        tic_tool_unzip_close(stream.zip);
+
+#if defined(BUILD_DEPRECATED)
+    if (EMPTY(info->palette.data))
+        memcpy(info->palette.data, DB16, sizeof DB16);
+
+    if (coverDep)
+    {
+        gif_image* image = gif_read_data(coverDep, coverDepSize);
+
+        if (image)
+        {
+            if(image->width == TIC80_WIDTH && image->height == TIC80_HEIGHT)
+                for (s32 i = 0; i < TIC80_WIDTH * TIC80_HEIGHT; i++)
+                    tic_tool_poke4(info->screen.data, i, 
+                        tic_nearest_color(info->palette.colors, (const tic_rgb*)&image->palette[image->buffer[i]], TIC_PALETTE_SIZE));
+
+            gif_close(image);
+        }
+
+        free(coverDep);
+    }
+#endif
+
+    return true;
+}
+
 
 static s32 calcBufferSize(const void* buffer, s32 size)
 {
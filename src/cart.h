@@ -24,5 +24,20 @@
 
 #include "tic.h"
 
+// the beginning of the code, enough to read the header metatags
+#define TIC_CART_INFO_CODE_SIZE (4 * 1024)
+
+typedef struct
+{
+    tic_screen screen;
+    tic_palette palette;
+    u8 lang;
+    char code[TIC_CART_INFO_CODE_SIZE];
+} tic_cart_info;
+
 void tic_cart_load(tic_cartridge* rom, const u8* buffer, s32 size);
 s32  tic_cart_save(const tic_cartridge* rom, u8* buffer);
+
+// walks the chunks and only reads the bank 0 cover, palette, language and the code header,
+// returns false if the buffer doesn't contain cart chunks (PNG covers without caRt chunk)
+bool tic_cart_peek(tic_cart_info* info, const u8* buffer, s32 size);
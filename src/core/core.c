@@ -23,6 +23,7 @@
 #include "api.h"
 #include "core.h"
 #include "tilesheet.h"
+#include "simd.h"
 
 #include <assert.h>
 #include <string.h>
@@ -45,12 +46,29 @@ static_assert(sizeof(tic_palette) == 48,    "tic_palette");
 static_assert(sizeof(((tic_vram *)0)->vars) == 4, "tic_vram vars");
 static_assert(sizeof(tic_vram) == TIC_VRAM_SIZE,    "tic_vram");
 static_assert(sizeof(tic_ram) == TIC_RAM_SIZE,      "tic_ram");
+static_assert(offsetof(tic_ram, vram.screen) == 0,  "tic_ram screen");
 
-u8 tic_api_peek(tic_mem* memory, s32 address, s32 bits)
+void tic_core_dirty_rows(tic_core* core, s32 from, s32 to)
+{
+    for(s32 row = MAX(from, 0), end = MIN(to, TIC80_HEIGHT); row < end; ++row)
+        tic_core_dirty_row(core, row);
+}
+
+void tic_core_dirty_ram(tic_core* core, s32 address, s32 size)
+{
+    enum{RowSize = TIC80_WIDTH * TIC_PALETTE_BPP / BITS_IN_BYTE, ScreenSize = sizeof(tic_screen)};
+
+    if(size > 0 && address < ScreenSize)
+        tic_core_dirty_rows(core, address / RowSize, (MIN(address + size, ScreenSize) - 1) / RowSize + 1);
+}
+
+static u8 peek(tic_mem* memory, s32 address, s32 bits)
 {
     if (address < 0)
         return 0;
 
+    tic_core_flush_tris((tic_core*)memory);
+
     const u8* ram = (u8*)memory->ram;
     enum{RamBits = sizeof(tic_ram) * BITS_IN_BYTE};
 
@@ -65,14 +83,16 @@ u8 tic_api_peek(tic_mem* memory, s32 address, s32 bits)
     return 0;
 }
 
-void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
+static void poke(tic_mem* memory, s32 address, u8 value, s32 bits)
 {
     if (address < 0)
         return;
 
     tic_core* core = (tic_core*)memory;
     u8* ram = (u8*)memory->ram;
-    enum{RamBits = sizeof(tic_ram) * BITS_IN_BYTE};
+    enum{RamBits = sizeof(tic_ram) * BITS_IN_BYTE, RowBits = TIC80_WIDTH * TIC_PALETTE_BPP};
+
+    tic_core_flush_tris(core);
     
     switch(bits)
     {
@@ -80,42 +100,151 @@ void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
     case 2: if(address < RamBits / 2) tic_tool_poke2(ram, address, value); break;
     case 4: if(address < RamBits / 4) tic_tool_poke4(ram, address, value); break;
     case 8: if(address < RamBits / 8) ram[address] = value; break;
+    default: return;
     }
+
+    if(address < TIC80_HEIGHT * RowBits / bits)
+        tic_core_dirty_row(core, address * bits / RowBits);
+}
+
+static u8 peekStats(tic_mem* memory, s32 address, s32 bits, tic_api_id id)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+
+    u8 value = peek(memory, address, bits);
+
+    tic_core_api_leave(core, id, start, 0);
+    return value;
+}
+
+static void pokeStats(tic_mem* memory, s32 address, u8 value, s32 bits, tic_api_id id)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+
+    poke(memory, address, value, bits);
+
+    tic_core_api_leave(core, id, start, 0);
+}
+
+u8 tic_api_peek(tic_mem* memory, s32 address, s32 bits)
+{
+    return peekStats(memory, address, bits, tic_api_id_peek);
+}
+
+void tic_api_poke(tic_mem* memory, s32 address, u8 value, s32 bits)
+{
+    pokeStats(memory, address, value, bits, tic_api_id_poke);
 }
 
 u8 tic_api_peek4(tic_mem* memory, s32 address)
 {
-    return tic_api_peek(memory, address, 4);
+    return peekStats(memory, address, 4, tic_api_id_peek4);
 }
 
 u8 tic_api_peek1(tic_mem* memory, s32 address)
 {
-    return tic_api_peek(memory, address, 1);
+    return peekStats(memory, address, 1, tic_api_id_peek1);
 }
 
 void tic_api_poke1(tic_mem* memory, s32 address, u8 value)
 {
-    tic_api_poke(memory, address, value, 1);
+    pokeStats(memory, address, value, 1, tic_api_id_poke1);
 }
 
 u8 tic_api_peek2(tic_mem* memory, s32 address)
 {
-    return tic_api_peek(memory, address, 2);
+    return peekStats(memory, address, 2, tic_api_id_peek2);
 }
 
 void tic_api_poke2(tic_mem* memory, s32 address, u8 value)
 {
-    tic_api_poke(memory, address, value, 2);
+    pokeStats(memory, address, value, 2, tic_api_id_poke2);
 }
 
 void tic_api_poke4(tic_mem* memory, s32 address, u8 value)
 {
-    tic_api_poke(memory, address, value, 4);
+    pokeStats(memory, address, value, 4, tic_api_id_poke4);
+}
+
+// the part [from, to) of count values at address that is inside ram, false when there is none
+static bool ramValues(s32 address, s32 count, s32 bits, s32* from, s32* to)
+{
+    enum{RamBits = sizeof(tic_ram) * BITS_IN_BYTE};
+
+    switch(bits)
+    {
+    case 1: case 2: case 4: case 8: break;
+    default: return false;
+    }
+
+    if(count <= 0)
+        return false;
+
+    *from = (s32)MIN(MAX(-(s64)address, 0), count);
+    *to = (s32)MAX(MIN(RamBits / bits - (s64)address, count), 0);
+
+    return *from < *to;
+}
+
+void tic_api_peeks(tic_mem* memory, s32 address, s32 count, s32 bits, u8* values)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+    s32 from, to;
+
+    count = MAX(count, 0);
+    memset(values, 0, count);
+
+    if(ramValues(address, count, bits, &from, &to))
+    {
+        const u8* ram = (u8*)memory->ram;
+        tic_core_flush_tris(core);
+
+        switch(bits)
+        {
+        case 1: for(s32 i = from; i < to; i++) values[i] = tic_tool_peek1(ram, address + i); break;
+        case 2: for(s32 i = from; i < to; i++) values[i] = tic_tool_peek2(ram, address + i); break;
+        case 4: for(s32 i = from; i < to; i++) values[i] = tic_tool_peek4(ram, address + i); break;
+        case 8: memcpy(values + from, ram + address + from, to - from); break;
+        }
+    }
+
+    tic_core_api_leave(core, tic_api_id_peeks, start, count);
+}
+
+void tic_api_pokes(tic_mem* memory, s32 address, const u8* values, s32 count, s32 bits)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+    s32 from, to;
+
+    if(ramValues(address, count, bits, &from, &to))
+    {
+        u8* ram = (u8*)memory->ram;
+        tic_core_flush_tris(core);
+
+        switch(bits)
+        {
+        case 1: for(s32 i = from; i < to; i++) tic_tool_poke1(ram, address + i, values[i]); break;
+        case 2: for(s32 i = from; i < to; i++) tic_tool_poke2(ram, address + i, values[i]); break;
+        case 4: for(s32 i = from; i < to; i++) tic_tool_poke4(ram, address + i, values[i]); break;
+        case 8: memcpy(ram + address + from, values + from, to - from); break;
+        }
+
+        s32 first = (address + from) * bits / BITS_IN_BYTE;
+        s32 last = ((address + to) * bits + BITS_IN_BYTE - 1) / BITS_IN_BYTE;
+        tic_core_dirty_ram(core, first, last - first);
+    }
+
+    tic_core_api_leave(core, tic_api_id_pokes, start, MAX(count, 0));
 }
 
 void tic_api_memcpy(tic_mem* memory, s32 dst, s32 src, s32 size)
 {
     tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
     s32 bound = sizeof(tic_ram) - size;
 
     if (size >= 0
@@ -126,13 +255,18 @@ void tic_api_memcpy(tic_mem* memory, s32 dst, s32 src, s32 size)
         && src <= bound)
     {
         u8* base = (u8*)memory->ram;
+        tic_core_flush_tris(core);
         memcpy(base + dst, base + src, size);
+        tic_core_dirty_ram(core, dst, size);
     }
+
+    tic_core_api_leave(core, tic_api_id_memcpy, start, MAX(size, 0));
 }
 
 void tic_api_memset(tic_mem* memory, s32 dst, u8 val, s32 size)
 {
     tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
     s32 bound = sizeof(tic_ram) - size;
 
     if (size >= 0
@@ -141,30 +275,47 @@ void tic_api_memset(tic_mem* memory, s32 dst, u8 val, s32 size)
         && dst <= bound)
     {
         u8* base = (u8*)memory->ram;
+        tic_core_flush_tris(core);
         memset(base + dst, val, size);
+        tic_core_dirty_ram(core, dst, size);
     }
+
+    tic_core_api_leave(core, tic_api_id_memset, start, MAX(size, 0));
 }
 
 void tic_api_trace(tic_mem* memory, const char* text, u8 color)
 {
     tic_core* core = (tic_core*)memory;
-    core->data->trace(core->data->data, text ? text : "nil", color);
+    u64 start = tic_core_api_enter(core);
+
+    text = text ? text : "nil";
+    core->data->trace(core->data->data, text, color);
+
+    tic_core_api_leave(core, tic_api_id_trace, start, start ? strlen(text) : 0);
 }
 
 u32 tic_api_pmem(tic_mem* tic, s32 index, u32 value, bool set)
 {
+    tic_core* core = (tic_core*)tic;
+    u64 start = tic_core_api_enter(core);
+
     u32 old = tic->ram->persistent.data[index];
 
     if (set)
         tic->ram->persistent.data[index] = value;
 
+    tic_core_api_leave(core, tic_api_id_pmem, start, 0);
     return old;
 }
 
 void tic_api_exit(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
+    u64 start = tic_core_api_enter(core);
+
     core->data->exit(core->data->data);
+
+    tic_core_api_leave(core, tic_api_id_exit, start, 0);
 }
 
 static inline void sync(void* dst, void* src, s32 size, bool rev)
@@ -198,10 +349,15 @@ void tic_api_sync(tic_mem* tic, u32 mask, s32 bank, bool toCart)
 
     enum { Count = COUNT_OF(Sections), Mask = (1 << Count) - 1 };
 
+    u64 start = tic_core_api_enter(core);
+    u64 bytes = 0;
+
     if (mask == 0) mask = Mask;
 
     mask &= ~core->state.synced & Mask;
 
+    tic_core_flush_tris(core);
+
     assert(bank >= 0 && bank < TIC_BANKS);
 
     for (s32 i = 0; i < Count; i++)
@@ -211,6 +367,7 @@ void tic_api_sync(tic_mem* tic, u32 mask, s32 bank, bool toCart)
         {
             tic_bank* bankPtr = &tic->cart.banks[bank];
             s32 size = Sections[i].size;
+            bytes += size;
 
             if(sectionMask == tic_sync_palette)
             {
@@ -223,23 +380,38 @@ void tic_api_sync(tic_mem* tic, u32 mask, s32 bank, bool toCart)
             else
             {
                 sync(tic->ram->data + Sections[i].ram, (u8*)bankPtr + Sections[i].bank, size, toCart);
+
+                if(!toCart)
+                    tic_core_dirty_ram(core, Sections[i].ram, size);
             }
         }        
     }
 
     core->state.synced |= mask;
+
+    tic_core_api_leave(core, tic_api_id_sync, start, bytes);
 }
 
 double tic_api_time(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
-    return (double)(core->data->counter(core->data->data) - core->data->start) * 1000.0 / core->data->freq(core->data->data);
+    u64 start = tic_core_api_enter(core);
+
+    double value = (double)(core->data->counter(core->data->data) - core->data->start) * 1000.0 / core->data->freq(core->data->data);
+
+    tic_core_api_leave(core, tic_api_id_time, start, 0);
+    return value;
 }
 
 s32 tic_api_tstamp(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
-    return (s32)time(NULL);
+    u64 start = tic_core_api_enter(core);
+
+    s32 value = (s32)time(NULL);
+
+    tic_core_api_leave(core, tic_api_id_tstamp, start, 0);
+    return value;
 }
 
 static bool compareMetatag(const char* code, const char* tag, const char* value, const char* comment)
@@ -366,9 +538,14 @@ void tic_api_reset(tic_mem* memory)
     // the middle of a tick... so we preserve now, which during `tick_end`
     // is copied to previous. This duplicates the prior behavior of
     // `ram.input.keyboard` (which existing outside `state`).
+    u64 start = tic_core_api_enter(core);
+
+    tic_core_flush_tris(core);
+
     u32 kb_now = core->state.keyboard.now.data;
     ZEROMEM(core->state);
     core->state.keyboard.now.data = kb_now;
+    tic_core_invalidate(memory);
     tic_api_clip(memory, 0, 0, TIC80_WIDTH, TIC80_HEIGHT);
 
     resetVbank(memory);
@@ -383,6 +560,8 @@ void tic_api_reset(tic_mem* memory)
     soundClear(memory);
     updateSaveid(memory);
     font2ram(memory);
+
+    tic_core_api_leave(core, tic_api_id_reset, start, 0);
 }
 
 static void cart2ram(tic_mem* memory)
@@ -440,6 +619,9 @@ s32 tic_api_vbank(tic_mem* tic, s32 bank)
     tic_core* core = (tic_core*)tic;
 
     s32 prev = core->state.vbank.id;
+    u64 start = tic_core_api_enter(core);
+
+    tic_core_flush_tris(core);
 
     switch(bank)
     {
@@ -452,10 +634,11 @@ s32 tic_api_vbank(tic_mem* tic, s32 bank)
         }
     }
 
+    tic_core_api_leave(core, tic_api_id_vbank, start, 0);
     return prev;
 }
 
-void tic_core_tick(tic_mem* tic, tic_tick_data* data)
+static void tickScript(tic_mem* tic, tic_tick_data* data)
 {
     tic_core* core = (tic_core*)tic;
 
@@ -512,10 +695,23 @@ void tic_core_tick(tic_mem* tic, tic_tick_data* data)
     core->state.tick(tic);
 }
 
+void tic_core_tick(tic_mem* tic, tic_tick_data* data)
+{
+    tic_core* core = (tic_core*)tic;
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_SCRIPT);
+
+    tickScript(tic, data);
+    tic_core_flush_tris(core);
+
+    tic_core_perf_pop(core, phase);
+}
+
 void tic_core_pause(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
 
+    tic_core_flush_tris(core);
+
     memcpy(&core->pause.state, &core->state, sizeof(tic_core_state_data));
     memcpy(&core->pause.ram, memory->ram, sizeof(tic_ram));
     core->pause.input = memory->input.data;
@@ -535,6 +731,7 @@ void tic_core_resume(tic_mem* memory)
     {
         memcpy(&core->state, &core->pause.state, sizeof(tic_core_state_data));
         memcpy(memory->ram, &core->pause.ram, sizeof(tic_ram));
+        tic_core_invalidate(memory);
         core->data->start = core->pause.time.start + core->data->counter(core->data->data) - core->pause.time.paused;
         memory->input.data = core->pause.input;
     }
@@ -552,6 +749,9 @@ void tic_core_close(tic_mem* memory)
 
     tic_close_current_vm(core);
 
+    free(core->tris.items);
+    free(core->api.stats);
+
     blip_delete(core->blip.left);
     blip_delete(core->blip.right);
 
@@ -564,9 +764,97 @@ void tic_core_close(tic_mem* memory)
     free(core);
 }
 
+u64 tic_core_perf_now()
+{
+    struct timespec ts;
+
+#if defined(CLOCK_MONOTONIC)
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+
+    return (u64)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+void tic_core_perf_switch(tic_core* core, s32 phase)
+{
+    u64 now = tic_core_perf_now();
+
+    if(core->perf.phase >= 0)
+        core->perf.frames[core->perf.index].ns[core->perf.phase] += now - core->perf.mark;
+
+    core->perf.phase = phase;
+    core->perf.mark = now;
+}
+
+void tic_core_perf_enable(tic_mem* tic, bool enable)
+{
+    tic_core* core = (tic_core*)tic;
+
+    if(core->perf.enabled == enable)
+        return;
+
+    core->perf.enabled = enable;
+    core->perf.phase = -1;
+    core->perf.index = 0;
+    core->perf.count = 0;
+    ZEROMEM(core->perf.frames[0]);
+}
+
+bool tic_core_perf_enabled(tic_mem* tic)
+{
+    return ((tic_core*)tic)->perf.enabled;
+}
+
+s32 tic_core_perf_frames(tic_mem* tic, tic80_perf_frame* frames, s32 count)
+{
+    tic_core* core = (tic_core*)tic;
+
+    count = MIN(count, core->perf.count);
+
+    for(s32 i = 0; i < count; i++)
+        frames[i] = core->perf.frames[(core->perf.index - count + i + TIC80_PERF_FRAMES) % TIC80_PERF_FRAMES];
+
+    return count;
+}
+
+void tic_core_perf_add(tic_mem* tic, tic80_perf_phase phase, u64 ns)
+{
+    tic_core* core = (tic_core*)tic;
+
+    if(core->perf.enabled && phase >= 0 && phase < TIC80_PERF_PHASES)
+        core->perf.frames[core->perf.index].ns[phase] += ns;
+}
+
+s32 tic_core_perf_begin(tic_mem* tic, tic80_perf_phase phase)
+{
+    return tic_core_perf_push((tic_core*)tic, phase);
+}
+
+void tic_core_perf_end(tic_mem* tic, s32 prev)
+{
+    tic_core_perf_pop((tic_core*)tic, prev);
+}
+
+// the running phase is charged to the frame being closed
+static void perfNextFrame(tic_core* core)
+{
+    if(!core->perf.enabled)
+        return;
+
+    tic_core_perf_switch(core, core->perf.phase);
+
+    core->perf.index = (core->perf.index + 1) % TIC80_PERF_FRAMES;
+    core->perf.count = MIN(core->perf.count + 1, TIC80_PERF_FRAMES - 1);
+    ZEROMEM(core->perf.frames[core->perf.index]);
+}
+
 void tic_core_tick_start(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
+    perfNextFrame(core);
+    tic_core_api_next_frame(core);
     tic_core_sound_tick_start(memory);
     tic_core_tick_io(memory);
 
@@ -627,89 +915,343 @@ static inline void memset4(void* dst, u32 val, u32 dwords)
 #endif
 }
 
-static inline void updpal(tic_mem* tic, tic_blitpal* pal0, tic_blitpal* pal1)
+typedef struct
+{
+    // palettes the colors were converted from
+    tic_palette vbank0;
+    tic_palette vbank1;
+    bool ready;
+
+    // vbank0 colors followed by vbank1 colors, indexed by composited pixels
+    u32 data[TIC_PALETTE_SIZE * 2];
+
+#if defined(TIC_SIMD_SSSE3) || defined(TIC_SIMD_NEON64)
+    // the same colors split into byte planes for the table lookups
+    u8 planes[sizeof(u32)][TIC_PALETTE_SIZE * 2];
+#endif
+} BlitPalette;
+
+enum
+{
+    RowBytes = TIC80_WIDTH * TIC_PALETTE_BPP / BITS_IN_BYTE,
+    Vbank1Color = TIC_PALETTE_SIZE,
+};
+
+static inline void updpal(tic_mem* tic, BlitPalette* pal)
 {
     tic_core* core = (tic_core*)tic;
-    *pal0 = tic_tool_palette_blit(&vbank0(core)->palette, core->screen_format);
-    *pal1 = tic_tool_palette_blit(&vbank1(core)->palette, core->screen_format);
+
+    // the palette is refreshed after every scanline callback, most of them leave it alone
+    if(pal->ready && MEMCMP(pal->vbank0, vbank0(core)->palette) && MEMCMP(pal->vbank1, vbank1(core)->palette))
+        return;
+
+    pal->vbank0 = vbank0(core)->palette;
+    pal->vbank1 = vbank1(core)->palette;
+    pal->ready = true;
+
+    tic_blitpal pal0 = tic_tool_palette_blit(&pal->vbank0, core->screen_format);
+    tic_blitpal pal1 = tic_tool_palette_blit(&pal->vbank1, core->screen_format);
+
+    memcpy(pal->data, pal0.data, sizeof pal0.data);
+    memcpy(pal->data + Vbank1Color, pal1.data, sizeof pal1.data);
+
+#if defined(TIC_SIMD_SSSE3) || defined(TIC_SIMD_NEON64)
+    const u8* src = (const u8*)pal->data;
+    for(s32 i = 0; i != COUNT_OF(pal->data); ++i)
+        for(s32 p = 0; p != sizeof(u32); ++p)
+            pal->planes[p][i] = *src++;
+#endif
 }
 
-static inline void updbdr(tic_mem* tic, s32 row, u32* ptr, tic_blit_callback clb, tic_blitpal* pal0, tic_blitpal* pal1)
+static inline void updbdr(tic_mem* tic, s32 row, tic_blit_callback clb, BlitPalette* pal)
 {
-    tic_core* core = (tic_core*)tic;
+    if(clb.border || clb.scanline)
+    {
+        tic_core* core = (tic_core*)tic;
+        s32 phase = tic_core_perf_push(core, TIC80_PERF_CALLBACKS);
 
-    if(clb.border) clb.border(tic, row, clb.data);
+        if(clb.border) clb.border(tic, row, clb.data);
 
-    if(clb.scanline)
+        if(clb.scanline)
+        {
+            if(row == 0) clb.scanline(tic, 0, clb.data);
+            else if(row > TIC80_MARGIN_TOP && row < (TIC80_HEIGHT + TIC80_MARGIN_TOP))
+                clb.scanline(tic, row - TIC80_MARGIN_TOP, clb.data);
+        }
+
+        tic_core_flush_tris(core);
+        tic_core_perf_pop(core, phase);
+
+        updpal(tic, pal);
+    }
+}
+
+// unpacks a screen row to a pixel per byte, the row is repeated when shifted to wrap the X offset
+static const u8* expandRow(u8* dst, const u8* src, s32 shift)
+{
+#if defined(TIC_SIMD_SSE2)
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    for(s32 i = 0; i < RowBytes; i += 16)
+    {
+        // the last block overlaps the previous one to stay inside the row
+        s32 offset = MIN(i, RowBytes - 16);
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + offset));
+        __m128i lo = _mm_and_si128(v, mask);
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        _mm_storeu_si128((__m128i*)(dst + offset * 2), _mm_unpacklo_epi8(lo, hi));
+        _mm_storeu_si128((__m128i*)(dst + offset * 2 + 16), _mm_unpackhi_epi8(lo, hi));
+    }
+#elif defined(TIC_SIMD_NEON)
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    for(s32 i = 0; i < RowBytes; i += 16)
     {
-        if(row == 0) clb.scanline(tic, 0, clb.data);
-        else if(row > TIC80_MARGIN_TOP && row < (TIC80_HEIGHT + TIC80_MARGIN_TOP))
-            clb.scanline(tic, row - TIC80_MARGIN_TOP, clb.data);
+        s32 offset = MIN(i, RowBytes - 16);
+        uint8x16_t v = vld1q_u8(src + offset);
+        uint8x16x2_t pixels = {{vandq_u8(v, mask), vshrq_n_u8(v, 4)}};
+        vst2q_u8(dst + offset * 2, pixels);
     }
+#else
+    for(s32 i = 0; i != RowBytes; ++i)
+    {
+        dst[i * 2] = src[i] & 0x0f;
+        dst[i * 2 + 1] = src[i] >> 4;
+    }
+#endif
 
-    if(clb.border || clb.scanline)
-        updpal(tic, pal0, pal1);
+    if(shift)
+        memcpy(dst + TIC80_WIDTH, dst, shift);
 
-    memset4(ptr, pal0->data[vbank0(core)->vars.border], TIC80_FULLWIDTH);
+    return dst + shift;
 }
 
-static inline u32 blitpix(tic_mem* tic, s32 offset0, s32 offset1, const tic_blitpal* pal0, const tic_blitpal* pal1)
+static bool isClearRow(const u8* src, u8 clear)
 {
-    tic_core* core = (tic_core*)tic;
-    u32 pix = tic_tool_peek4(vbank1(core)->screen.data, offset1);
+    const u64 value = (clear | clear << TIC_PALETTE_BPP) * 0x0101010101010101ull;
+
+    for(s32 i = 0; i != RowBytes; i += sizeof value)
+    {
+        u64 word;
+        memcpy(&word, src + i, sizeof word);
+        if(word != value) return false;
+    }
+
+    return true;
+}
+
+// vbank1 pixels win over vbank0 unless they have the clear color
+static void composeRow(u8* dst, const u8* pix0, const u8* pix1, u8 clear)
+{
+#if defined(TIC_SIMD_SSE2)
+    const __m128i key = _mm_set1_epi8(clear), bank = _mm_set1_epi8(Vbank1Color);
+    for(s32 i = 0; i != TIC80_WIDTH; i += 16)
+    {
+        __m128i v0 = _mm_loadu_si128((const __m128i*)(pix0 + i));
+        __m128i v1 = _mm_loadu_si128((const __m128i*)(pix1 + i));
+        __m128i m = _mm_cmpeq_epi8(v1, key);
+        _mm_storeu_si128((__m128i*)(dst + i), 
+            _mm_or_si128(_mm_and_si128(m, v0), _mm_andnot_si128(m, _mm_or_si128(v1, bank))));
+    }
+#elif defined(TIC_SIMD_NEON)
+    const uint8x16_t key = vdupq_n_u8(clear), bank = vdupq_n_u8(Vbank1Color);
+    for(s32 i = 0; i != TIC80_WIDTH; i += 16)
+    {
+        uint8x16_t v1 = vld1q_u8(pix1 + i);
+        vst1q_u8(dst + i, vbslq_u8(vceqq_u8(v1, key), vld1q_u8(pix0 + i), vorrq_u8(v1, bank)));
+    }
+#else
+    for(s32 i = 0; i != TIC80_WIDTH; ++i)
+        dst[i] = pix1[i] == clear ? pix0[i] : pix1[i] | Vbank1Color;
+#endif
+}
+
+static void gatherRow(u32* dst, const u8* pixels, const BlitPalette* pal)
+{
+#if defined(TIC_SIMD_SSSE3)
+    const __m128i high = _mm_set1_epi8(Vbank1Color - 1);
+    __m128i lo[sizeof(u32)], hi[sizeof(u32)];
+    for(s32 p = 0; p != sizeof(u32); ++p)
+    {
+        lo[p] = _mm_loadu_si128((const __m128i*)pal->planes[p]);
+        hi[p] = _mm_loadu_si128((const __m128i*)(pal->planes[p] + Vbank1Color));
+    }
 
-    return pix != vbank1(core)->vars.clear
-        ? pal1->data[pix]
-        : pal0->data[tic_tool_peek4(vbank0(core)->screen.data, offset0)];
+    for(s32 i = 0; i != TIC80_WIDTH; i += 16, dst += 16)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(pixels + i));
+        __m128i m = _mm_cmpgt_epi8(v, high);
+        __m128i c[sizeof(u32)];
+
+        for(s32 p = 0; p != sizeof(u32); ++p)
+            c[p] = _mm_or_si128(_mm_andnot_si128(m, _mm_shuffle_epi8(lo[p], v)), _mm_and_si128(m, _mm_shuffle_epi8(hi[p], v)));
+
+        __m128i c01l = _mm_unpacklo_epi8(c[0], c[1]), c01h = _mm_unpackhi_epi8(c[0], c[1]);
+        __m128i c23l = _mm_unpacklo_epi8(c[2], c[3]), c23h = _mm_unpackhi_epi8(c[2], c[3]);
+        _mm_storeu_si128((__m128i*)dst + 0, _mm_unpacklo_epi16(c01l, c23l));
+        _mm_storeu_si128((__m128i*)dst + 1, _mm_unpackhi_epi16(c01l, c23l));
+        _mm_storeu_si128((__m128i*)dst + 2, _mm_unpacklo_epi16(c01h, c23h));
+        _mm_storeu_si128((__m128i*)dst + 3, _mm_unpackhi_epi16(c01h, c23h));
+    }
+#elif defined(TIC_SIMD_NEON64)
+    uint8x16x2_t planes[sizeof(u32)];
+    for(s32 p = 0; p != sizeof(u32); ++p)
+    {
+        planes[p].val[0] = vld1q_u8(pal->planes[p]);
+        planes[p].val[1] = vld1q_u8(pal->planes[p] + Vbank1Color);
+    }
+
+    for(s32 i = 0; i != TIC80_WIDTH; i += 16, dst += 16)
+    {
+        uint8x16_t v = vld1q_u8(pixels + i);
+        uint8x16x4_t c;
+
+        for(s32 p = 0; p != sizeof(u32); ++p)
+            c.val[p] = vqtbl2q_u8(planes[p], v);
+
+        vst4q_u8((u8*)dst, c);
+    }
+#else
+    for(s32 i = 0; i != TIC80_WIDTH; ++i)
+        dst[i] = pal->data[pixels[i]];
+#endif
+}
+
+typedef struct
+{
+    u8 pix0[TIC80_WIDTH * 2];
+    u8 pix1[TIC80_WIDTH * 2];
+    u8 pixels[TIC80_WIDTH];
+} RowPixels;
+
+// palette indices of a visible row, vbank1 colors are offset by Vbank1Color
+static const u8* screenRow(tic_core* core, s32 y, RowPixels* buf)
+{
+    const tic_vram* bank0 = vbank0(core);
+    const tic_vram* bank1 = vbank1(core);
+
+    const u8* src0 = bank0->screen.data + (y + bank0->vars.offset.y + TIC80_HEIGHT) % TIC80_HEIGHT * RowBytes;
+    const u8* src1 = bank1->screen.data + (y + bank1->vars.offset.y + TIC80_HEIGHT) % TIC80_HEIGHT * RowBytes;
+    const u8* row0 = expandRow(buf->pix0, src0, (bank0->vars.offset.x + TIC80_WIDTH) % TIC80_WIDTH);
+
+    // nothing to composite, vbank0 pixels index its own palette directly
+    if(isClearRow(src1, bank1->vars.clear))
+        return row0;
+
+    composeRow(buf->pixels, row0, expandRow(buf->pix1, src1, (bank1->vars.offset.x + TIC80_WIDTH) % TIC80_WIDTH), bank1->vars.clear);
+    return buf->pixels;
+}
+
+static void blitRow(tic_mem* tic, u32* dst, s32 y, const BlitPalette* pal)
+{
+    RowPixels buf;
+    gatherRow(dst, screenRow((tic_core*)tic, y, &buf), pal);
+}
+
+static inline bool isDirty(const u32* rows, s32 row)
+{
+    return rows[row / TIC80_DIRTY_BITS] >> (row % TIC80_DIRTY_BITS) & 1;
+}
+
+static inline void setDirty(u32* rows, s32 row)
+{
+    rows[row / TIC80_DIRTY_BITS] |= 1u << (row % TIC80_DIRTY_BITS);
+}
+
+// compares what the row is blitted from with the previous frame
+static bool isRowChanged(tic_core* core, s32 row, const BlitPalette* pal, const tic_blit_dirty* pending)
+{
+    const tic_vram* bank0 = vbank0(core);
+    const tic_vram* bank1 = vbank1(core);
+    const tic_blit_dirty* live = &core->blit.dirty;
+
+    tic_blit_row key;
+    ZEROMEM(key);
+    memcpy(key.colors, pal->data, sizeof key.colors);
+    key.border = bank0->vars.border;
+    key.clear = bank1->vars.clear;
+    key.offset[0][0] = bank0->vars.offset.x;
+    key.offset[0][1] = bank0->vars.offset.y;
+    key.offset[1][0] = bank1->vars.offset.x;
+    key.offset[1][1] = bank1->vars.offset.y;
+
+    bool changed = !pending->valid || !live->valid
+        || isDirty(pending->screen, row)
+        || !MEMCMP(key, core->blit.rows[row]);
+
+    s32 y = row - TIC80_MARGIN_TOP;
+
+    if(!changed && y >= 0 && y < TIC80_HEIGHT)
+    {
+        s32 y0 = (y + bank0->vars.offset.y + TIC80_HEIGHT) % TIC80_HEIGHT;
+        s32 y1 = (y + bank1->vars.offset.y + TIC80_HEIGHT) % TIC80_HEIGHT;
+
+        changed = isDirty(pending->vram[0], y0) || isDirty(live->vram[0], y0)
+            || isDirty(pending->vram[1], y1) || isDirty(live->vram[1], y1);
+    }
+
+    core->blit.rows[row] = key;
+
+    return changed;
 }
 
 void tic_core_blit_ex(tic_mem* tic, tic_blit_callback clb)
 {
     tic_core* core = (tic_core*)tic;
+    tic80* product = &tic->product;
+
+    tic_core_flush_tris(core);
 
-    tic_blitpal pal0, pal1;
-    updpal(tic, &pal0, &pal1);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_BLIT);
 
-    s32 row = 0;
-    u32* rowPtr = tic->product.screen;
+    // writes made during the blit, e.g. by scanline callbacks, are picked up by the next one too
+    tic_blit_dirty pending = core->blit.dirty;
+    ZEROMEM(core->blit.dirty);
+    core->blit.dirty.valid = true;
 
-#define UPDBDR() updbdr(tic, row, rowPtr, clb, &pal0, &pal1)
+    ZEROMEM(product->dirty.rows);
+    product->dirty.unchanged = true;
 
-    for(; row != TIC80_MARGIN_TOP; ++row, rowPtr += TIC80_FULLWIDTH)
-        UPDBDR();
+    BlitPalette pal = {.ready = false};
+    updpal(tic, &pal);
 
-    for(; row != TIC80_FULLHEIGHT - TIC80_MARGIN_BOTTOM; ++row)
+    u32* rowPtr = product->screen;
+
+    for(s32 row = 0; row != TIC80_FULLHEIGHT; ++row, rowPtr += TIC80_FULLWIDTH)
     {
-        UPDBDR();
-        rowPtr += TIC80_MARGIN_LEFT;
+        updbdr(tic, row, clb, &pal);
 
-        if(*(u16*)&vbank0(core)->vars.offset == 0 && *(u16*)&vbank1(core)->vars.offset == 0)
-        {
-            // render line without XY offsets
-            for(s32 x = (row - TIC80_MARGIN_TOP) * TIC80_WIDTH, end = x + TIC80_WIDTH; x != end; ++x)
-                *rowPtr++ = blitpix(tic, x, x, &pal0, &pal1);
-        }
-        else
+        if(isRowChanged(core, row, &pal, &pending))
         {
-            // render line with XY offsets
-            enum{OffsetY = TIC80_HEIGHT - TIC80_MARGIN_TOP};
-            s32 start0 = (row + vbank0(core)->vars.offset.y + OffsetY) % TIC80_HEIGHT * TIC80_WIDTH;
-            s32 start1 = (row + vbank1(core)->vars.offset.y + OffsetY) % TIC80_HEIGHT * TIC80_WIDTH;
-            s32 offsetX0 = vbank0(core)->vars.offset.x;
-            s32 offsetX1 = vbank1(core)->vars.offset.x;
-
-            for(s32 x = TIC80_WIDTH; x != 2 * TIC80_WIDTH; ++x)
-                *rowPtr++ = blitpix(tic, (x + offsetX0) % TIC80_WIDTH + start0, 
-                    (x + offsetX1) % TIC80_WIDTH + start1, &pal0, &pal1);
-        }
+            s32 y = row - TIC80_MARGIN_TOP;
+
+            memset4(rowPtr, pal.data[vbank0(core)->vars.border], TIC80_FULLWIDTH);
 
-        rowPtr += TIC80_MARGIN_RIGHT;
+            if(y >= 0 && y < TIC80_HEIGHT)
+                blitRow(tic, rowPtr + TIC80_MARGIN_LEFT, y, &pal);
+
+            setDirty(product->dirty.rows, row);
+            product->dirty.unchanged = false;
+        }
     }
 
-    for(; row != TIC80_FULLHEIGHT; ++row, rowPtr += TIC80_FULLWIDTH)
-        UPDBDR();
+    tic_core_perf_pop(core, phase);
+}
+
+void tic_core_invalidate(tic_mem* tic)
+{
+    tic_core* core = (tic_core*)tic;
+    core->blit.dirty.valid = false;
+}
+
+void tic_core_invalidate_rows(tic_mem* tic, s32 from, s32 to)
+{
+    tic_core* core = (tic_core*)tic;
 
-#undef  UPDBDR
+    for(s32 row = MAX(from, 0), end = MIN(to, TIC80_FULLHEIGHT); row < end; ++row)
+    {
+        setDirty(core->blit.dirty.screen, row);
+        setDirty(tic->product.dirty.rows, row);
+        tic->product.dirty.unchanged = false;
+    }
 }
 
 static inline void scanline(tic_mem* memory, s32 row, void* data)
@@ -733,6 +1275,22 @@ void tic_core_blit(tic_mem* tic)
     tic_core_blit_ex(tic, (tic_blit_callback){scanline, border, NULL});
 }
 
+void tic_core_blit_indexed(tic_mem* tic, u8* dst)
+{
+    tic_core* core = (tic_core*)tic;
+
+    tic_core_flush_tris(core);
+
+    for(s32 y = 0; y != TIC80_HEIGHT; ++y, dst += RowBytes)
+    {
+        RowPixels buf;
+        const u8* row = screenRow(core, y, &buf);
+
+        for(s32 i = 0; i != RowBytes; ++i)
+            dst[i] = (row[i * 2] & 0x0f) | (row[i * 2 + 1] & 0x0f) << TIC_PALETTE_BPP;
+    }
+}
+
 tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format)
 {
     tic_core* core = (tic_core*)malloc(sizeof(tic_core));
@@ -763,6 +1321,10 @@ tic_mem* tic_core_create(s32 samplerate, tic80_pixel_color_format format)
     blip_set_rates(core->blip.left, CLOCKRATE, samplerate);
     blip_set_rates(core->blip.right, CLOCKRATE, samplerate);
 
+    // one cpu gains nothing from the queue
+    core->tris.enabled = tic_jobs_cpus() > 1;
+    core->perf.phase = -1;
+
     tic_api_reset(&core->memory);
 
     return &core->memory;
@@ -24,6 +24,7 @@
 
 #include "api.h"
 #include "tools.h"
+#include "jobs.h"
 #include "blip_buf.h"
 
 #define CLOCKRATE (255<<13)
@@ -164,6 +165,30 @@ typedef struct
     bool initialized;
 } tic_core_state_data;
 
+// everything a screen row is blitted from, besides the vram rows
+typedef struct
+{
+    u32 colors[TIC_PALETTE_SIZE * 2];
+    u8 border;
+    u8 clear;
+    s8 offset[2][2];
+} tic_blit_row;
+
+typedef struct
+{
+    // vram rows written since the last blit, for each vbank
+    u32 vram[2][(TIC80_HEIGHT + TIC80_DIRTY_BITS - 1) / TIC80_DIRTY_BITS];
+
+    // product rows overwritten after the last blit
+    u32 screen[(TIC80_FULLHEIGHT + TIC80_DIRTY_BITS - 1) / TIC80_DIRTY_BITS];
+
+    // false when every row has to be blitted again
+    bool valid;
+} tic_blit_dirty;
+
+// a ttri call waiting to be rasterized, see draw.c
+typedef struct tic_deferred_tri tic_deferred_tri;
+
 typedef struct
 {
     tic_mem memory; // it should be first
@@ -182,6 +207,81 @@ typedef struct
     tic_tick_data* data;
     tic_core_state_data state;
 
+    struct
+    {
+        tic_blit_dirty dirty;
+        tic_blit_row rows[TIC80_FULLHEIGHT];
+    } blit;
+
+    // scratch state of the drawing code, kept per instance so cores can run on different threads
+    struct
+    {
+        u8 mapping[TIC_PALETTE_SIZE];
+        double zbuffer[TIC80_WIDTH * TIC80_HEIGHT];
+
+        // horizontal extents of filled shapes for each screen row
+        struct
+        {
+            s16 left[TIC80_HEIGHT];
+            s16 right[TIC80_HEIGHT];
+            s32 uleft[TIC80_HEIGHT];
+            s32 vleft[TIC80_HEIGHT];
+        } sides;
+
+        // map() and sprs() tiles unpacked through the palette mapping, valid for one call,
+        // sprs() slots also keep the sprite index and colorkey they were unpacked for
+        struct
+        {
+            u32 key[TIC_BANK_SPRITES];
+            u8 state[TIC_BANK_SPRITES];
+            u8 pixels[TIC_BANK_SPRITES][TIC_SPRITESIZE * TIC_SPRITESIZE];
+        } tiles;
+
+        // print() glyph column bounds and the font ram rows they were measured from
+        struct
+        {
+            u64 rows[TIC_FONT_CHARS * 2];
+            u8 start[TIC_FONT_CHARS * 2];
+            u8 width[TIC_FONT_CHARS * 2];
+        } glyphs;
+    } draw;
+
+    struct
+    {
+        // ttri calls are queued and drawn in screen bands on the shared pool,
+        // anything else touching ram draws the queue first
+        bool enabled;
+
+        tic_deferred_tri* items;
+        s32 count;
+        s32 capacity;
+
+        // bounding box area of the queue, small ones are drawn in place
+        s32 pixels;
+    } tris;
+
+    // phase profiler, time is charged to the running phase whenever it changes
+    struct
+    {
+        bool enabled;
+        s32 phase;
+        u64 mark;
+
+        // ring of frames, the one at index is being recorded
+        s32 index;
+        s32 count;
+        tic80_perf_frame frames[TIC80_PERF_FRAMES];
+    } perf;
+
+    struct
+    {
+        // allocated while api stats are enabled
+        struct tic_api_stats* stats;
+
+        // set while a call is timed, calls made from inside it are charged to it
+        bool busy;
+    } api;
+
     struct
     {
         tic_core_state_data state;   
@@ -201,6 +301,61 @@ void tic_core_tick_io(tic_mem* memory);
 void tic_core_sound_tick_start(tic_mem* memory);
 void tic_core_sound_tick_end(tic_mem* memory);
 
+// marks rows of the current vbank screen as written
+void tic_core_dirty_rows(tic_core* core, s32 from, s32 to);
+void tic_core_dirty_ram(tic_core* core, s32 address, s32 size);
+
+static inline void tic_core_dirty_row(tic_core* core, s32 row)
+{
+    core->blit.dirty.vram[core->state.vbank.id][row / TIC80_DIRTY_BITS] |= 1u << (row % TIC80_DIRTY_BITS);
+}
+
+void tic_core_draw_tris(tic_core* core);
+
+void tic_core_perf_switch(tic_core* core, s32 phase);
+
+// starts timing a phase and returns the one to go back to with tic_core_perf_pop()
+static inline s32 tic_core_perf_push(tic_core* core, s32 phase)
+{
+    s32 prev = core->perf.phase;
+
+    if(core->perf.enabled && prev != phase)
+        tic_core_perf_switch(core, phase);
+
+    return prev;
+}
+
+static inline void tic_core_perf_pop(tic_core* core, s32 prev)
+{
+    if(core->perf.enabled && core->perf.phase != prev)
+        tic_core_perf_switch(core, prev);
+}
+
+void tic_core_api_record(tic_core* core, tic_api_id id, u64 start, u64 size);
+void tic_core_api_next_frame(tic_core* core);
+
+// returns the start time of an api call to pass to tic_core_api_leave(), 0 when it isn't timed
+static inline u64 tic_core_api_enter(tic_core* core)
+{
+    if(!core->api.stats || core->api.busy)
+        return 0;
+
+    core->api.busy = true;
+    return tic_core_perf_now();
+}
+
+static inline void tic_core_api_leave(tic_core* core, tic_api_id id, u64 start, u64 size)
+{
+    if(start)
+        tic_core_api_record(core, id, start, size);
+}
+
+static inline void tic_core_flush_tris(tic_core* core)
+{
+    if(core->tris.count)
+        tic_core_draw_tris(core);
+}
+
 #if defined(BUILD_DEPRECATED)
 // mouse cursor is the same in both modes
 // for backward compatibility
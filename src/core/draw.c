@@ -23,6 +23,7 @@
 #include "api.h"
 #include "core.h"
 #include "tilesheet.h"
+#include "simd.h"
 
 #include <string.h>
 #include <stdlib.h>
@@ -31,8 +32,6 @@
 
 #define TRANSPARENT_COLOR 255
 
-typedef void(*PixelFunc)(tic_mem* memory, s32 x, s32 y, u8 color);
-
 static tic_tilesheet getTileSheetFromSegment(tic_mem* memory, u8 segment)
 {
     u8* src;
@@ -49,7 +48,7 @@ static tic_tilesheet getTileSheetFromSegment(tic_mem* memory, u8 segment)
 
 static u8* getPalette(tic_mem* tic, u8* colors, u8 count)
 {
-    static u8 mapping[TIC_PALETTE_SIZE];
+    u8* mapping = ((tic_core*)tic)->draw.mapping;
     for (s32 i = 0; i < TIC_PALETTE_SIZE; i++) mapping[i] = tic_tool_peek4(tic->ram->vram.mapping, i);
     for (s32 i = 0; i < count; i++) mapping[colors[i]] = TRANSPARENT_COLOR;
     return mapping;
@@ -60,26 +59,25 @@ static inline u8 mapColor(tic_mem* tic, u8 color)
     return tic_tool_peek4(tic->ram->vram.mapping, color & 0xf);
 }
 
-static inline void setPixel(tic_core* core, s32 x, s32 y, u8 color)
+static inline void setPixelFast(tic_core* core, s32 x, s32 y, u8 color)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-
-    if (x < core->state.clip.l || y < core->state.clip.t || x >= core->state.clip.r || y >= core->state.clip.b) return;
-
-    tic_api_poke4((tic_mem*)core, y * TIC80_WIDTH + x, color);
+    // does not do any CLIP checking, the caller needs to do that first
+    tic_tool_poke4(core->memory.ram->vram.screen.data, y * TIC80_WIDTH + x, color);
+    tic_core_dirty_row(core, y);
 }
 
-static inline void setPixelFast(tic_core* core, s32 x, s32 y, u8 color)
+static inline void setPixel(tic_core* core, s32 x, s32 y, u8 color)
 {
-    // does not do any CLIP checking, the caller needs to do that first
-    tic_api_poke4((tic_mem*)core, y * TIC80_WIDTH + x, color);
+    if (x < core->state.clip.l || y < core->state.clip.t || x >= core->state.clip.r || y >= core->state.clip.b) return;
+
+    setPixelFast(core, x, y, color);
 }
 
 static u8 getPixel(tic_core* core, s32 x, s32 y)
 {
     return x < 0 || y < 0 || x >= TIC80_WIDTH || y >= TIC80_HEIGHT
         ? 0
-        : tic_api_peek4((tic_mem*)core, y * TIC80_WIDTH + x);
+        : tic_tool_peek4(core->memory.ram->vram.screen.data, y * TIC80_WIDTH + x);
 }
 
 #define EARLY_CLIP(x, y, width, height) \
@@ -90,18 +88,53 @@ static u8 getPixel(tic_core* core, s32 x, s32 y)
         || ((x) >= core->state.clip.r) \
     )
 
-static void drawHLine(tic_core* core, s32 x, s32 y, s32 width, u8 color)
+// fills [index, index + count) screen pixels, the aligned middle is filled with the doubled color byte
+static void fillSpan(u8* screen, s32 index, s32 count, u8 color)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
+    if (count <= 0) return;
+
+    color &= 0xf;
+    u8* dst = screen + (index >> 1);
+
+    if (index & 1)
+    {
+        *dst = (*dst & 0x0f) | (color << 4);
+        dst++, count--;
+    }
+
+    const u8 value = color | (color << 4);
+    s32 size = count >> 1;
+
+#if defined(TIC_SIMD_SSE2)
+    const __m128i wide = _mm_set1_epi8(value);
+    for (; size >= 16; size -= 16, dst += 16)
+        _mm_storeu_si128((__m128i*)dst, wide);
+#elif defined(TIC_SIMD_NEON)
+    const uint8x16_t wide = vdupq_n_u8(value);
+    for (; size >= 16; size -= 16, dst += 16)
+        vst1q_u8(dst, wide);
+#endif
 
+    const u64 word = value * 0x0101010101010101ull;
+    for (; size >= sizeof word; size -= sizeof word, dst += sizeof word)
+        memcpy(dst, &word, sizeof word);
+
+    while (size--)
+        *dst++ = value;
+
+    if (count & 1)
+        *dst = (*dst & 0xf0) | color;
+}
+
+static void drawHLine(tic_core* core, s32 x, s32 y, s32 width, u8 color)
+{
     if (y < core->state.clip.t || core->state.clip.b <= y) return;
 
     s32 xl = MAX(x, core->state.clip.l);
     s32 xr = MIN(x + width, core->state.clip.r);
-    s32 start = y * TIC80_WIDTH;
 
-    for(s32 i = start + xl, end = start + xr; i < end; ++i)
-        tic_api_poke4((tic_mem*)core, i, color);
+    fillSpan(core->memory.ram->vram.screen.data, y * TIC80_WIDTH + xl, xr - xl, color);
+    tic_core_dirty_row(core, y);
 }
 
 static void drawVLine(tic_core* core, s32 x, s32 y, s32 height, u8 color)
@@ -119,7 +152,7 @@ static void drawVLine(tic_core* core, s32 x, s32 y, s32 height, u8 color)
 
 static void drawRect(tic_core* core, s32 x, s32 y, s32 width, s32 height, u8 color)
 {
-    for (s32 i = y; i < y + height; ++i)
+    for (s32 i = MAX(y, core->state.clip.t), end = MIN(y + height, core->state.clip.b); i < end; ++i)
         drawHLine(core, x, i, width, color);
 }
 
@@ -132,25 +165,72 @@ static void drawRectBorder(tic_core* core, s32 x, s32 y, s32 width, s32 height,
     drawVLine(core, x + width - 1, y, height, color);
 }
 
+// unpacks a whole tile through the palette mapping, one row of the sheet at a time
+#define TILE_PIXELS(BPP) do { \
+    enum { Mask = (1 << BPP) - 1 }; \
+    const u8* src = tile->ptr + (tile->offset * BPP >> 3); \
+    const s32 pitch = tile->segment->tile_width * BPP >> 3; \
+    for (s32 py = 0; py < TIC_SPRITESIZE; py++, src += pitch) \
+    { \
+        u32 row = 0; \
+        for (s32 i = 0; i < BPP; i++) row |= src[i] << (i * BITS_IN_BYTE); \
+        for (s32 px = 0; px < TIC_SPRITESIZE; px++, row >>= BPP) \
+            *pixels++ = mapping[row & Mask]; \
+    } \
+    } while(0)
+
+static void getTilePixels(const tic_tileptr* tile, const u8* mapping, u8* pixels)
+{
+    switch (tile->segment->bpp)
+    {
+    case 4: TILE_PIXELS(4); break;
+    case 2: TILE_PIXELS(2); break;
+    case 1: TILE_PIXELS(1); break;
+    }
+}
+
+#undef TILE_PIXELS
+
+// writes a clipped row of mapped pixels straight into the screen nibbles
+static inline void blitTileRow(u8* screen, s32 index, const u8* row, s32 count)
+{
+    u8* dst = screen + (index >> 1);
+
+    if (index & 1)
+    {
+        if (*row != TRANSPARENT_COLOR) *dst = (*dst & 0x0f) | (*row << 4);
+        dst++, row++, count--;
+    }
+
+    for (; count >= 2; count -= 2, row += 2, dst++)
+    {
+        u8 lo = row[0], hi = row[1];
+
+        if (lo != TRANSPARENT_COLOR)
+            *dst = hi != TRANSPARENT_COLOR ? lo | (hi << 4) : (*dst & 0xf0) | lo;
+        else if (hi != TRANSPARENT_COLOR)
+            *dst = (*dst & 0x0f) | (hi << 4);
+    }
+
+    if (count > 0 && *row != TRANSPARENT_COLOR)
+        *dst = (*dst & 0xf0) | *row;
+}
+
 #define DRAW_TILE_BODY(X, Y) do {\
     for(s32 py=sy; py < ey; py++, y++) \
     { \
-        s32 xx = x; \
-        for(s32 px=sx; px < ex; px++, xx++) \
-        { \
-            u8 color = mapping[tic_tilesheet_gettilepix(tile, (X), (Y))];\
-            if(color != TRANSPARENT_COLOR) setPixelFast(core, xx, y, color); \
-        } \
+        u8 row[TIC_SPRITESIZE]; \
+        for(s32 px=sx; px < ex; px++) \
+            row[px - sx] = pixels[(Y) * TIC_SPRITESIZE + (X)]; \
+        blitTileRow(screen, y * TIC80_WIDTH + x, row, ex - sx); \
     } \
     } while(0)
 
 #define REVERT(X) (TIC_SPRITESIZE - 1 - (X))
 
-static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors, s32 count, s32 scale, tic_flip flip, tic_rotate rotate)
+// draws a tile already unpacked through the palette mapping
+static void drawTilePixels(tic_core* core, const u8* pixels, s32 x, s32 y, s32 scale, tic_flip flip, tic_rotate rotate)
 {
-    const tic_vram* vram = &core->memory.ram->vram;
-    u8* mapping = getPalette(&core->memory, colors, count);
-
     rotate &= 3;
     u32 orientation = flip & 3;
 
@@ -166,8 +246,15 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
         sy = core->state.clip.t - y; if (sy < 0) sy = 0;
         ex = core->state.clip.r - x; if (ex > TIC_SPRITESIZE) ex = TIC_SPRITESIZE;
         ey = core->state.clip.b - y; if (ey > TIC_SPRITESIZE) ey = TIC_SPRITESIZE;
+
+        if (sx >= ex || sy >= ey) return;
+
+        // the clip rect never leaves the screen, so we can write to vram directly
+        u8* screen = core->memory.ram->vram.screen.data;
+
         y += sy;
         x += sx;
+        tic_core_dirty_rows(core, y, y + ey - sy);
         switch (orientation) {
         case 4: DRAW_TILE_BODY(py, px); break;
         case 6: DRAW_TILE_BODY(REVERT(py), px); break;
@@ -193,7 +280,7 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
             if (orientation & 4) {
                 s32 tmp = ix; ix = iy; iy = tmp;
             }
-            u8 color = mapping[tic_tilesheet_gettilepix(tile, ix, iy)];
+            u8 color = pixels[iy * TIC_SPRITESIZE + ix];
             if (color != TRANSPARENT_COLOR) drawRect(core, xx, y, scale, scale, color);
         }
     }
@@ -202,6 +289,15 @@ static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors
 #undef DRAW_TILE_BODY
 #undef REVERT
 
+static void drawTile(tic_core* core, tic_tileptr* tile, s32 x, s32 y, u8* colors, s32 count, s32 scale, tic_flip flip, tic_rotate rotate)
+{
+    if (EARLY_CLIP(x, y, TIC_SPRITESIZE * scale, TIC_SPRITESIZE * scale)) return;
+
+    u8 pixels[TIC_SPRITESIZE * TIC_SPRITESIZE];
+    getTilePixels(tile, getPalette(&core->memory, colors, count), pixels);
+    drawTilePixels(core, pixels, x, y, scale, flip, rotate);
+}
+
 static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8* colors, s32 count, s32 scale, tic_flip flip, tic_rotate rotate)
 {
     const tic_vram* vram = &core->memory.ram->vram;
@@ -265,32 +361,160 @@ static void drawSprite(tic_core* core, s32 index, s32 x, s32 y, s32 w, s32 h, u8
     }
 }
 
+static inline s32 floorDiv(s32 a, s32 b)
+{
+    return a / b - (a % b < 0);
+}
+
+static inline s32 wrapCoord(s32 value, s32 size)
+{
+    value %= size;
+    return value < 0 ? value + size : value;
+}
+
+static void remapTable(void* data, s32 x, s32 y, RemapResult* result)
+{
+    const u8* entry = (const u8*)data + result->index * 2;
+
+    result->index = entry[0];
+    result->flip = entry[1] & 3;
+    result->rotate = entry[1] >> 2 & 3;
+}
+
 static void drawMap(tic_core* core, const tic_map* src, s32 x, s32 y, s32 width, s32 height, s32 sx, s32 sy, u8* colors, s32 count, s32 scale, RemapFunc remap, void* data)
 {
+    enum { Empty = 1, Solid };
+
     const s32 size = TIC_SPRITESIZE * scale;
 
+    // only the cells touching the clip rect are drawn
+    s32 left = 0, top = 0, right = 0, bottom = 0;
+
+    if (size > 0)
+    {
+        left = MAX(0, floorDiv(core->state.clip.l - sx, size));
+        top = MAX(0, floorDiv(core->state.clip.t - sy, size));
+        right = MIN(width, floorDiv(core->state.clip.r - sx + size - 1, size));
+        bottom = MIN(height, floorDiv(core->state.clip.b - sy + size - 1, size));
+    }
+
+    // a script remap can change anything between the cells, tiles are unpacked
+    // once per call only when remapping is done by the core
+    bool cached = !remap || remap == remapTable;
+
+    // a script remap still sees every cell, carts use it to spawn objects from the map
+    s32 fromX = cached ? left : 0, toX = cached ? right : width;
+    s32 fromY = cached ? top : 0, toY = cached ? bottom : height;
+
+    if (fromX >= toX || fromY >= toY)
+        return;
+
     tic_tilesheet sheet = getTileSheetFromSegment(&core->memory, core->memory.ram->vram.blit.segment);
 
-    for (s32 j = y, jj = sy; j < y + height; j++, jj += size)
-        for (s32 i = x, ii = sx; i < x + width; i++, ii += size)
-        {
-            s32 mi = i;
-            s32 mj = j;
+    u8* mapping = getPalette(&core->memory, colors, count);
+    u8* state = core->draw.tiles.state;
 
-            while (mi < 0) mi += TIC_MAP_WIDTH;
-            while (mj < 0) mj += TIC_MAP_HEIGHT;
-            while (mi >= TIC_MAP_WIDTH) mi -= TIC_MAP_WIDTH;
-            while (mj >= TIC_MAP_HEIGHT) mj -= TIC_MAP_HEIGHT;
+    if (cached)
+        memset(state, 0, sizeof core->draw.tiles.state);
 
-            s32 index = mi + mj * TIC_MAP_WIDTH;
-            RemapResult retile = { *(src->data + index), tic_no_flip, tic_no_rotate };
+    for (s32 j = fromY, jj = sy + fromY * size; j < toY; j++, jj += size)
+    {
+        s32 mj = wrapCoord(y + j, TIC_MAP_HEIGHT);
+        const u8* row = src->data + mj * TIC_MAP_WIDTH;
+
+        for (s32 i = fromX, ii = sx + fromX * size, mi = wrapCoord(x + fromX, TIC_MAP_WIDTH); i < toX; i++, ii += size)
+        {
+            RemapResult retile = { row[mi], tic_no_flip, tic_no_rotate };
 
             if (remap)
                 remap(data, mi, mj, &retile);
 
+            if (++mi == TIC_MAP_WIDTH)
+                mi = 0;
+
+            if (i < left || i >= right || j < top || j >= bottom)
+                continue;
+
             tic_tileptr tile = tic_tilesheet_gettile(&sheet, retile.index, true);
-            drawTile(core, &tile, ii, jj, colors, count, scale, retile.flip, retile.rotate);
+
+            if (cached)
+            {
+                u8* pixels = core->draw.tiles.pixels[retile.index];
+
+                if (!state[retile.index])
+                {
+                    getTilePixels(&tile, mapping, pixels);
+
+                    state[retile.index] = Empty;
+                    for (s32 p = 0; p < TIC_SPRITESIZE * TIC_SPRITESIZE; p++)
+                        if (pixels[p] != TRANSPARENT_COLOR)
+                        {
+                            state[retile.index] = Solid;
+                            break;
+                        }
+                }
+
+                if (state[retile.index] == Solid)
+                    drawTilePixels(core, pixels, ii, jj, scale, retile.flip, retile.rotate);
+            }
+            else drawTile(core, &tile, ii, jj, colors, count, scale, retile.flip, retile.rotate);
         }
+    }
+}
+
+// sprites are drawn in table order since they can overlap, repeated ones come from the tile cache
+static void drawSprites(tic_core* core, const u8* records, s32 count)
+{
+    enum { Empty = 1, Solid, NoColorkey = TIC_PALETTE_SIZE };
+
+    tic_tilesheet sheet = getTileSheetFromSegment(&core->memory, core->memory.ram->vram.blit.segment);
+    u8* state = core->draw.tiles.state;
+    u32* key = core->draw.tiles.key;
+    u8* mapping = NULL;
+    s32 colorkey = -1;
+
+    memset(state, 0, sizeof core->draw.tiles.state);
+
+    for (s32 i = 0; i < count; i++, records += TIC_SPRITE_RECORD_SIZE)
+    {
+        const u8* r = records;
+
+        s32 index = r[0] | r[1] << 8;
+        s32 x = (s16)(r[2] | r[3] << 8);
+        s32 y = (s16)(r[4] | r[5] << 8);
+        s32 scale = r[6] >> 4 ? r[6] >> 4 : 1;
+
+        if (EARLY_CLIP(x, y, TIC_SPRITESIZE * scale, TIC_SPRITESIZE * scale))
+            continue;
+
+        if (colorkey != MIN(r[7], NoColorkey))
+        {
+            colorkey = MIN(r[7], NoColorkey);
+            mapping = getPalette(&core->memory, (u8[]){colorkey}, colorkey == NoColorkey ? 0 : 1);
+        }
+
+        s32 slot = index & (TIC_BANK_SPRITES - 1);
+        u32 tag = index << BITS_IN_BYTE | colorkey;
+        u8* pixels = core->draw.tiles.pixels[slot];
+
+        if (!state[slot] || key[slot] != tag)
+        {
+            tic_tileptr tile = tic_tilesheet_gettile(&sheet, index, false);
+            getTilePixels(&tile, mapping, pixels);
+
+            key[slot] = tag;
+            state[slot] = Empty;
+            for (s32 p = 0; p < TIC_SPRITESIZE * TIC_SPRITESIZE; p++)
+                if (pixels[p] != TRANSPARENT_COLOR)
+                {
+                    state[slot] = Solid;
+                    break;
+                }
+        }
+
+        if (state[slot] == Solid)
+            drawTilePixels(core, pixels, x, y, scale, r[6] & 3, r[6] >> 2 & 3);
+    }
 }
 
 static s32 drawChar(tic_core* core, tic_tileptr* font_char, s32 x, s32 y, s32 scale, bool fixed, u8* mapping)
@@ -331,6 +555,60 @@ static s32 drawChar(tic_core* core, tic_tileptr* font_char, s32 x, s32 y, s32 sc
     return width;
 }
 
+// print() glyphs are 1bpp, one byte per row, so a row is drawn as runs of set bits;
+// anything can write font ram (even wasm memory) and the rows are compared to revalidate the bounds
+static s32 drawGlyph(tic_core* core, s32 index, s32 x, s32 y, s32 scale, bool fixed, u8 color)
+{
+    enum { Size = TIC_SPRITESIZE };
+
+    const u8* bits = (const u8*)&core->memory.ram->font + index * Size;
+
+    u64 rows;
+    memcpy(&rows, bits, sizeof rows);
+
+    if (core->draw.glyphs.rows[index] != rows)
+    {
+        u8 mask = 0;
+        for (s32 i = 0; i < Size; i++)
+            mask |= bits[i];
+
+        // an empty glyph has no width, like drawChar() measures it
+        s32 start = 0, end = 0;
+        if (mask)
+        {
+            end = Size;
+            while (!(mask & 1 << start)) start++;
+            while (!(mask & 1 << (end - 1))) end--;
+        }
+
+        core->draw.glyphs.rows[index] = rows;
+        core->draw.glyphs.start[index] = start;
+        core->draw.glyphs.width[index] = end - start;
+    }
+
+    s32 start = fixed ? 0 : core->draw.glyphs.start[index];
+    s32 width = fixed ? Size : core->draw.glyphs.width[index];
+
+    if (color == TRANSPARENT_COLOR) return fixed ? width : 0;
+    if (EARLY_CLIP(x, y, Size * scale, Size * scale)) return width;
+
+    for (s32 j = 0, ys = y; j < Size; j++, ys += scale)
+    {
+        for (s32 row = bits[j] >> start, i = 0; row;)
+        {
+            while (!(row & 1)) row >>= 1, i++;
+
+            s32 from = i;
+            while (row & 1) row >>= 1, i++;
+
+            drawRect(core, x + from * scale, ys, (i - from) * scale, scale, color);
+        }
+    }
+
+    return width;
+}
+
+// without a font face it's print(), drawing font ram glyphs in mapping[1]
 static s32 drawText(tic_core* core, tic_tilesheet* font_face, const char* text, s32 x, s32 y, s32 width, s32 height, bool fixed, u8* mapping, s32 scale, bool alt)
 {
     s32 pos = x;
@@ -347,11 +625,17 @@ static s32 drawText(tic_core* core, tic_tilesheet* font_face, const char* text,
             pos = x;
             y += height * scale;
         }
-        else {
+        else if (font_face)
+        {
             tic_tileptr font_char = tic_tilesheet_gettile(font_face, alt * TIC_FONT_CHARS + sym, true);
             s32 size = drawChar(core, &font_char, pos, y, scale, fixed, mapping);
             pos += ((!fixed && size) ? size + 1 : width) * scale;
         }
+        else
+        {
+            s32 size = drawGlyph(core, (alt * TIC_FONT_CHARS + sym) & 0xff, pos, y, scale, fixed, mapping[1]);
+            pos += ((!fixed && size) ? size + 1 : width) * scale;
+        }
     }
 
     return pos > MAX ? pos - x : MAX - x;
@@ -361,6 +645,7 @@ void tic_api_clip(tic_mem* memory, s32 x, s32 y, s32 width, s32 height)
 {
     tic_core* core = (tic_core*)memory;
     tic_vram* vram = &memory->ram->vram;
+    u64 start = tic_core_api_enter(core);
 
     core->state.clip.l = x;
     core->state.clip.t = y;
@@ -371,22 +656,33 @@ void tic_api_clip(tic_mem* memory, s32 x, s32 y, s32 width, s32 height)
     if (core->state.clip.t < 0) core->state.clip.t = 0;
     if (core->state.clip.r > TIC80_WIDTH) core->state.clip.r = TIC80_WIDTH;
     if (core->state.clip.b > TIC80_HEIGHT) core->state.clip.b = TIC80_HEIGHT;
+
+    tic_core_api_leave(core, tic_api_id_clip, start, 0);
 }
 
 void tic_api_rect(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, u8 color)
 {
     tic_core* core = (tic_core*)memory;
 
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     drawRect(core, x, y, width, height, mapColor(memory, color));
-}
 
-static double ZBuffer[TIC80_WIDTH * TIC80_HEIGHT];
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_rect, start, (u64)MAX(width, 0) * MAX(height, 0));
+}
 
 void tic_api_cls(tic_mem* tic, u8 color)
 {
     tic_core* core = (tic_core*)tic;
     tic_vram* vram = &tic->ram->vram;
 
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     static const struct ClipRect EmptyClip = { 0, 0, TIC80_WIDTH, TIC80_HEIGHT };
 
     color = mapColor(tic, color);
@@ -394,21 +690,37 @@ void tic_api_cls(tic_mem* tic, u8 color)
     if (MEMCMP(core->state.clip, EmptyClip))
     {
         memset(&vram->screen, (color & 0xf) | (color << TIC_PALETTE_BPP), sizeof(tic_screen));
-        ZEROMEM(ZBuffer);
+        ZEROMEM(core->draw.zbuffer);
+        tic_core_dirty_rows(core, 0, TIC80_HEIGHT);
     }
     else
     {
-        for(s32 y = core->state.clip.t, start = y * TIC80_WIDTH; y < core->state.clip.b; ++y, start += TIC80_WIDTH)
-            for(s32 x = core->state.clip.l, pixel = start + x; x < core->state.clip.r; ++x, ++pixel)
+        s32 width = core->state.clip.r - core->state.clip.l;
+
+        if (width > 0)
+        {
+            tic_core_dirty_rows(core, core->state.clip.t, core->state.clip.b);
+
+            for(s32 y = core->state.clip.t, pixel = y * TIC80_WIDTH + core->state.clip.l; y < core->state.clip.b; ++y, pixel += TIC80_WIDTH)
             {
-                tic_api_poke4(tic, pixel, color);
-                ZBuffer[pixel] = 0;
+                fillSpan(vram->screen.data, pixel, width, color);
+                memset(core->draw.zbuffer + pixel, 0, width * sizeof core->draw.zbuffer[0]);
             }
+        }
     }
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_cls, start, (u64)MAX(core->state.clip.r - core->state.clip.l, 0) * MAX(core->state.clip.b - core->state.clip.t, 0));
 }
 
 s32 tic_api_font(tic_mem* memory, const char* text, s32 x, s32 y, u8* trans_colors, u8 trans_count, s32 w, s32 h, bool fixed, s32 scale, bool alt)
 {
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     u8* mapping = getPalette(memory, trans_colors, trans_count);
 
     // Compatibility : flip top and bottom of the spritesheet
@@ -417,92 +729,178 @@ s32 tic_api_font(tic_mem* memory, const char* text, s32 x, s32 y, u8* trans_colo
     u8 flipmask = 1; while (segment >>= 1) flipmask <<= 1;
 
     tic_tilesheet font_face = getTileSheetFromSegment(memory, memory->ram->vram.blit.segment ^ flipmask);
-    return drawText((tic_core*)memory, &font_face, text, x, y, w, h, fixed, mapping, scale, alt);
+    s32 width = drawText(core, &font_face, text, x, y, w, h, fixed, mapping, scale, alt);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_font, start, (u64)MAX(width, 0) * h * scale);
+    return width;
 }
 
 s32 tic_api_print(tic_mem* memory, const char* text, s32 x, s32 y, u8 color, bool fixed, s32 scale, bool alt)
 {
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     u8 mapping[] = { 255, color };
-    tic_tilesheet font_face = getTileSheetFromSegment(memory, 1);
 
     const tic_font_data* font = alt ? &memory->ram->font.alt : &memory->ram->font.regular;
     s32 width = font->width;
 
     // Compatibility : print uses reduced width for non-fixed space
     if (!fixed) width -= 2;
-    return drawText((tic_core*)memory, &font_face, text, x, y, width, font->height, fixed, mapping, scale, alt);
+    width = drawText(core, NULL, text, x, y, width, font->height, fixed, mapping, scale, alt);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_print, start, (u64)MAX(width, 0) * font->height * scale);
+    return width;
 }
 
 void tic_api_spr(tic_mem* memory, s32 index, s32 x, s32 y, s32 w, s32 h, u8* trans_colors, u8 trans_count, s32 scale, tic_flip flip, tic_rotate rotate)
 {
-    drawSprite((tic_core*)memory, index, x, y, w, h, trans_colors, trans_count, scale, flip, rotate);
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    drawSprite(core, index, x, y, w, h, trans_colors, trans_count, scale, flip, rotate);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_spr, start, (u64)MAX(w, 0) * MAX(h, 0) * scale * scale * TIC_SPRITESIZE * TIC_SPRITESIZE);
+}
+
+void tic_api_sprs(tic_mem* memory, s32 address, s32 count)
+{
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    // only whole records inside ram are drawn
+    count = address >= 0 && address < sizeof(tic_ram)
+        ? MIN(count, (s32)(sizeof(tic_ram) - address) / TIC_SPRITE_RECORD_SIZE)
+        : 0;
+
+    if (count > 0)
+        drawSprites(core, memory->ram->data + address, count);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_sprs, start, (u64)MAX(count, 0) * TIC_SPRITESIZE * TIC_SPRITESIZE);
 }
 
 static inline u8* getFlag(tic_mem* memory, s32 index, u8 flag)
 {
-    static u8 stub = 0;
-    if (index >= TIC_FLAGS || flag >= BITS_IN_BYTE)
-        return &stub;
+    if (index < 0 || index >= TIC_FLAGS || flag >= BITS_IN_BYTE)
+        return NULL;
 
     return memory->ram->flags.data + index;
 }
 
 bool tic_api_fget(tic_mem* memory, s32 index, u8 flag)
 {
-    return *getFlag(memory, index, flag) & (1 << flag);
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+
+    u8* flags = getFlag(memory, index, flag);
+    bool value = flags && (*flags & (1 << flag));
+
+    tic_core_api_leave(core, tic_api_id_fget, start, 0);
+    return value;
 }
 
 void tic_api_fset(tic_mem* memory, s32 index, u8 flag, bool value)
 {
-    if (value)
-        *getFlag(memory, index, flag) |= (1 << flag);
-    else
-        *getFlag(memory, index, flag) &= ~(1 << flag);
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+
+    u8* flags = getFlag(memory, index, flag);
+
+    if (flags)
+    {
+        if (value)
+            *flags |= (1 << flag);
+        else
+            *flags &= ~(1 << flag);
+    }
+
+    tic_core_api_leave(core, tic_api_id_fset, start, 0);
 }
 
 u8 tic_api_pix(tic_mem* memory, s32 x, s32 y, u8 color, bool get)
 {
     tic_core* core = (tic_core*)memory;
 
-    if (get) return getPixel(core, x, y);
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    u8 value = 0;
 
-    setPixel(core, x, y, mapColor(memory, color));
-    return 0;
+    if (get) value = getPixel(core, x, y);
+    else
+    {
+        s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+        setPixel(core, x, y, mapColor(memory, color));
+        tic_core_perf_pop(core, phase);
+    }
+
+    tic_core_api_leave(core, tic_api_id_pix, start, 1);
+    return value;
 }
 
 void tic_api_rectb(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, u8 color)
 {
     tic_core* core = (tic_core*)memory;
 
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     drawRectBorder(core, x, y, width, height, mapColor(memory, color));
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_rectb, start, (u64)MAX(width, 0) * MAX(height, 0));
 }
 
-static struct
+typedef struct
 {
-    s16 Left[TIC80_HEIGHT];
-    s16 Right[TIC80_HEIGHT];
-} SidesBuffer;
+    s32 y, l, r;
+} EllipseRow;
 
-static void initSidesBuffer()
+static void drawEllipseRow(tic_core* core, const EllipseRow* row, u8 color)
 {
-    for (s32 i = 0; i < COUNT_OF(SidesBuffer.Left); i++)
-        SidesBuffer.Left[i] = TIC80_WIDTH, SidesBuffer.Right[i] = -1;
+    if (row->l <= row->r)
+        drawHLine(core, row->l, row->y, row->r - row->l + 1, color);
 }
 
-static void setSidePixel(s32 x, s32 y)
+// the outline visits rows in order, so a row is widened until the outline leaves it and then filled
+static inline void traceEllipseRow(tic_core* core, EllipseRow* row, s32 y, s32 l, s32 r, u8 color)
 {
-    if (y >= 0 && y < TIC80_HEIGHT)
+    if (row->y == y)
+    {
+        row->l = MIN(row->l, l);
+        row->r = MAX(row->r, r);
+    }
+    else
     {
-        if (x < SidesBuffer.Left[y]) SidesBuffer.Left[y] = x;
-        if (x > SidesBuffer.Right[y]) SidesBuffer.Right[y] = x;
+        drawEllipseRow(core, row, color);
+        *row = (EllipseRow){y, l, r};
     }
 }
 
-static void drawEllipse(tic_mem* memory, s32 x0, s32 y0, s32 x1, s32 y1, u8 color, PixelFunc pix)
+static void drawEllipse(tic_core* core, s32 x0, s32 y0, s32 x1, s32 y1, u8 color, bool fill)
 {
     if(x0 > x1 || y0 > y1)
         return;
 
+    if (EARLY_CLIP(x0 - 1, y0 - 1, x1 - x0 + 3, y1 - y0 + 3))
+        return;
+
+    // the lower and the upper half rows being filled
+    EllipseRow lower = {y0 - 1, 0, -1}, upper = lower;
+
     s64 a = abs(x1 - x0), b = abs(y1 - y0), b1 = b & 1; /* values of diameter */
     s64 dx = 4 * (1 - a) * b * b, dy = 4 * (b1 + 1) * a * a; /* error increment */
     s64 err = dx + dy + b1 * a * a, e2; /* error of 1.step */
@@ -514,10 +912,18 @@ static void drawEllipse(tic_mem* memory, s32 x0, s32 y0, s32 x1, s32 y1, u8 colo
 
     do 
     {
-        pix(memory, x1, y0, color); /*   I. Quadrant */
-        pix(memory, x0, y0, color); /*  II. Quadrant */
-        pix(memory, x0, y1, color); /* III. Quadrant */
-        pix(memory, x1, y1, color); /*  IV. Quadrant */
+        if (fill)
+        {
+            traceEllipseRow(core, &lower, y0, x0, x1, color);
+            traceEllipseRow(core, &upper, y1, x0, x1, color);
+        }
+        else
+        {
+            setPixel(core, x1, y0, color); /*   I. Quadrant */
+            setPixel(core, x0, y0, color); /*  II. Quadrant */
+            setPixel(core, x0, y1, color); /* III. Quadrant */
+            setPixel(core, x1, y1, color); /*  IV. Quadrant */
+        }
         e2 = 2 * err;
         if (e2 <= dy) { y0++; y1--; err += dy += a; }  /* y step */ 
         if (e2 >= dx || 2 * err > dy) { x0++; x1--; err += dx += b1; } /* x step */
@@ -525,92 +931,169 @@ static void drawEllipse(tic_mem* memory, s32 x0, s32 y0, s32 x1, s32 y1, u8 colo
 
     while (y0-y1 < b) 
     {  /* too early stop of flat ellipses a=1 */
-        pix(memory, x0 - 1, y0,    color); /* -> finish tip of ellipse */
-        pix(memory, x1 + 1, y0++,  color); 
-        pix(memory, x0 - 1, y1,    color);
-        pix(memory, x1 + 1, y1--,  color); 
+        if (fill)
+        {
+            traceEllipseRow(core, &lower, y0++, x0 - 1, x1 + 1, color);
+            traceEllipseRow(core, &upper, y1--, x0 - 1, x1 + 1, color);
+        }
+        else
+        {
+            setPixel(core, x0 - 1, y0,    color); /* -> finish tip of ellipse */
+            setPixel(core, x1 + 1, y0++,  color); 
+            setPixel(core, x0 - 1, y1,    color);
+            setPixel(core, x1 + 1, y1--,  color); 
+        }
     }
-}
 
-static void setElliPixel(tic_mem* tic, s32 x, s32 y, u8 color)
-{
-    setPixel((tic_core*)tic, x, y, color);
+    drawEllipseRow(core, &lower, color);
+    drawEllipseRow(core, &upper, color);
 }
 
-static void setElliSide(tic_mem* tic, s32 x, s32 y, u8 color)
+void tic_api_circ(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
 {
-    setSidePixel(x, y);
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    drawEllipse(core, x - r, y - r, x + r, y + r, mapColor(memory, color), true);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_circ, start, (2 * (u64)MAX(r, 0) + 1) * (2 * (u64)MAX(r, 0) + 1));
 }
 
-static void drawSidesBuffer(tic_mem* memory, s32 y0, s32 y1, u8 color)
+void tic_api_circb(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
 {
-    tic_vram* vram = &memory->ram->vram;
-
     tic_core* core = (tic_core*)memory;
-    s32 yt = MAX(core->state.clip.t, y0);
-    s32 yb = MIN(core->state.clip.b, y1 + 1);
-    u8 final_color = mapColor(&core->memory, color);
-    for (s32 y = yt; y < yb; y++) 
-    {
-        s32 xl = MAX(SidesBuffer.Left[y], core->state.clip.l);
-        s32 xr = MIN(SidesBuffer.Right[y] + 1, core->state.clip.r);
-        s32 start = y * TIC80_WIDTH;
 
-        for(s32 i = start + xl, end = start + xr; i < end; ++i)
-            tic_api_poke4(memory, i, color);
-    }
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    drawEllipse(core, x - r, y - r, x + r, y + r, mapColor(memory, color), false);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_circb, start, (2 * (u64)MAX(r, 0) + 1) * (2 * (u64)MAX(r, 0) + 1));
 }
 
-void tic_api_circ(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
+void tic_api_elli(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
 {
-    initSidesBuffer();
-    drawEllipse(memory, x - r, y - r, x + r, y + r, 0, setElliSide);
-    drawSidesBuffer(memory, y - r, y + r + 1, mapColor(memory, color));
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    drawEllipse(core, x - a, y - b, x + a, y + b, mapColor(memory, color), true);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_elli, start, (2 * (u64)MAX(a, 0) + 1) * (2 * (u64)MAX(b, 0) + 1));
 }
 
-void tic_api_circb(tic_mem* memory, s32 x, s32 y, s32 r, u8 color)
+void tic_api_ellib(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
 {
-    drawEllipse(memory, x - r, y - r, x + r, y + r, mapColor(memory, color), setElliPixel);
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    drawEllipse(core, x - a, y - b, x + a, y + b, mapColor(memory, color), false);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_ellib, start, (2 * (u64)MAX(a, 0) + 1) * (2 * (u64)MAX(b, 0) + 1));
 }
 
-void tic_api_elli(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
+enum
+{
+    OutLeft     = 1 << 0,
+    OutRight    = 1 << 1,
+    OutTop      = 1 << 2,
+    OutBottom   = 1 << 3,
+};
+
+// Cohen-Sutherland outcode against the clip rect, coordinates in (-1, 0) still truncate to pixel 0
+static s32 outCode(const tic_core* core, double x, double y)
 {
-    initSidesBuffer();
-    drawEllipse(memory, x - a, y - b, x + a, y + b, 0, setElliSide);
-    drawSidesBuffer(memory, y - b, y + b + 1, mapColor(memory, color));
+    return (x <= core->state.clip.l - 1 ? OutLeft : 0)
+        | (x >= core->state.clip.r ? OutRight : 0)
+        | (y <= core->state.clip.t - 1 ? OutTop : 0)
+        | (y >= core->state.clip.b ? OutBottom : 0);
 }
 
-void tic_api_ellib(tic_mem* memory, s32 x, s32 y, s32 a, s32 b, u8 color)
+// 32.32 fixed point to pixel, truncated toward zero like a float to int conversion,
+// the bias keeps exact integers from landing a rounding error below themselves
+static inline s32 linePixel(s64 value)
 {
-    drawEllipse(memory, x - a, y - b, x + a, y + b, mapColor(memory, color), setElliPixel);
+    enum { Bias = 1 << 12 };
+    return (s32)(value >= 0 ? (value + Bias) >> 32 : -((Bias - value) >> 32));
 }
 
-static inline float initLine(float *x0, float *x1, float *y0, float *y1)
+// steps every pixel of the major axis from the lower end, the range is clipped up front
+static void drawLine(tic_core* core, float x0, float y0, float x1, float y1, u8 color)
 {
-    if (*y0 > *y1)
+    if (outCode(core, x0, y0) & outCode(core, x1, y1))
+        return;
+
+    const bool steep = fabsf(x0 - x1) < fabsf(y0 - y1);
+
+    if ((steep ? y0 : x0) > (steep ? y1 : x1))
     {
-        SWAP(*x0, *x1, float);
-        SWAP(*y0, *y1, float);
+        SWAP(x0, x1, float);
+        SWAP(y0, y1, float);
     }
 
-    float t = (*x1 - *x0) / (*y1 - *y0);
+    // the far end is always drawn, even when the steps stop short of it
+    setPixel(core, (s32)x1, (s32)y1, color);
 
-    if(*y0 < 0) *x0 -= *y0 * t, *y0 = 0;
-    if(*y1 > TIC80_WIDTH) *x1 += (TIC80_WIDTH - *y0) * t, *y1 = TIC80_WIDTH;
+    double m0 = steep ? y0 : x0, m1 = steep ? y1 : x1;
+    double n0 = steep ? x0 : y0, n1 = steep ? x1 : y1;
 
-    return t;
-}
+    const struct ClipRect* clip = &core->state.clip;
 
-static void drawLine(tic_mem* tic, float x0, float y0, float x1, float y1, u8 color)
-{
-    if(fabs(x0 - x1) < fabs(y0 - y1))
-        for (float t = initLine(&x0, &x1, &y0, &y1); y0 < y1; y0++, x0 += t)
-            setPixel((tic_core*)tic, x0, y0, color);
+    double t = (n1 - n0) / (m1 - m0);
+    if (m0 < 0) n0 -= m0 * t, m0 = 0;
+
+    double first = MAX(0, ceil((steep ? clip->t : clip->l) - m0));
+    double last = ceil(MIN(m1, steep ? clip->b : clip->r) - m0);
+    if (!(first < last))
+        return;
+
+    // |t| <= 1, so a start that far away never gets back on the screen
+    double start = n0 + first * t;
+    if (!(fabs(start) < 1 << 20))
+        return;
+
+    enum { One = 1ll << 32 };
+    s64 n = llround(start * One), dn = llround(t * One);
+    s32 from = (s32)m0 + (s32)first, to = (s32)m0 + (s32)last;
+    u8* screen = core->memory.ram->vram.screen.data;
+
+    if (steep)
+    {
+        for (s32 y = from; y < to; y++, n += dn)
+        {
+            s32 x = linePixel(n);
+            if (x >= clip->l && x < clip->r)
+                tic_tool_poke4(screen, y * TIC80_WIDTH + x, color);
+        }
+
+        tic_core_dirty_rows(core, from, to);
+    }
     else
-        for (float t = initLine(&y0, &y1, &x0, &x1); x0 < x1; x0++, y0 += t)
-            setPixel((tic_core*)tic, x0, y0, color);
+    {
+        s32 top = linePixel(n), bottom = linePixel(n + (to - from - 1) * dn);
 
-    setPixel((tic_core*)tic, x1, y1, color);
+        for (s32 x = from; x < to; x++, n += dn)
+        {
+            s32 y = linePixel(n);
+            if (y >= clip->t && y < clip->b)
+                tic_tool_poke4(screen, y * TIC80_WIDTH + x, color);
+        }
+
+        tic_core_dirty_rows(core, MIN(top, bottom), MAX(top, bottom) + 1);
+    }
 }
 
 typedef union
@@ -635,47 +1118,186 @@ typedef union
 
 typedef struct 
 {
+    tic_core* core;
     void* data;
     const Vec2* v[3];
+
+    // barycentric weights at the first pixel of the row and their step along it
+    Vec3 row, dw;
+
+    // weights accumulated pixel by pixel up to the pixel k of the row
     Vec3 w;
+    s32 k;
 } ShaderAttr;
 
-typedef tic_color(*PixelShader)(const ShaderAttr* a, s32 pixel);
+// draws covered pixels [from, to) of the row starting at the screen index pixel
+typedef void(*SpanShader)(ShaderAttr* a, s32 pixel, s32 from, s32 to);
 
 static inline double edgeFn(const Vec2* a, const Vec2* b, const Vec2* c)
 {
     return (b->x - a->x) * (c->y - a->y) - (b->y - a->y) * (c->x - a->x);
 }
 
-static void drawTri(tic_mem* tic, const Vec2* v0, const Vec2* v1, const Vec2* v2, PixelShader shader, void* data)
+// first pixel in [0, count] where the edge enters (dw > 0) or leaves (dw < 0) the w > limit half-plane,
+// starts from the solved crossing and steps to the exact one, w + k * dw is monotonic in k
+static s32 edgeCross(double w, double dw, double inv, double limit, s32 count)
 {
-    ShaderAttr a = {data, v0, v1, v2};
+    const bool enter = dw > 0;
+    double e = (limit - w) * inv;
+    s32 k = e > -1 ? e < count ? (s32)e : count : 0;
 
-    tic_core* core = (tic_core*)tic;
-    const struct ClipRect* clip = &core->state.clip;
+    while(k > 0 && (w + (k - 1) * dw > limit) == enter) --k;
+    while(k < count && (w + k * dw > limit) != enter) ++k;
+
+    return k;
+}
+
+static inline void edgeRange(double w, double dw, double inv, double limit, s32 count, s32* from, s32* to)
+{
+    if(dw > 0) *from = MAX(*from, edgeCross(w, dw, inv, limit, count));
+    else if(dw < 0) *to = MIN(*to, edgeCross(w, dw, inv, limit, count));
+    else if(!(w > limit)) *to = 0;
+}
+
+// the weights are summed pixel after pixel, so every shaded value rounds exactly as it always did
+static inline void shaderWalk(ShaderAttr* a, s32 k)
+{
+    for(; a->k < k; a->k++)
+        for(s32 i = 0; i != COUNT_OF(a->w.d); ++i)
+            a->w.d[i] += a->dw.d[i];
+}
+
+// the coverage test compares the accumulated weights against -DBL_EPSILON, samples lying on
+// an edge are decided by that rounding, so only those are walked to, the rest are decided directly
+static bool triPixelCovered(ShaderAttr* a, const Vec3* tol, s32 k)
+{
+    for(s32 i = 0; i != COUNT_OF(a->w.d); ++i)
+    {
+        double w = a->row.d[i] + k * a->dw.d[i];
+
+        if(w > -DBL_EPSILON + tol->d[i]) continue;
+        if(w <= -DBL_EPSILON - tol->d[i]) return false;
 
-    tic_point min = {floor(MIN3(a.v[0]->x, a.v[1]->x, a.v[2]->x)), floor(MIN3(a.v[0]->y, a.v[1]->y, a.v[2]->y))};
-    tic_point max = {ceil(MAX3(a.v[0]->x, a.v[1]->x, a.v[2]->x)), ceil(MAX3(a.v[0]->y, a.v[1]->y, a.v[2]->y))};
+        shaderWalk(a, k);
+
+        if(a->w.d[i] <= -DBL_EPSILON) return false;
+    }
+
+    return true;
+}
+
+static void drawTriRow(ShaderAttr* a, const Vec3* inv, s32 pixel, s32 count, SpanShader shader)
+{
+    a->w = a->row;
+    a->k = 0;
+
+    // short rows are cheaper to test pixel by pixel than to solve
+    enum { SolveRow = 16 };
+
+    if(count <= SolveRow)
+    {
+        Vec3 w = a->row;
+        s32 run = 0;
+
+        for(s32 k = 0; k < count; ++k)
+        {
+            if(!(w.x > -DBL_EPSILON && w.y > -DBL_EPSILON && w.z > -DBL_EPSILON))
+            {
+                if(run < k)
+                    shader(a, pixel, run, k);
+
+                run = k + 1;
+            }
+
+            for(s32 i = 0; i != COUNT_OF(w.d); ++i)
+                w.d[i] += a->dw.d[i];
+        }
+
+        if(run < count)
+            shader(a, pixel, run, count);
+
+        return;
+    }
+
+    s32 from = 0, to = count, inFrom = 0, inTo = count;
+    Vec3 tol;
+
+    for(s32 i = 0; i != COUNT_OF(a->w.d); ++i)
+    {
+        double w = a->row.d[i], dw = a->dw.d[i];
+
+        // bounds the drift between w + k * dw and the same value accumulated k times
+        tol.d[i] = (fabs(w) + count * fabs(dw)) * (count + 4) * DBL_EPSILON;
+
+        edgeRange(w, dw, inv->d[i], -DBL_EPSILON - tol.d[i], count, &from, &to);
+        edgeRange(w, dw, inv->d[i], -DBL_EPSILON + tol.d[i], count, &inFrom, &inTo);
+    }
+
+    if(from >= to) return;
+
+    if(inFrom >= inTo)
+        inFrom = inTo = to;
+
+    // the shader walks its own copy, runs are shaded after the pixels past them are tested
+    ShaderAttr edge = *a;
+    s32 run = from;
+
+    // only the pixels between the surely outside and surely inside crossings are tested one by one
+    for(s32 k = from; k < to; ++k)
+    {
+        if(k == inFrom)
+        {
+            k = inTo - 1;
+            continue;
+        }
+
+        if(!triPixelCovered(&edge, &tol, k))
+        {
+            if(run < k)
+                shader(a, pixel, run, k);
+
+            run = k + 1;
+        }
+    }
+
+    if(run < to)
+        shader(a, pixel, run, to);
+}
+
+typedef struct
+{
+    // clipped bounding box
+    tic_point min, max;
+
+    // weights at the top left pixel of the box and their steps
+    Vec3 s, dx, dy, inv;
+} TriEdges;
+
+// v[1] and v[2] are swapped to wind the triangle clockwise
+static bool initTri(const struct ClipRect* clip, const Vec2* v[3], TriEdges* e)
+{
+    tic_point min = {floor(MIN3(v[0]->x, v[1]->x, v[2]->x)), floor(MIN3(v[0]->y, v[1]->y, v[2]->y))};
+    tic_point max = {ceil(MAX3(v[0]->x, v[1]->x, v[2]->x)), ceil(MAX3(v[0]->y, v[1]->y, v[2]->y))};
 
     min.x = MAX(min.x, clip->l);
     min.y = MAX(min.y, clip->t);
     max.x = MIN(max.x, clip->r);
     max.y = MIN(max.y, clip->b);
 
-    if(min.x >= max.x || min.y >= max.y) return;
+    if(min.x >= max.x || min.y >= max.y) return false;
 
-    double area = edgeFn(a.v[0], a.v[1], a.v[2]);
-    if((s32)floor(area) == 0) return;
+    double area = edgeFn(v[0], v[1], v[2]);
+    if((s32)floor(area) == 0) return false;
     if(area < 0.0)
     {
-        SWAP(a.v[1], a.v[2], const Vec2*);
+        SWAP(v[1], v[2], const Vec2*);
         area = -area;
     }
 
-    Vec2 d[3];
-    Vec3 s;
+    e->min = min;
+    e->max = max;
 
-    for(s32 i = 0; i != COUNT_OF(s.d); ++i)
+    for(s32 i = 0; i != COUNT_OF(e->s.d); ++i)
     {
         // pixel center
         const double Center = 0.5 - FLT_EPSILON;
@@ -683,55 +1305,100 @@ static void drawTri(tic_mem* tic, const Vec2* v0, const Vec2* v1, const Vec2* v2
 
         s32 c = (i + 1) % 3, n = (i + 2) % 3;
         
-        d[i].x = (a.v[c]->y - a.v[n]->y) / area;
-        d[i].y = (a.v[n]->x - a.v[c]->x) / area;
-        s.d[i] = edgeFn(a.v[c], a.v[n], &p) / area;
+        e->dx.d[i] = (v[c]->y - v[n]->y) / area;
+        e->dy.d[i] = (v[n]->x - v[c]->x) / area;
+        e->s.d[i] = edgeFn(v[c], v[n], &p) / area;
+        e->inv.d[i] = 1.0 / e->dx.d[i];
     }
 
-    for(s32 y = min.y, start = min.y * TIC80_WIDTH + min.x; y < max.y; ++y, start += TIC80_WIDTH)
-    {
-        for(s32 i = 0; i != COUNT_OF(a.w.d); ++i)
-            a.w.d[i] = s.d[i];
+    return true;
+}
 
-        for(s32 x = min.x, pixel = start; x < max.x; ++x, ++pixel)
-        {
-            if(a.w.x > -DBL_EPSILON && a.w.y > -DBL_EPSILON && a.w.z > -DBL_EPSILON)
-            {
-                u8 color = shader(&a, pixel);
-                if(color != TRANSPARENT_COLOR)
-                    tic_api_poke4(tic, pixel, color);
-            }
+// draws the rows of the triangle within [top, bottom)
+static void rasterTri(tic_core* core, const TriEdges* e, const Vec2* const v[3], SpanShader shader, void* data, s32 top, s32 bottom)
+{
+    ShaderAttr a = {core, data, {v[0], v[1], v[2]}, .dw = e->dx};
+    Vec3 s = e->s;
 
-            for(s32 i = 0; i != COUNT_OF(a.w.d); ++i)
-                a.w.d[i] += d[i].x;
-        }
+    top = MAX(top, e->min.y);
+    bottom = MIN(bottom, e->max.y);
 
+    // rows above are stepped over one by one, so a band sees the same weights as the whole triangle
+    for(s32 y = e->min.y; y < top; ++y)
         for(s32 i = 0; i != COUNT_OF(s.d); ++i)
-            s.d[i] += d[i].y;
+            s.d[i] += e->dy.d[i];
+
+    for(s32 y = top, start = top * TIC80_WIDTH + e->min.x; y < bottom; ++y, start += TIC80_WIDTH)
+    {
+        a.row = s;
+        drawTriRow(&a, &e->inv, start, e->max.x - e->min.x, shader);
+
+        for(s32 i = 0; i != COUNT_OF(s.d); ++i)
+            s.d[i] += e->dy.d[i];
+    }
+}
+
+static void drawTri(tic_mem* tic, const Vec2* v0, const Vec2* v1, const Vec2* v2, SpanShader shader, void* data)
+{
+    tic_core* core = (tic_core*)tic;
+    const Vec2* v[] = {v0, v1, v2};
+    TriEdges e;
+
+    if(initTri(&core->state.clip, v, &e))
+    {
+        tic_core_dirty_rows(core, e.min.y, e.max.y);
+        rasterTri(core, &e, v, shader, data, e.min.y, e.max.y);
     }
 }
 
-static tic_color triColorShader(const ShaderAttr* a, s32 pixel){return *(u8*)a->data;}
+static u64 triBoxArea(float x1, float y1, float x2, float y2, float x3, float y3)
+{
+    float w = MAX(x1, MAX(x2, x3)) - MIN(x1, MIN(x2, x3));
+    float h = MAX(y1, MAX(y2, y3)) - MIN(y1, MIN(y2, y3));
+
+    return (u64)(w * h);
+}
+
+static void triColorShader(ShaderAttr* a, s32 pixel, s32 from, s32 to)
+{
+    fillSpan(a->core->memory.ram->vram.screen.data, pixel + from, to - from, *(u8*)a->data);
+}
 
 void tic_api_tri(tic_mem* tic, float x1, float y1, float x2, float y2, float x3, float y3, u8 color)
 {
+    tic_core* core = (tic_core*)tic;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     color = mapColor(tic, color);
     drawTri(tic,
         &(Vec2){x1, y1},
         &(Vec2){x2, y2},
         &(Vec2){x3, y3}, 
         triColorShader, &color);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_tri, start, start ? triBoxArea(x1, y1, x2, y2, x3, y3) : 0);
 }
 
 void tic_api_trib(tic_mem* tic, float x1, float y1, float x2, float y2, float x3, float y3, u8 color)
 {
     tic_core* core = (tic_core*)tic;
 
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     u8 finalColor = mapColor(tic, color);
 
-    drawLine(tic, x1, y1, x2, y2, finalColor);
-    drawLine(tic, x2, y2, x3, y3, finalColor);
-    drawLine(tic, x3, y3, x1, y1, finalColor);
+    drawLine(core, x1, y1, x2, y2, finalColor);
+    drawLine(core, x2, y2, x3, y3, finalColor);
+    drawLine(core, x3, y3, x1, y1, finalColor);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_trib, start, start ? triBoxArea(x1, y1, x2, y2, x3, y3) : 0);
 }
 
 typedef struct
@@ -743,7 +1410,7 @@ typedef struct
 typedef struct
 {
     tic_tilesheet sheet;
-    u8* mapping;
+    u8 mapping[TIC_PALETTE_SIZE];
     const u8* map;
     const tic_vram* vram;
     bool depth;
@@ -762,7 +1429,7 @@ static inline bool shaderStart(const ShaderAttr* a, Vec3* vars, s32 pixel)
             vars->z += a->w.d[i] * t->d.z;
         }
 
-        if(ZBuffer[pixel] < vars->z);
+        if(a->core->draw.zbuffer[pixel] < vars->z);
         else return false;
     }
 
@@ -781,61 +1448,190 @@ static inline bool shaderStart(const ShaderAttr* a, Vec3* vars, s32 pixel)
     return true;
 }
 
-static inline tic_color shaderEnd(const ShaderAttr* a, const Vec3* vars, s32 pixel, tic_color color)
+static inline void shaderEnd(const ShaderAttr* a, const Vec3* vars, s32 pixel, tic_color color)
 {
     TexData* data = a->data;
 
-    if(data->depth && color != TRANSPARENT_COLOR)
-        ZBuffer[pixel] = vars->z;
+    if(color != TRANSPARENT_COLOR)
+    {
+        if(data->depth)
+            a->core->draw.zbuffer[pixel] = vars->z;
 
-    return color;
+        tic_tool_poke4(a->core->memory.ram->vram.screen.data, pixel, color);
+    }
 }
 
-static tic_color triTexMapShader(const ShaderAttr* a, s32 pixel)
+static void triTexMapShader(ShaderAttr* a, s32 pixel, s32 from, s32 to)
 {
     TexData* data = a->data;
 
-    Vec3 vars;
-    if(!shaderStart(a, &vars, pixel))
-        return TRANSPARENT_COLOR;
-
     enum { MapWidth = TIC_MAP_WIDTH * TIC_SPRITESIZE, MapHeight = TIC_MAP_HEIGHT * TIC_SPRITESIZE,
         WMask = TIC_SPRITESIZE - 1, HMask = TIC_SPRITESIZE - 1 };
 
-    s32 iu = tic_modulo(vars.x, MapWidth);
-    s32 iv = tic_modulo(vars.y, MapHeight);
+    for(s32 k = from; k < to; ++k)
+    {
+        Vec3 vars = {0};
+        shaderWalk(a, k);
+        if(!shaderStart(a, &vars, pixel + k))
+            continue;
+
+        s32 iu = tic_modulo(vars.x, MapWidth);
+        s32 iv = tic_modulo(vars.y, MapHeight);
 
-    u8 idx = data->map[(iv >> 3) * TIC_MAP_WIDTH + (iu >> 3)];
-    tic_tileptr tile = tic_tilesheet_gettile(&data->sheet, idx, true);
+        u8 idx = data->map[(iv >> 3) * TIC_MAP_WIDTH + (iu >> 3)];
+        tic_tileptr tile = tic_tilesheet_gettile(&data->sheet, idx, true);
 
-    return shaderEnd(a, &vars, pixel, data->mapping[tic_tilesheet_gettilepix(&tile, iu & WMask, iv & HMask)]);
+        shaderEnd(a, &vars, pixel + k, data->mapping[tic_tilesheet_gettilepix(&tile, iu & WMask, iv & HMask)]);
+    }
 }
 
-static tic_color triTexTileShader(const ShaderAttr* a, s32 pixel)
+static void triTexTileShader(ShaderAttr* a, s32 pixel, s32 from, s32 to)
 {
     TexData* data = a->data;
 
-    Vec3 vars;
-    if(!shaderStart(a, &vars, pixel))
-        return TRANSPARENT_COLOR;
-
     enum { WMask = TIC_SPRITESHEET_SIZE - 1, HMask = TIC_SPRITESHEET_SIZE * TIC_SPRITE_BANKS - 1 };
 
-    return shaderEnd(a, &vars, pixel, data->mapping[tic_tilesheet_getpix(&data->sheet, (s32)vars.x & WMask, (s32)vars.y & HMask)]);
+    for(s32 k = from; k < to; ++k)
+    {
+        Vec3 vars = {0};
+        shaderWalk(a, k);
+        if(!shaderStart(a, &vars, pixel + k))
+            continue;
+
+        shaderEnd(a, &vars, pixel + k, data->mapping[tic_tilesheet_getpix(&data->sheet, (s32)vars.x & WMask, (s32)vars.y & HMask)]);
+    }
 }
 
-static tic_color triTexVbankShader(const ShaderAttr* a, s32 pixel)
+static void triTexVbankShader(ShaderAttr* a, s32 pixel, s32 from, s32 to)
 {
     TexData* data = a->data;
 
-    Vec3 vars;
-    if(!shaderStart(a, &vars, pixel))
-        return TRANSPARENT_COLOR;
+    for(s32 k = from; k < to; ++k)
+    {
+        Vec3 vars = {0};
+        shaderWalk(a, k);
+        if(!shaderStart(a, &vars, pixel + k))
+            continue;
+
+        s32 iu = tic_modulo(vars.x, TIC80_WIDTH);
+        s32 iv = tic_modulo(vars.y, TIC80_HEIGHT);
+
+        shaderEnd(a, &vars, pixel + k, data->mapping[tic_tool_peek4(data->vram->data, iv * TIC80_WIDTH + iu)]);
+    }
+}
+
+struct tic_deferred_tri
+{
+    TriEdges edges;
+    TexVert v[3];
+    TexData data;
+    SpanShader shader;
+};
+
+typedef struct
+{
+    tic_core* core;
+    s32 top, bottom;
+} TriBand;
+
+// every band goes through the whole queue in order, it owns its screen rows and their depth
+static void drawTriBand(void* data)
+{
+    const TriBand* band = data;
+    tic_core* core = band->core;
+
+    for(s32 i = 0; i < core->tris.count; i++)
+    {
+        tic_deferred_tri* tri = &core->tris.items[i];
+        const Vec2* v[] = {(const Vec2*)&tri->v[0], (const Vec2*)&tri->v[1], (const Vec2*)&tri->v[2]};
+
+        if(tri->edges.min.y < band->bottom && tri->edges.max.y > band->top)
+            rasterTri(core, &tri->edges, v, tri->shader, &tri->data, band->top, band->bottom);
+    }
+}
+
+void tic_core_draw_tris(tic_core* core)
+{
+    enum { MaxBands = 32, MinBandRows = 4, ParallelPixels = TIC80_WIDTH * TIC80_HEIGHT / 2 };
+
+    s32 count = 1;
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    // every core shares the process pool, many instances don't start threads of their own
+    tic_jobs* jobs = NULL;
+
+    if(core->tris.pixels >= ParallelPixels)
+    {
+        jobs = tic_jobs_shared();
+
+        // a few bands per thread to even out frames drawn mostly on one side
+        count = MIN((tic_jobs_count(jobs) + 1) * 4, MIN(MaxBands, TIC80_HEIGHT / MinBandRows));
+    }
+
+    TriBand bands[MaxBands];
+    s32 group = 0;
+
+    for(s32 i = 0; i < count; i++)
+        bands[i] = (TriBand){core, TIC80_HEIGHT * i / count, TIC80_HEIGHT * (i + 1) / count};
+
+    for(s32 i = 1; i < count; i++)
+        tic_jobs_push_group(jobs, &group, drawTriBand, &bands[i]);
+
+    drawTriBand(&bands[0]);
+
+    // other cores may have bands queued on the pool too, only ours are waited for
+    if(count > 1)
+        tic_jobs_wait_group(jobs, &group);
+
+    core->tris.count = 0;
+    core->tris.pixels = 0;
+
+    tic_core_perf_pop(core, phase);
+}
+
+static void deferTri(tic_core* core, const TexVert* t, SpanShader shader, const TexData* data)
+{
+    enum { MinTris = 256, MaxTris = 4096 };
+
+    const Vec2* v[] = {(const Vec2*)&t[0], (const Vec2*)&t[1], (const Vec2*)&t[2]};
+    TriEdges e;
+
+    if(!initTri(&core->state.clip, v, &e))
+        return;
+
+    tic_core_dirty_rows(core, e.min.y, e.max.y);
+
+    if(core->tris.count == core->tris.capacity)
+    {
+        s32 capacity = core->tris.capacity ? core->tris.capacity * 2 : MinTris;
+        tic_deferred_tri* items = capacity <= MaxTris 
+            ? realloc(core->tris.items, capacity * sizeof(tic_deferred_tri)) 
+            : NULL;
+
+        if(items)
+        {
+            core->tris.items = items;
+            core->tris.capacity = capacity;
+        }
+        else tic_core_draw_tris(core);
+
+        if(!core->tris.capacity)
+        {
+            rasterTri(core, &e, v, shader, (void*)data, e.min.y, e.max.y);
+            return;
+        }
+    }
+
+    tic_deferred_tri* tri = &core->tris.items[core->tris.count++];
+
+    tri->edges = e;
+    tri->data = *data;
+    tri->shader = shader;
 
-    s32 iu = tic_modulo(vars.x, TIC80_WIDTH);
-    s32 iv = tic_modulo(vars.y, TIC80_HEIGHT);
+    for(s32 i = 0; i != COUNT_OF(tri->v); ++i)
+        tri->v[i] = *(const TexVert*)v[i];
 
-    return shaderEnd(a, &vars, pixel, data->mapping[tic_tool_peek4(data->vram->data, iv * TIC80_WIDTH + iu)]);
+    core->tris.pixels += (e.max.x - e.min.x) * (e.max.y - e.min.y);
 }
 
 void tic_api_ttri(tic_mem* tic, 
@@ -852,15 +1648,20 @@ void tic_api_ttri(tic_mem* tic,
     if(z1 < FLT_EPSILON || z2 < FLT_EPSILON || z3 < FLT_EPSILON)
         depth = false;
 
+    tic_core* core = (tic_core*)tic;
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
     TexData texData = 
     {
         .sheet = getTileSheetFromSegment(tic, tic->ram->vram.blit.segment),
-        .mapping = getPalette(tic, colors, count),
         .map = tic->ram->map.data,
-        .vram = &((tic_core*)tic)->state.vbank.mem,
+        .vram = &core->state.vbank.mem,
         .depth = depth,
     };
 
+    memcpy(texData.mapping, getPalette(tic, colors, count), sizeof texData.mapping);
+
     TexVert t[] = 
     {
         {x1, y1, u1, v1, z1},
@@ -874,7 +1675,7 @@ void tic_api_ttri(tic_mem* tic,
             t[i].d.y /= t[i].d.z, 
             t[i].d.z = 1.0 / t[i].d.z;
 
-    static const PixelShader Shaders[] = 
+    static const SpanShader Shaders[] = 
     {
         [tic_tiles_texture] = triTexTileShader,
         [tic_map_texture]   = triTexMapShader,
@@ -882,37 +1683,88 @@ void tic_api_ttri(tic_mem* tic,
     };
     
     if(texsrc >= 0 && texsrc < COUNT_OF(Shaders))
-        drawTri(tic,
-            (const Vec2*)&t[0],
-            (const Vec2*)&t[1],
-            (const Vec2*)&t[2], 
-            Shaders[texsrc], &texData);
+    {
+        // a cart writing ram behind the api, i.e. wasm, can't be reordered
+        if(core->tris.enabled && tic->ram == tic->base_ram)
+            deferTri(core, t, Shaders[texsrc], &texData);
+        else
+            drawTri(tic,
+                (const Vec2*)&t[0],
+                (const Vec2*)&t[1],
+                (const Vec2*)&t[2], 
+                Shaders[texsrc], &texData);
+    }
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_ttri, start, start ? triBoxArea(x1, y1, x2, y2, x3, y3) : 0);
 }
 
 void tic_api_map(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, s32 sx, s32 sy, u8* colors, u8 count, s32 scale, RemapFunc remap, void* data)
 {
-    drawMap((tic_core*)memory, &memory->ram->map, x, y, width, height, sx, sy, colors, count, scale, remap, data);
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    drawMap(core, &memory->ram->map, x, y, width, height, sx, sy, colors, count, scale, remap, data);
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_map, start, (u64)MAX(width, 0) * MAX(height, 0) * scale * scale * TIC_SPRITESIZE * TIC_SPRITESIZE);
+}
+
+void tic_core_map_table(tic_mem* memory, s32 x, s32 y, s32 width, s32 height, s32 sx, s32 sy, u8* colors, u8 count, s32 scale, s32 address)
+{
+    bool valid = address > 0 && address <= (s32)sizeof(tic_ram) - TIC_REMAP_TABLE_SIZE;
+
+    tic_api_map(memory, x, y, width, height, sx, sy, colors, count, scale, 
+        valid ? remapTable : NULL, valid ? memory->ram->data + address : NULL);
 }
 
 void tic_api_mset(tic_mem* memory, s32 x, s32 y, u8 value)
 {
-    if (x < 0 || x >= TIC_MAP_WIDTH || y < 0 || y >= TIC_MAP_HEIGHT) return;
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
 
-    tic_map* src = &memory->ram->map;
-    *(src->data + y * TIC_MAP_WIDTH + x) = value;
+    if (x >= 0 && x < TIC_MAP_WIDTH && y >= 0 && y < TIC_MAP_HEIGHT)
+    {
+        tic_map* src = &memory->ram->map;
+        *(src->data + y * TIC_MAP_WIDTH + x) = value;
+    }
+
+    tic_core_api_leave(core, tic_api_id_mset, start, 0);
 }
 
 u8 tic_api_mget(tic_mem* memory, s32 x, s32 y)
 {
-    if (x < 0 || x >= TIC_MAP_WIDTH || y < 0 || y >= TIC_MAP_HEIGHT) return 0;
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+    u8 value = 0;
 
-    const tic_map* src = &memory->ram->map;
-    return *(src->data + y * TIC_MAP_WIDTH + x);
+    if (x >= 0 && x < TIC_MAP_WIDTH && y >= 0 && y < TIC_MAP_HEIGHT)
+    {
+        const tic_map* src = &memory->ram->map;
+        value = *(src->data + y * TIC_MAP_WIDTH + x);
+    }
+
+    tic_core_api_leave(core, tic_api_id_mget, start, 0);
+    return value;
 }
 
 void tic_api_line(tic_mem* memory, float x0, float y0, float x1, float y1, u8 color)
 {
-    drawLine(memory, x0, y0, x1, y1, mapColor(memory, color));
+    tic_core* core = (tic_core*)memory;
+
+    tic_core_flush_tris(core);
+    u64 start = tic_core_api_enter(core);
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_DRAW);
+
+    drawLine(core, x0, y0, x1, y1, mapColor(memory, color));
+
+    tic_core_perf_pop(core, phase);
+    tic_core_api_leave(core, tic_api_id_line, start, start ? (u64)MAX(fabsf(x1 - x0), fabsf(y1 - y0)) + 1 : 0);
 }
 
 #if defined(BUILD_DEPRECATED)
@@ -40,7 +40,7 @@ static bool isKeyPressed(const tic80_keyboard* input, tic_key key)
     return false;
 }
 
-u32 tic_api_btnp(tic_mem* tic, s32 index, s32 hold, s32 period)
+static u32 getBtnp(tic_mem* tic, s32 index, s32 hold, s32 period)
 {
     tic_core* core = (tic_core*)tic;
 
@@ -62,7 +62,7 @@ u32 tic_api_btnp(tic_mem* tic, s32 index, s32 hold, s32 period)
     return ((~previous.data) & core->memory.ram->input.gamepads.data) & (1 << index);
 }
 
-u32 tic_api_btn(tic_mem* tic, s32 index)
+static u32 getBtn(tic_mem* tic, s32 index)
 {
     tic_core* core = (tic_core*)tic;
 
@@ -76,14 +76,14 @@ u32 tic_api_btn(tic_mem* tic, s32 index)
     }
 }
 
-bool tic_api_key(tic_mem* tic, tic_key key)
+static bool getKey(tic_mem* tic, tic_key key)
 {
     return key > tic_key_unknown
         ? isKeyPressed(&tic->ram->input.keyboard, key)
         : tic->ram->input.keyboard.data;
 }
 
-bool tic_api_keyp(tic_mem* tic, tic_key key, s32 hold, s32 period)
+static bool getKeyp(tic_mem* tic, tic_key key, s32 hold, s32 period)
 {
     tic_core* core = (tic_core*)tic;
 
@@ -125,13 +125,68 @@ bool tic_api_keyp(tic_mem* tic, tic_key key, s32 hold, s32 period)
     return false;
 }
 
-tic_point tic_api_mouse(tic_mem* memory)
+static tic_point getMouse(tic_mem* memory)
 {
     return memory->ram->input.mouse.relative 
         ? (tic_point){memory->ram->input.mouse.rx, memory->ram->input.mouse.ry}
         : (tic_point){memory->ram->input.mouse.x - TIC80_OFFSET_LEFT, memory->ram->input.mouse.y - TIC80_OFFSET_TOP};
 }
 
+u32 tic_api_btnp(tic_mem* tic, s32 index, s32 hold, s32 period)
+{
+    tic_core* core = (tic_core*)tic;
+    u64 start = tic_core_api_enter(core);
+
+    u32 value = getBtnp(tic, index, hold, period);
+
+    tic_core_api_leave(core, tic_api_id_btnp, start, 0);
+    return value;
+}
+
+u32 tic_api_btn(tic_mem* tic, s32 index)
+{
+    tic_core* core = (tic_core*)tic;
+    u64 start = tic_core_api_enter(core);
+
+    u32 value = getBtn(tic, index);
+
+    tic_core_api_leave(core, tic_api_id_btn, start, 0);
+    return value;
+}
+
+bool tic_api_key(tic_mem* tic, tic_key key)
+{
+    tic_core* core = (tic_core*)tic;
+    u64 start = tic_core_api_enter(core);
+
+    bool value = getKey(tic, key);
+
+    tic_core_api_leave(core, tic_api_id_key, start, 0);
+    return value;
+}
+
+bool tic_api_keyp(tic_mem* tic, tic_key key, s32 hold, s32 period)
+{
+    tic_core* core = (tic_core*)tic;
+    u64 start = tic_core_api_enter(core);
+
+    bool value = getKeyp(tic, key, hold, period);
+
+    tic_core_api_leave(core, tic_api_id_keyp, start, 0);
+    return value;
+}
+
+tic_point tic_api_mouse(tic_mem* memory)
+{
+    tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+
+    tic_point value = getMouse(memory);
+
+    tic_core_api_leave(core, tic_api_id_mouse, start, 0);
+    return value;
+}
+
 void tic_core_tick_io(tic_mem* tic)
 {
     tic_core* core = (tic_core*)tic;
@@ -489,17 +489,24 @@ static void setMusic(tic_core* core, s32 index, s32 frame, s32 row, bool loop, b
 void tic_api_music(tic_mem* memory, s32 index, s32 frame, s32 row, bool loop, bool sustain, s32 tempo, s32 speed)
 {
     tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
 
     setMusic(core, index, frame, row, loop, sustain, tempo, speed);
 
     if (index >= 0)
         memory->ram->music_state.flag.music_status = tic_music_play;
+
+    tic_core_api_leave(core, tic_api_id_music, start, 0);
 }
 
 void tic_api_sfx(tic_mem* memory, s32 index, s32 note, s32 octave, s32 duration, s32 channel, s32 left, s32 right, s32 speed)
 {
     tic_core* core = (tic_core*)memory;
+    u64 start = tic_core_api_enter(core);
+
     setSfxChannelData(memory, index, note, octave, duration, channel, left, right, speed);
+
+    tic_core_api_leave(core, tic_api_id_sfx, start, 0);
 }
 
 static void stereo_synthesize(tic_core* core, tic_sound_register_data* registers, blip_buffer_t* blip, u8 stereoRight)
@@ -526,6 +533,7 @@ static void stereo_synthesize(tic_core* core, tic_sound_register_data* registers
 void tic_core_synth_sound(tic_mem* memory)
 {
     tic_core* core = (tic_core*)memory;
+    s32 phase = tic_core_perf_push(core, TIC80_PERF_SOUND);
 
     // synthesize sound using the register values found from the tail of the ring buffer
     stereo_synthesize(core, core->state.registers.left, core->blip.left, 0);
@@ -541,6 +549,8 @@ void tic_core_synth_sound(tic_mem* memory)
         // assuming it is aligned in memory (which it should be)
         core->state.sound_ringbuf_tail = (core->state.sound_ringbuf_tail + 1) % TIC_SOUND_RINGBUF_LEN;
     }
+
+    tic_core_perf_pop(core, phase);
 }
 
 void tic_core_sound_tick_start(tic_mem* memory)
@@ -0,0 +1,249 @@
+// MIT License
+
+// Copyright (c) 2020 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "api.h"
+#include "core.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    u32 calls;
+    u64 ns;
+    u64 size;
+} ApiFrameStat;
+
+typedef struct
+{
+    u64 start;
+    ApiFrameStat api[tic_api_id_count];
+} ApiFrame;
+
+struct tic_api_stats
+{
+    tic_api_stat total[tic_api_id_count];
+
+    // ring of frames, the one at index is being recorded
+    s32 index;
+    s32 count;
+    ApiFrame frames[TIC80_PERF_FRAMES];
+};
+
+static const char* ApiNames[] =
+{
+#define TIC_API_DEF(name, ...) #name,
+    TIC_API_LIST(TIC_API_DEF)
+#undef TIC_API_DEF
+};
+
+const char* tic_core_api_name(tic_api_id id)
+{
+    return id >= 0 && id < tic_api_id_count ? ApiNames[id] : NULL;
+}
+
+void tic_core_api_stats_enable(tic_mem* tic, bool enable)
+{
+    tic_core* core = (tic_core*)tic;
+
+    if(enable == !!core->api.stats)
+        return;
+
+    if(enable)
+    {
+        core->api.stats = calloc(1, sizeof(struct tic_api_stats));
+
+        if(core->api.stats)
+            core->api.stats->frames[0].start = tic_core_perf_now();
+    }
+    else
+    {
+        free(core->api.stats);
+        core->api.stats = NULL;
+    }
+
+    core->api.busy = false;
+}
+
+bool tic_core_api_stats_enabled(tic_mem* tic)
+{
+    return ((tic_core*)tic)->api.stats != NULL;
+}
+
+const tic_api_stat* tic_core_api_stats(tic_mem* tic, s32* frames)
+{
+    struct tic_api_stats* stats = ((tic_core*)tic)->api.stats;
+
+    if(frames)
+        *frames = stats ? stats->count : 0;
+
+    return stats ? stats->total : NULL;
+}
+
+void tic_core_api_record(tic_core* core, tic_api_id id, u64 start, u64 size)
+{
+    u64 ns = tic_core_perf_now() - start;
+    struct tic_api_stats* stats = core->api.stats;
+
+    core->api.busy = false;
+
+    // stats were turned off during the call
+    if(!stats)
+        return;
+
+    tic_api_stat* total = &stats->total[id];
+    total->calls++;
+    total->ns += ns;
+    total->size += size;
+    total->maxSize = MAX(total->maxSize, size);
+
+    s32 bucket = 0;
+    while(bucket < TIC_API_STATS_BUCKETS - 1 && (ns >> (bucket + 7)))
+        bucket++;
+
+    total->hist[bucket]++;
+
+    ApiFrameStat* frame = &stats->frames[stats->index].api[id];
+    frame->calls++;
+    frame->ns += ns;
+    frame->size += size;
+}
+
+void tic_core_api_next_frame(tic_core* core)
+{
+    struct tic_api_stats* stats = core->api.stats;
+
+    if(!stats)
+        return;
+
+    stats->index = (stats->index + 1) % TIC80_PERF_FRAMES;
+    stats->count = MIN(stats->count + 1, TIC80_PERF_FRAMES - 1);
+
+    ApiFrame* frame = &stats->frames[stats->index];
+    ZEROMEM(*frame);
+    frame->start = tic_core_perf_now();
+}
+
+typedef struct
+{
+    char* buffer;
+    s32 size;
+    s32 length;
+} Writer;
+
+static void put(Writer* w, const char* format, ...)
+{
+    va_list args;
+    va_start(args, format);
+
+    bool fits = w->length < w->size;
+    s32 length = vsnprintf(fits ? w->buffer + w->length : NULL, fits ? w->size - w->length : 0, format, args);
+
+    va_end(args);
+
+    if(length > 0)
+        w->length += length;
+}
+
+static void putCounter(Writer* w, const char* name, const ApiFrame* frame, u64 ts, bool time)
+{
+    put(w, ",\n{\"name\":\"%s\",\"ph\":\"C\",\"pid\":1,\"ts\":%llu,\"args\":{", name, (unsigned long long)ts);
+
+    const char* sep = "";
+    for(s32 id = 0; id < tic_api_id_count; id++)
+    {
+        const ApiFrameStat* api = &frame->api[id];
+
+        if(api->calls)
+        {
+            if(time)
+                put(w, "%s\"%s\":%.3f", sep, ApiNames[id], api->ns / 1e3);
+            else
+                put(w, "%s\"%s\":%u", sep, ApiNames[id], api->calls);
+
+            sep = ",";
+        }
+    }
+
+    put(w, "}}");
+}
+
+s32 tic_core_api_trace(tic_mem* tic, char* buffer, s32 size)
+{
+    struct tic_api_stats* stats = ((tic_core*)tic)->api.stats;
+    Writer w = {buffer, size, 0};
+
+    if(size > 0)
+        *buffer = '\0';
+
+    put(&w, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"tic80\"}}");
+
+    if(stats)
+    {
+        s32 first = stats->index - stats->count + TIC80_PERF_FRAMES;
+        u64 origin = stats->frames[first % TIC80_PERF_FRAMES].start;
+
+        for(s32 i = 0; i < stats->count; i++)
+        {
+            const ApiFrame* frame = &stats->frames[(first + i) % TIC80_PERF_FRAMES];
+            const ApiFrame* next = &stats->frames[(first + i + 1) % TIC80_PERF_FRAMES];
+            u64 ts = (frame->start - origin) / 1000;
+
+            put(&w, ",\n{\"name\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%llu,\"dur\":%llu}",
+                (unsigned long long)ts, (unsigned long long)(next->start - frame->start) / 1000);
+
+            putCounter(&w, "api calls", frame, ts, false);
+            putCounter(&w, "api us", frame, ts, true);
+        }
+    }
+
+    put(&w, "\n],\n\"apiStats\":{");
+
+    if(stats)
+    {
+        const char* sep = "";
+        for(s32 id = 0; id < tic_api_id_count; id++)
+        {
+            const tic_api_stat* api = &stats->total[id];
+
+            if(!api->calls)
+                continue;
+
+            put(&w, "%s\n\"%s\":{\"calls\":%llu,\"ns\":%llu,\"size\":%llu,\"maxSize\":%llu,\"hist\":[", 
+                sep, ApiNames[id], (unsigned long long)api->calls, (unsigned long long)api->ns, 
+                (unsigned long long)api->size, (unsigned long long)api->maxSize);
+
+            for(s32 i = 0; i < TIC_API_STATS_BUCKETS; i++)
+                put(&w, i ? ",%u" : "%u", api->hist[i]);
+
+            put(&w, "]}");
+            sep = ",";
+        }
+    }
+
+    put(&w, "\n}}\n");
+
+    return w.length;
+}
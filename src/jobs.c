@@ -0,0 +1,360 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "jobs.h"
+#include "defines.h"
+
+#include <stdlib.h>
+
+#if defined(__TIC_WINDOWS__)
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+#if !defined(TIC_JOBS_SYNC)
+#if defined(__TIC_WINDOWS__)
+
+typedef HANDLE              tic_thread;
+typedef CRITICAL_SECTION    tic_mutex;
+typedef CONDITION_VARIABLE  tic_cond;
+typedef INIT_ONCE           tic_once;
+
+#define THREAD_PROC(NAME, ARG)  static DWORD WINAPI NAME(LPVOID ARG)
+#define THREAD_RETURN           return 0
+#define ONCE_PROC(NAME)         static BOOL CALLBACK NAME(PINIT_ONCE once, PVOID param, PVOID* context)
+#define ONCE_RETURN             return TRUE
+#define ONCE_INIT               INIT_ONCE_STATIC_INIT
+
+#define thread_create(T, FN, ARG)   (*(T) = CreateThread(NULL, 0, FN, ARG, 0, NULL))
+#define thread_join(T)              (WaitForSingleObject(T, INFINITE), CloseHandle(T))
+#define mutex_init(M)               InitializeCriticalSection(M)
+#define mutex_free(M)               DeleteCriticalSection(M)
+#define mutex_lock(M)               EnterCriticalSection(M)
+#define mutex_unlock(M)             LeaveCriticalSection(M)
+#define cond_init(C)                InitializeConditionVariable(C)
+#define cond_free(C)
+#define cond_wait(C, M)             SleepConditionVariableCS(C, M, INFINITE)
+#define cond_signal(C)              WakeConditionVariable(C)
+#define cond_broadcast(C)           WakeAllConditionVariable(C)
+#define once_call(O, FN)            InitOnceExecuteOnce(O, FN, NULL, NULL)
+
+#else
+
+#include <pthread.h>
+
+typedef pthread_t           tic_thread;
+typedef pthread_mutex_t     tic_mutex;
+typedef pthread_cond_t      tic_cond;
+typedef pthread_once_t      tic_once;
+
+#define THREAD_PROC(NAME, ARG)  static void* NAME(void* ARG)
+#define THREAD_RETURN           return NULL
+#define ONCE_PROC(NAME)         static void NAME()
+#define ONCE_RETURN             return
+#define ONCE_INIT               PTHREAD_ONCE_INIT
+
+#define thread_create(T, FN, ARG)   pthread_create(T, NULL, FN, ARG)
+#define thread_join(T)              pthread_join(T, NULL)
+#define mutex_init(M)               pthread_mutex_init(M, NULL)
+#define mutex_free(M)               pthread_mutex_destroy(M)
+#define mutex_lock(M)               pthread_mutex_lock(M)
+#define mutex_unlock(M)             pthread_mutex_unlock(M)
+#define cond_init(C)                pthread_cond_init(C, NULL)
+#define cond_free(C)                pthread_cond_destroy(C)
+#define cond_wait(C, M)             pthread_cond_wait(C, M)
+#define cond_signal(C)              pthread_cond_signal(C)
+#define cond_broadcast(C)           pthread_cond_broadcast(C)
+#define once_call(O, FN)            pthread_once(O, FN)
+
+#endif
+#endif
+
+typedef struct Job Job;
+
+struct Job
+{
+    tic_job_callback callback;
+    void* data;
+    // counts the unfinished jobs of a group, under the pool lock
+    s32* group;
+    Job* next;
+};
+
+struct tic_jobs
+{
+    s32 count;
+
+#if !defined(TIC_JOBS_SYNC)
+    Job* head;
+    Job* tail;
+
+    // queued and running jobs
+    s32 pending;
+    bool quit;
+
+    tic_mutex lock;
+    tic_cond wake;
+    tic_cond idle;
+    tic_thread* threads;
+#endif
+};
+
+s32 tic_jobs_cpus()
+{
+#if defined(TIC_JOBS_SYNC)
+    return 1;
+#elif defined(__TIC_WINDOWS__)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return MAX((s32)info.dwNumberOfProcessors, 1);
+#else
+    return MAX((s32)sysconf(_SC_NPROCESSORS_ONLN), 1);
+#endif
+}
+
+#if !defined(TIC_JOBS_SYNC)
+
+THREAD_PROC(worker, arg)
+{
+    tic_jobs* jobs = arg;
+
+    mutex_lock(&jobs->lock);
+
+    for(;;)
+    {
+        while(!jobs->head && !jobs->quit)
+            cond_wait(&jobs->wake, &jobs->lock);
+
+        if(!jobs->head)
+            break;
+
+        Job* job = jobs->head;
+        if(!(jobs->head = job->next))
+            jobs->tail = NULL;
+
+        mutex_unlock(&jobs->lock);
+
+        job->callback(job->data);
+
+        mutex_lock(&jobs->lock);
+
+        if(job->group && --*job->group == 0)
+            cond_broadcast(&jobs->idle);
+
+        if(--jobs->pending == 0)
+            cond_broadcast(&jobs->idle);
+
+        free(job);
+    }
+
+    mutex_unlock(&jobs->lock);
+
+    THREAD_RETURN;
+}
+
+#endif
+
+tic_jobs* tic_jobs_create(s32 threads)
+{
+    tic_jobs* jobs = calloc(1, sizeof(tic_jobs));
+
+    if(threads <= 0)
+        threads = MAX(tic_jobs_cpus() - 1, 1);
+
+#if defined(TIC_JOBS_SYNC)
+    jobs->count = 0;
+#else
+    mutex_init(&jobs->lock);
+    cond_init(&jobs->wake);
+    cond_init(&jobs->idle);
+
+    jobs->threads = malloc(sizeof(tic_thread) * threads);
+
+    for(s32 i = 0; i < threads; i++)
+        thread_create(&jobs->threads[i], worker, jobs);
+
+    jobs->count = threads;
+#endif
+
+    return jobs;
+}
+
+void tic_jobs_push(tic_jobs* jobs, tic_job_callback callback, void* data)
+{
+    tic_jobs_push_group(jobs, NULL, callback, data);
+}
+
+void tic_jobs_push_group(tic_jobs* jobs, s32* group, tic_job_callback callback, void* data)
+{
+#if defined(TIC_JOBS_SYNC)
+    callback(data);
+#else
+    Job* job = malloc(sizeof(Job));
+    *job = (Job){callback, data, group, NULL};
+
+    mutex_lock(&jobs->lock);
+
+    if(group)
+        ++*group;
+
+    if(jobs->tail)
+        jobs->tail->next = job;
+    else jobs->head = job;
+
+    jobs->tail = job;
+    jobs->pending++;
+
+    cond_signal(&jobs->wake);
+    mutex_unlock(&jobs->lock);
+#endif
+}
+
+void tic_jobs_wait(tic_jobs* jobs)
+{
+#if !defined(TIC_JOBS_SYNC)
+    mutex_lock(&jobs->lock);
+
+    while(jobs->pending)
+        cond_wait(&jobs->idle, &jobs->lock);
+
+    mutex_unlock(&jobs->lock);
+#endif
+}
+
+void tic_jobs_wait_group(tic_jobs* jobs, s32* group)
+{
+#if !defined(TIC_JOBS_SYNC)
+    mutex_lock(&jobs->lock);
+
+    while(*group)
+        cond_wait(&jobs->idle, &jobs->lock);
+
+    mutex_unlock(&jobs->lock);
+#endif
+}
+
+s32 tic_jobs_count(tic_jobs* jobs)
+{
+    return jobs->count;
+}
+
+void tic_jobs_close(tic_jobs* jobs)
+{
+#if !defined(TIC_JOBS_SYNC)
+    // queued jobs are still finished before the workers leave
+    mutex_lock(&jobs->lock);
+    jobs->quit = true;
+    cond_broadcast(&jobs->wake);
+    mutex_unlock(&jobs->lock);
+
+    for(s32 i = 0; i < jobs->count; i++)
+        thread_join(jobs->threads[i]);
+
+    free(jobs->threads);
+
+    cond_free(&jobs->idle);
+    cond_free(&jobs->wake);
+    mutex_free(&jobs->lock);
+#endif
+
+    free(jobs);
+}
+
+static tic_jobs* SharedJobs;
+
+#if defined(TIC_JOBS_SYNC)
+
+tic_jobs* tic_jobs_shared()
+{
+    if(!SharedJobs)
+        SharedJobs = tic_jobs_create(0);
+
+    return SharedJobs;
+}
+
+#else
+
+ONCE_PROC(createSharedJobs)
+{
+    SharedJobs = tic_jobs_create(0);
+    ONCE_RETURN;
+}
+
+tic_jobs* tic_jobs_shared()
+{
+    static tic_once once = ONCE_INIT;
+    once_call(&once, createSharedJobs);
+
+    return SharedJobs;
+}
+
+#endif
+
+#if defined(_MSC_VER)
+
+static inline bool casptr(tic_job_node** ptr, tic_job_node* expected, tic_job_node* desired)
+{
+    return InterlockedCompareExchangePointer((PVOID volatile*)ptr, desired, expected) == expected;
+}
+
+static inline tic_job_node* xchgptr(tic_job_node** ptr, tic_job_node* value)
+{
+    return InterlockedExchangePointer((PVOID volatile*)ptr, value);
+}
+
+#else
+
+static inline bool casptr(tic_job_node** ptr, tic_job_node* expected, tic_job_node* desired)
+{
+    return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+static inline tic_job_node* xchgptr(tic_job_node** ptr, tic_job_node* value)
+{
+    return __atomic_exchange_n(ptr, value, __ATOMIC_ACQUIRE);
+}
+
+#endif
+
+void tic_job_list_push(tic_job_list* list, tic_job_node* node)
+{
+    do node->next = list->head;
+    while(!casptr(&list->head, node->next, node));
+}
+
+tic_job_node* tic_job_list_take(tic_job_list* list)
+{
+    tic_job_node* node = xchgptr(&list->head, NULL);
+    tic_job_node* prev = NULL;
+
+    // the list is a stack, reverse it to get the push order back
+    while(node)
+    {
+        tic_job_node* next = node->next;
+        node->next = prev;
+        prev = node;
+        node = next;
+    }
+
+    return prev;
+}
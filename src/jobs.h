@@ -0,0 +1,65 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <tic80_types.h>
+
+// platforms without threads run every job in place, inside tic_jobs_push()
+#if defined(__EMSCRIPTEN__) || defined(_3DS) || defined(BAREMETALPI)
+#   define TIC_JOBS_SYNC 1
+#endif
+
+typedef void(*tic_job_callback)(void* data);
+
+typedef struct tic_jobs tic_jobs;
+
+// threads <= 0 creates one worker per available cpu but the calling one
+tic_jobs*   tic_jobs_create (s32 threads);
+void        tic_jobs_push   (tic_jobs* jobs, tic_job_callback callback, void* data);
+void        tic_jobs_wait   (tic_jobs* jobs);
+s32         tic_jobs_count  (tic_jobs* jobs);
+void        tic_jobs_close  (tic_jobs* jobs);
+s32         tic_jobs_cpus   ();
+
+// one pool for the whole process, created on first use and never closed
+tic_jobs*   tic_jobs_shared ();
+
+// group jobs are waited for apart from the rest of the pool, the counter starts at zero
+void        tic_jobs_push_group (tic_jobs* jobs, s32* group, tic_job_callback callback, void* data);
+void        tic_jobs_wait_group (tic_jobs* jobs, s32* group);
+
+// lock-free list, any thread can push, one thread takes everything at once
+typedef struct tic_job_node tic_job_node;
+
+struct tic_job_node
+{
+    tic_job_node* next;
+};
+
+typedef struct
+{
+    tic_job_node* head;
+} tic_job_list;
+
+void            tic_job_list_push(tic_job_list* list, tic_job_node* node);
+tic_job_node*   tic_job_list_take(tic_job_list* list);
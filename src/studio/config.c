@@ -156,10 +156,14 @@ static void readConfig(Config* config)
             readGlobalInteger(lua,  "UI_SCALE",             &config->data.uiScale);
             readGlobalBool(lua,     "SOFTWARE_RENDERING",   &config->data.soft);
             readGlobalBool(lua,     "TRIM_ON_SAVE",         &config->data.trim);
+            readGlobalInteger(lua,  "COVER_CACHE_KB",       &config->data.coverCache);
 
             if(config->data.uiScale <= 0)
                 config->data.uiScale = 1;
 
+            if(config->data.coverCache <= 0)
+                config->data.coverCache = TIC_COVER_CACHE;
+
             readTheme(config, lua);
         }
 
@@ -186,6 +190,7 @@ static void setDefault(Config* config)
     {
         .cart = config->cart,
         .uiScale = 4,
+        .coverCache = TIC_COVER_CACHE,
         .options = 
         {
 #if defined(CRT_SHADER_SUPPORT)
@@ -0,0 +1,198 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "covers.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct Cover Cover;
+
+struct Cover
+{
+    char* key;
+    tic_screen* screen;
+    tic_palette* palette;
+    s32 size;
+
+    // the most recently used first
+    Cover* prev;
+    Cover* next;
+};
+
+struct tic_covers
+{
+    s32 budget;
+    s32 size;
+
+    // sorted by key
+    Cover** items;
+    s32 count;
+
+    Cover lru;
+};
+
+static s32 findCover(const tic_covers* covers, const char* key, bool* found)
+{
+    s32 lo = 0, hi = covers->count;
+
+    while(lo < hi)
+    {
+        s32 mid = (lo + hi) / 2;
+        s32 cmp = strcmp(covers->items[mid]->key, key);
+
+        if(cmp == 0)
+        {
+            *found = true;
+            return mid;
+        }
+
+        if(cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+
+    *found = false;
+    return lo;
+}
+
+static void unlinkCover(Cover* cover)
+{
+    cover->prev->next = cover->next;
+    cover->next->prev = cover->prev;
+}
+
+static void linkCover(tic_covers* covers, Cover* cover)
+{
+    cover->prev = &covers->lru;
+    cover->next = covers->lru.next;
+    cover->next->prev = cover;
+    covers->lru.next = cover;
+}
+
+static void freeCover(tic_covers* covers, s32 index)
+{
+    Cover* cover = covers->items[index];
+
+    unlinkCover(cover);
+    memmove(covers->items + index, covers->items + index + 1, sizeof(Cover*) * (covers->count - index - 1));
+    covers->count--;
+    covers->size -= cover->size;
+
+    FREE(cover->screen);
+    FREE(cover->palette);
+    free(cover->key);
+    free(cover);
+}
+
+static void evictCovers(tic_covers* covers)
+{
+    // the most recent cover stays even if it doesn't fit
+    while(covers->size > covers->budget && covers->lru.prev != covers->lru.next)
+    {
+        bool found;
+        s32 index = findCover(covers, covers->lru.prev->key, &found);
+        freeCover(covers, index);
+    }
+}
+
+tic_covers* tic_covers_create(s32 budget)
+{
+    tic_covers* covers = calloc(1, sizeof(tic_covers));
+
+    covers->budget = budget;
+    covers->lru.prev = covers->lru.next = &covers->lru;
+
+    return covers;
+}
+
+void tic_covers_budget(tic_covers* covers, s32 budget)
+{
+    covers->budget = budget;
+    evictCovers(covers);
+}
+
+bool tic_covers_get(tic_covers* covers, const char* key, const tic_screen** screen, const tic_palette** palette)
+{
+    bool found;
+    s32 index = findCover(covers, key, &found);
+
+    if(found)
+    {
+        Cover* cover = covers->items[index];
+
+        unlinkCover(cover);
+        linkCover(covers, cover);
+
+        if(screen) *screen = cover->screen;
+        if(palette) *palette = cover->palette;
+    }
+
+    return found;
+}
+
+void tic_covers_put(tic_covers* covers, const char* key, tic_screen* screen, tic_palette* palette)
+{
+    bool found;
+    s32 index = findCover(covers, key, &found);
+
+    if(found)
+        freeCover(covers, index);
+
+    Cover* cover = malloc(sizeof(Cover));
+
+    *cover = (Cover)
+    {
+        .key = strdup(key),
+        .screen = screen,
+        .palette = palette,
+        .size = sizeof(Cover) + (s32)strlen(key) + 1 
+            + (screen ? sizeof(tic_screen) : 0) 
+            + (palette ? sizeof(tic_palette) : 0),
+    };
+
+    covers->items = realloc(covers->items, sizeof(Cover*) * (covers->count + 1));
+    memmove(covers->items + index + 1, covers->items + index, sizeof(Cover*) * (covers->count - index));
+    covers->items[index] = cover;
+    covers->count++;
+    covers->size += cover->size;
+
+    linkCover(covers, cover);
+    evictCovers(covers);
+}
+
+void tic_covers_remove(tic_covers* covers, const char* key)
+{
+    bool found;
+    s32 index = findCover(covers, key, &found);
+
+    if(found)
+        freeCover(covers, index);
+}
+
+void tic_covers_close(tic_covers* covers)
+{
+    while(covers->count)
+        freeCover(covers, covers->count - 1);
+
+    FREE(covers->items);
+    free(covers);
+}
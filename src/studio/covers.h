@@ -0,0 +1,40 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tic.h"
+
+// in-memory cover cache shared by the launcher and the surf screens,
+// the least recently used covers are evicted over the byte budget and fetched again by the screens
+
+typedef struct tic_covers tic_covers;
+
+tic_covers* tic_covers_create   (s32 budget);
+void        tic_covers_budget   (tic_covers* covers, s32 budget);
+// false if the key isn't cached, a cart without a cover is cached with NULLs,
+// the pointers are valid until the next put
+bool        tic_covers_get      (tic_covers* covers, const char* key, const tic_screen** screen, const tic_palette** palette);
+// takes the ownership of the screen and the palette
+void        tic_covers_put      (tic_covers* covers, const char* key, tic_screen* screen, tic_palette* palette);
+void        tic_covers_remove   (tic_covers* covers, const char* key);
+void        tic_covers_close    (tic_covers* covers);
@@ -91,6 +91,7 @@ static void tick(World* world)
     if(keyWasPressed(world->studio, tic_key_tab)) setStudioMode(world->studio, TIC_MAP_MODE);
 
     memcpy(&tic->ram->vram, world->preview, PREVIEW_SIZE);
+    tic_core_invalidate(tic);
 
     VBANK(tic, 1)
     {
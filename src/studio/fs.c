@@ -23,6 +23,7 @@
 #include "studio.h"
 #include "fs.h"
 #include "net.h"
+#include "jobs.h"
 
 #if defined(BAREMETALPI) || defined(_3DS)
   #ifdef EN_DEBUG
@@ -52,9 +53,14 @@
 #include <direct.h>
 #include <windows.h>
 #else
+#include <fcntl.h>
 #include <unistd.h>
 #endif
 
+#if defined(__TIC_LINUX__)
+#include <sys/inotify.h>
+#endif
+
 #if defined(__EMSCRIPTEN__)
 #include <emscripten.h>
 #endif
@@ -449,6 +455,462 @@ void tic_fs_enum(tic_fs* fs, fs_list_callback onItem, fs_done_callback onDone, v
     onDone(data);
 }
 
+typedef struct
+{
+    tic_job_node node;
+    // subfolders found by the folder job, queued once the batch is published
+    s32 dirs;
+    s32 count;
+    fs_scan_item* items;
+} ScanBatch;
+
+struct tic_fs_scan
+{
+    tic_jobs* jobs;
+    tic_job_list done;
+    fs_scan_filter filter;
+    char root[TICNAME_MAX];
+    // folders queued but not reported yet, touched on the polling thread only
+    s32 pending;
+    volatile bool quit;
+};
+
+typedef struct
+{
+    tic_fs_scan* scan;
+    char* dir;
+} ScanDir;
+
+static void scanDir(void* data);
+
+static void scanPath(const tic_fs_scan* scan, const char* dir, char* path)
+{
+    snprintf(path, TICNAME_MAX, "%s%s%s", scan->root, dir, *dir ? "/" : "");
+
+#if defined(__TIC_WINDOWS__)
+    for(char* ptr = path; *ptr; ptr++)
+        if(*ptr == '/') *ptr = '\\';
+#endif
+}
+
+static void scanItem(tic_fs_scan* scan, ScanBatch* batch, const char* dir, const char* name, const fs_stat_data* stat)
+{
+    char path[TICNAME_MAX];
+    snprintf(path, sizeof path, "%s%s%s", dir, *dir ? "/" : "", name);
+
+    if(stat->dir)
+        batch->dirs++;
+
+    batch->items = realloc(batch->items, sizeof(fs_scan_item) * (batch->count + 1));
+    batch->items[batch->count++] = (fs_scan_item){strdup(path), *stat};
+}
+
+static void scanDir(void* data)
+{
+    ScanDir* job = data;
+    tic_fs_scan* scan = job->scan;
+
+    ScanBatch* batch = calloc(1, sizeof(ScanBatch));
+
+    if(!scan->quit)
+    {
+        char path[TICNAME_MAX];
+        scanPath(scan, job->dir, path);
+
+#if defined(BAREMETALPI)
+        if (path[strlen(path) - 1] == '/')
+            path[strlen(path) - 1] = 0;
+
+        DIR Directory;
+        FILINFO FileInfo;
+        FRESULT Result = f_findfirst (&Directory, &FileInfo, path, "*");
+
+        // FatFs already returns the size and the date with the entry
+        for (; Result == FR_OK && FileInfo.fname[0]; Result = f_findnext (&Directory, &FileInfo))
+        {
+            bool dir = FileInfo.fattrib & AM_DIR;
+
+            if (!(FileInfo.fattrib & (AM_HID | AM_SYS)) && (dir || scan->filter(FileInfo.fname)))
+            {
+                fs_stat_data stat = {((u64)FileInfo.fdate << 16) | FileInfo.ftime, FileInfo.fsize, dir};
+                scanItem(scan, batch, job->dir, FileInfo.fname, &stat);
+            }
+        }
+#else
+        TIC_DIR *dir = NULL;
+        struct tic_dirent* ent = NULL;
+
+        const FsString* pathString = utf8ToString(path);
+
+        if ((dir = tic_opendir(pathString)) != NULL)
+        {
+            struct tic_stat_struct s;
+
+            while ((ent = tic_readdir(dir)) != NULL && !scan->quit)
+            {
+                if(*ent->d_name == _S('.'))
+                    continue;
+
+                const char* name = stringToUtf8(ent->d_name);
+
+#if defined(_DIRENT_HAVE_D_TYPE)
+                // the folder entry already knows the type, only the carts get stat'ed
+                bool known = ent->d_type != DT_UNKNOWN && ent->d_type != DT_LNK;
+                bool isdir = ent->d_type == DT_DIR;
+#else
+                bool known = false, isdir = false;
+#endif
+                if(!known || isdir || scan->filter(name))
+                {
+#if defined(_DIRENT_HAVE_D_TYPE) && !defined(__TIC_WINDOWS__)
+                    // relative to the open folder, the path isn't resolved again for every entry
+                    s32 ret = known && isdir ? 0 : fstatat(dirfd(dir), ent->d_name, &s, AT_SYMLINK_NOFOLLOW);
+
+                    // linked carts are followed but linked folders are not, a link back to
+                    // a parent would index the same carts again on every level
+                    if(ret == 0 && S_ISLNK(s.st_mode))
+                        ret = fstatat(dirfd(dir), ent->d_name, &s, 0) == 0 && !S_ISDIR(s.st_mode) ? 0 : -1;
+#else
+                    FsString fullPath[TICNAME_MAX];
+                    tic_strncpy(fullPath, pathString, COUNT_OF(fullPath));
+                    tic_strncat(fullPath, ent->d_name, COUNT_OF(fullPath) - 1);
+                    s32 ret = known && isdir ? 0 : tic_stat(fullPath, &s);
+#endif
+                    if(ret == 0)
+                    {
+                        fs_stat_data stat = known && isdir
+                            ? (fs_stat_data){.dir = true}
+                            : (fs_stat_data){s.st_mtime, (s32)s.st_size, S_ISDIR(s.st_mode)};
+
+                        if(stat.dir || known || scan->filter(name))
+                            scanItem(scan, batch, job->dir, name, &stat);
+                    }
+                }
+
+                freeString(name);
+            }
+
+            tic_closedir(dir);
+        }
+
+        freeString(pathString);
+#endif
+    }
+
+    // the batch is published before its subfolders are queued, so the poll always counts
+    // a folder's subfolders before it can see any of their batches
+    char** dirs = malloc(sizeof(char*) * batch->dirs);
+
+    for(s32 i = 0, d = 0; i < batch->count; i++)
+        if(batch->items[i].stat.dir)
+            dirs[d++] = strdup(batch->items[i].path);
+
+    s32 count = batch->dirs;
+    tic_job_list_push(&scan->done, &batch->node);
+
+    for(s32 i = 0; i < count; i++)
+    {
+        ScanDir sub = {scan, dirs[i]};
+        tic_jobs_push(scan->jobs, scanDir, MOVE(sub));
+    }
+
+    free(dirs);
+    free(job->dir);
+    free(job);
+}
+
+tic_fs_scan* tic_fs_scan_start(tic_fs* fs, const char* dir, fs_scan_filter filter)
+{
+    tic_fs_scan* scan = calloc(1, sizeof(tic_fs_scan));
+
+    *scan = (tic_fs_scan)
+    {
+        .jobs = tic_jobs_create(0),
+        .filter = filter,
+        .pending = 1,
+    };
+
+    strncpy(scan->root, fs->dir, sizeof scan->root - 1);
+
+    ScanDir job = {scan, strdup(dir)};
+    tic_jobs_push(scan->jobs, scanDir, MOVE(job));
+
+    return scan;
+}
+
+static void freeBatch(ScanBatch* batch)
+{
+    for(s32 i = 0; i < batch->count; i++)
+        free(batch->items[i].path);
+
+    FREE(batch->items);
+    free(batch);
+}
+
+bool tic_fs_scan_poll(tic_fs_scan* scan, fs_scan_callback callback, void* data)
+{
+    for(tic_job_node* node = tic_job_list_take(&scan->done); node;)
+    {
+        ScanBatch* batch = (ScanBatch*)node;
+        node = node->next;
+
+        for(s32 i = 0; i < batch->count; i++)
+            callback(&batch->items[i], data);
+
+        scan->pending += batch->dirs - 1;
+        freeBatch(batch);
+    }
+
+    return scan->pending == 0;
+}
+
+void tic_fs_scan_close(tic_fs_scan* scan)
+{
+    scan->quit = true;
+    tic_jobs_close(scan->jobs);
+
+    for(tic_job_node* node = tic_job_list_take(&scan->done); node;)
+    {
+        ScanBatch* batch = (ScanBatch*)node;
+        node = node->next;
+        freeBatch(batch);
+    }
+
+    free(scan);
+}
+
+#if defined(__TIC_LINUX__)
+
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR)
+
+typedef struct
+{
+    s32 wd;
+    char* path;
+} WatchDir;
+
+struct tic_fs_watch
+{
+    s32 fd;
+    char root[TICNAME_MAX];
+    WatchDir* dirs;
+    s32 count;
+};
+
+static void watchPath(const char* dir, const char* name, char* path)
+{
+    snprintf(path, TICNAME_MAX, "%s%s%s", dir, *dir ? "/" : "", name);
+}
+
+static WatchDir* findWatchDir(tic_fs_watch* watch, s32 wd)
+{
+    for(WatchDir *it = watch->dirs, *end = it + watch->count; it != end; it++)
+        if(it->wd == wd)
+            return it;
+
+    return NULL;
+}
+
+static void removeWatchDir(tic_fs_watch* watch, WatchDir* dir)
+{
+    free(dir->path);
+    *dir = watch->dirs[--watch->count];
+}
+
+tic_fs_watch* tic_fs_watch_create(const char* root)
+{
+    s32 fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if(fd < 0)
+        return NULL;
+
+    tic_fs_watch* watch = calloc(1, sizeof(tic_fs_watch));
+    watch->fd = fd;
+    strncpy(watch->root, root, sizeof watch->root - 1);
+
+    return watch;
+}
+
+bool tic_fs_watch_add(tic_fs_watch* watch, const char* dir)
+{
+    char path[TICNAME_MAX];
+    snprintf(path, sizeof path, "%s%s", watch->root, dir);
+
+    s32 wd = inotify_add_watch(watch->fd, path, WATCH_MASK);
+
+    if(wd < 0)
+        return false;
+
+    // the same folder gets the same descriptor, only the path is updated
+    WatchDir* item = findWatchDir(watch, wd);
+
+    if(item)
+        free(item->path);
+    else
+    {
+        watch->dirs = realloc(watch->dirs, sizeof(WatchDir) * (watch->count + 1));
+        item = &watch->dirs[watch->count++];
+        item->wd = wd;
+    }
+
+    item->path = strdup(dir);
+
+    return true;
+}
+
+// the folder is watched before it's read, the files created meanwhile are reported twice at worst
+static void watchTree(tic_fs_watch* watch, const char* dir, fs_watch_callback callback, void* data)
+{
+    if(!tic_fs_watch_add(watch, dir))
+        return;
+
+    char path[TICNAME_MAX];
+    snprintf(path, sizeof path, "%s%s", watch->root, dir);
+
+    DIR* handle = opendir(path);
+
+    if(!handle)
+        return;
+
+    for(struct dirent* ent; (ent = readdir(handle)) != NULL;)
+    {
+        if(*ent->d_name == '.')
+            continue;
+
+        bool isdir = ent->d_type == DT_DIR;
+
+        // linked folders aren't watched, the same as the library scan skips them,
+        // a link back to a parent would add a watch for every level until ELOOP
+        if(ent->d_type == DT_UNKNOWN || ent->d_type == DT_LNK)
+        {
+            struct stat s;
+
+            if(fstatat(dirfd(handle), ent->d_name, &s, AT_SYMLINK_NOFOLLOW) != 0)
+                continue;
+
+            if(S_ISLNK(s.st_mode) && (fstatat(dirfd(handle), ent->d_name, &s, 0) != 0 || S_ISDIR(s.st_mode)))
+                continue;
+
+            isdir = S_ISDIR(s.st_mode);
+        }
+
+        char name[TICNAME_MAX];
+        watchPath(dir, ent->d_name, name);
+
+        callback(fs_watch_added, name, isdir, data);
+
+        if(isdir)
+            watchTree(watch, name, callback, data);
+    }
+
+    closedir(handle);
+}
+
+static void unwatchTree(tic_fs_watch* watch, const char* dir)
+{
+    size_t len = strlen(dir);
+
+    for(s32 i = 0; i < watch->count;)
+    {
+        WatchDir* item = &watch->dirs[i];
+
+        if(strncmp(item->path, dir, len) == 0 && (item->path[len] == '\0' || item->path[len] == '/'))
+        {
+            inotify_rm_watch(watch->fd, item->wd);
+            removeWatchDir(watch, item);
+        }
+        else i++;
+    }
+}
+
+void tic_fs_watch_poll(tic_fs_watch* watch, fs_watch_callback callback, void* data)
+{
+    char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t size;
+
+    while((size = read(watch->fd, buffer, sizeof buffer)) > 0)
+    {
+        for(const char* ptr = buffer; ptr < buffer + size;)
+        {
+            const struct inotify_event* event = (const struct inotify_event*)ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if(event->mask & IN_Q_OVERFLOW)
+            {
+                callback(fs_watch_overflow, "", true, data);
+                continue;
+            }
+
+            WatchDir* dir = findWatchDir(watch, event->wd);
+
+            if(!dir)
+                continue;
+
+            // the folder is gone or unwatched
+            if(event->mask & IN_IGNORED)
+            {
+                removeWatchDir(watch, dir);
+                continue;
+            }
+
+            if(!event->len || *event->name == '.')
+                continue;
+
+            char path[TICNAME_MAX];
+            watchPath(dir->path, event->name, path);
+
+            bool isdir = event->mask & IN_ISDIR;
+
+            if(event->mask & (IN_DELETE | IN_MOVED_FROM))
+            {
+                // a moved folder keeps its watches, they would report the old paths
+                if(isdir)
+                    unwatchTree(watch, path);
+
+                callback(fs_watch_removed, path, isdir, data);
+            }
+            else if(isdir)
+            {
+                callback(fs_watch_added, path, true, data);
+                watchTree(watch, path, callback, data);
+            }
+            // a new file is reported when it's written, not when it's created
+            else if(event->mask & IN_MOVED_TO)
+                callback(fs_watch_added, path, false, data);
+            else if(event->mask & IN_CLOSE_WRITE)
+                callback(fs_watch_changed, path, false, data);
+        }
+    }
+}
+
+void tic_fs_watch_close(tic_fs_watch* watch)
+{
+    close(watch->fd);
+
+    for(s32 i = 0; i < watch->count; i++)
+        free(watch->dirs[i].path);
+
+    FREE(watch->dirs);
+    free(watch);
+}
+
+#else
+
+tic_fs_watch* tic_fs_watch_create(const char* root)
+{
+    return NULL;
+}
+
+bool tic_fs_watch_add(tic_fs_watch* watch, const char* dir)
+{
+    return false;
+}
+
+void tic_fs_watch_poll(tic_fs_watch* watch, fs_watch_callback callback, void* data) {}
+void tic_fs_watch_close(tic_fs_watch* watch) {}
+
+#endif
+
 bool tic_fs_deldir(tic_fs* fs, const char* name)
 {
 #if defined(BAREMETALPI)
@@ -738,6 +1200,32 @@ u64 fs_date(const char* path)
 #endif
 }
 
+bool fs_stat(const char* path, fs_stat_data* data)
+{
+#if defined(BAREMETALPI)
+    dbg("fs_stat %s\n", path);
+    FILINFO s;
+    if(f_stat(path, &s) != FR_OK) return false;
+
+    *data = (fs_stat_data){((u64)s.fdate << 16) | s.ftime, s.fsize, s.fattrib & AM_DIR};
+    return true;
+#else
+    struct tic_stat_struct s;
+
+    const FsString* pathString = utf8ToString(path);
+    s32 ret = tic_stat(pathString, &s);
+    freeString(pathString);
+
+    if(ret == 0)
+    {
+        *data = (fs_stat_data){s.st_mtime, (s32)s.st_size, S_ISDIR(s.st_mode)};
+        return true;
+    }
+
+    return false;
+#endif
+}
+
 bool tic_fs_save(tic_fs* fs, const char* name, const void* data, s32 size, bool overwrite)
 {
     if(!overwrite)
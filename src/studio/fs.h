@@ -30,7 +30,37 @@ typedef void(*fs_done_callback)(void* data);
 typedef void(*fs_isdir_callback)(bool dir, void* data);
 typedef void(*fs_load_callback)(const u8* buffer, s32 size, void* data);
 
+typedef struct
+{
+    u64 mtime;
+    s32 size;
+    bool dir;
+} fs_stat_data;
+
+typedef struct
+{
+    // relative to the fs root
+    char* path;
+    fs_stat_data stat;
+} fs_scan_item;
+
+typedef bool(*fs_scan_filter)(const char* name);
+typedef void(*fs_scan_callback)(const fs_scan_item* item, void* data);
+
+typedef enum
+{
+    fs_watch_added,
+    fs_watch_removed,
+    fs_watch_changed,
+    // events were dropped, everything under the watch has to be read again
+    fs_watch_overflow,
+} fs_watch_event;
+
+typedef void(*fs_watch_callback)(fs_watch_event event, const char* path, bool dir, void* data);
+
 typedef struct tic_fs tic_fs;
+typedef struct tic_fs_scan tic_fs_scan;
+typedef struct tic_fs_watch tic_fs_watch;
 struct tic_net;
 
 tic_fs*     tic_fs_create   (const char* path, struct tic_net* net);
@@ -38,6 +68,22 @@ const char* tic_fs_path     (tic_fs* fs, const char* name);
 const char* tic_fs_pathroot (tic_fs* fs, const char* name);
 
 void    tic_fs_enum         (tic_fs* fs, fs_list_callback onItem, fs_done_callback onDone, void* data);
+
+// walks the folder tree on a thread pool, the found files and folders are reported by poll in batches,
+// the filter is called from the workers and gets the file names only
+tic_fs_scan*    tic_fs_scan_start   (tic_fs* fs, const char* dir, fs_scan_filter filter);
+// returns true when the whole tree is reported
+bool            tic_fs_scan_poll    (tic_fs_scan* scan, fs_scan_callback callback, void* data);
+void            tic_fs_scan_close   (tic_fs_scan* scan);
+
+// file change notifications (inotify), create returns NULL where they aren't supported
+// and the caller has to keep polling the files, the paths are relative to the root
+tic_fs_watch*   tic_fs_watch_create (const char* root);
+// folders are watched one by one, the folders created later are watched with their content
+bool            tic_fs_watch_add    (tic_fs_watch* watch, const char* dir);
+// never blocks, reports the events happened since the last call
+void            tic_fs_watch_poll   (tic_fs_watch* watch, fs_watch_callback callback, void* data);
+void            tic_fs_watch_close  (tic_fs_watch* watch);
 void    tic_fs_isdir_async  (tic_fs* fs, const char* name, fs_isdir_callback callback, void* data);
 void    tic_fs_hashload     (tic_fs* fs, const char* name, const char* hash, fs_load_callback callback, void* data);
 bool    tic_fs_delfile      (tic_fs* fs, const char* name);
@@ -57,6 +103,7 @@ void    tic_fs_dirback      (tic_fs* fs);
 void    tic_fs_homedir      (tic_fs* fs);
 
 u64     fs_date     (const char* name);
+bool    fs_stat     (const char* name, fs_stat_data* data);
 bool    fs_exists   (const char* name);
 void*   fs_read     (const char* path, s32* size);
 bool    fs_write    (const char* path, const void* data, s32 size);
@@ -0,0 +1,650 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "library.h"
+#include "studio.h"
+#include "tools.h"
+#include "api.h"
+#include "ext/md5.h"
+
+#include <string.h>
+#include <stdlib.h>
+#include <ctype.h>
+
+#define LIBRARY_FILE TIC_CACHE "library.dat"
+#define LIBRARY_COVER_EXT ".cover"
+
+static const char LibraryMagic[] = "TICL";
+
+enum {LibraryVersion = 2};
+
+typedef struct
+{
+    char magic[sizeof LibraryMagic - 1];
+    u32 version;
+    u32 count;
+} Header;
+
+typedef struct
+{
+    u64 mtime;
+    u64 played;
+    u32 size;
+    u8 hash[TIC_LIBRARY_HASHSIZE];
+    u8 lang;
+    u8 cover;
+    u8 favorite;
+    u16 path;
+    u16 title;
+    u16 author;
+    tic_palette palette;
+} Record;
+
+typedef s32(*ItemCompare)(const tic_library_item* a, const tic_library_item* b);
+
+typedef struct
+{
+    tic_library_item** items;
+    s32 count;
+} View;
+
+struct tic_library
+{
+    tic_fs* fs;
+
+    // absolute path of the cache folder, resolved once on the main thread
+    char cache[TICNAME_MAX];
+
+    // owns the items, sorted by path
+    View index;
+    View views[tic_library_views];
+
+    bool changed;
+};
+
+static char* strdupsafe(const char* str)
+{
+    return str ? strdup(str) : NULL;
+}
+
+static s32 strlensafe(const char* str)
+{
+    return str ? (s32)strlen(str) : 0;
+}
+
+static char* strndupsafe(const char* str, s32 len)
+{
+    if(len == 0)
+        return NULL;
+
+    char* res = malloc(len + 1);
+    memcpy(res, str, len);
+    res[len] = '\0';
+    return res;
+}
+
+void tic_library_copy(tic_library_item* dst, const tic_library_item* src)
+{
+    *dst = *src;
+    dst->path = strdupsafe(src->path);
+    dst->title = strdupsafe(src->title);
+    dst->author = strdupsafe(src->author);
+}
+
+void tic_library_free(tic_library_item* item)
+{
+    FREE(item->path);
+    FREE(item->title);
+    FREE(item->author);
+    ZEROMEM(*item);
+}
+
+const char* tic_library_name(const tic_library_item* item)
+{
+    if(item->title)
+        return item->title;
+
+    const char* name = strrchr(item->path, '/');
+    return name ? name + 1 : item->path;
+}
+
+static s32 comparePath(const tic_library_item* a, const tic_library_item* b)
+{
+    return strcmp(a->path, b->path);
+}
+
+static s32 compareName(const tic_library_item* a, const tic_library_item* b)
+{
+    const char* s1 = tic_library_name(a);
+    const char* s2 = tic_library_name(b);
+
+    for(; *s1 && tolower((u8)*s1) == tolower((u8)*s2); s1++, s2++);
+
+    s32 res = tolower((u8)*s1) - tolower((u8)*s2);
+
+    return res ? res : comparePath(a, b);
+}
+
+static s32 comparePlayed(const tic_library_item* a, const tic_library_item* b)
+{
+    // the last played goes first
+    return a->played != b->played ? (a->played < b->played ? 1 : -1) : comparePath(a, b);
+}
+
+static const ItemCompare ViewCompare[] = 
+{
+    [tic_library_all] = compareName,
+    [tic_library_recent] = comparePlayed,
+    [tic_library_favorites] = compareName,
+};
+
+static bool viewContains(tic_library_view view, const tic_library_item* item)
+{
+    switch(view)
+    {
+    case tic_library_recent: return item->played > 0;
+    case tic_library_favorites: return item->favorite;
+    default: return true;
+    }
+}
+
+// binary search, returns the insert position if the item isn't found
+static s32 viewFind(const View* view, ItemCompare compare, const tic_library_item* item, bool* found)
+{
+    s32 lo = 0, hi = view->count;
+
+    while(lo < hi)
+    {
+        s32 mid = (lo + hi) / 2;
+        s32 cmp = compare(view->items[mid], item);
+
+        if(cmp == 0)
+        {
+            *found = true;
+            return mid;
+        }
+
+        if(cmp < 0) lo = mid + 1;
+        else hi = mid;
+    }
+
+    *found = false;
+    return lo;
+}
+
+static void viewInsert(View* view, ItemCompare compare, tic_library_item* item)
+{
+    bool found;
+    s32 pos = viewFind(view, compare, item, &found);
+
+    view->items = realloc(view->items, sizeof(tic_library_item*) * (view->count + 1));
+    memmove(view->items + pos + 1, view->items + pos, sizeof(tic_library_item*) * (view->count - pos));
+    view->items[pos] = item;
+    view->count++;
+}
+
+static void viewRemove(View* view, ItemCompare compare, const tic_library_item* item)
+{
+    bool found;
+    s32 pos = viewFind(view, compare, item, &found);
+
+    if(found)
+    {
+        memmove(view->items + pos, view->items + pos + 1, sizeof(tic_library_item*) * (view->count - pos - 1));
+        view->count--;
+    }
+}
+
+static void attachItem(tic_library* library, tic_library_item* item)
+{
+    for(s32 i = 0; i < tic_library_views; i++)
+        if(viewContains(i, item))
+            viewInsert(&library->views[i], ViewCompare[i], item);
+}
+
+static void detachItem(tic_library* library, const tic_library_item* item)
+{
+    for(s32 i = 0; i < tic_library_views; i++)
+        if(viewContains(i, item))
+            viewRemove(&library->views[i], ViewCompare[i], item);
+}
+
+static tic_library_item* findItem(tic_library* library, const char* path)
+{
+    bool found;
+    tic_library_item key = {.path = (char*)path};
+    s32 pos = viewFind(&library->index, comparePath, &key, &found);
+    return found ? library->index.items[pos] : NULL;
+}
+
+static tic_library_item* addItem(tic_library* library, const char* path)
+{
+    tic_library_item* item = calloc(1, sizeof(tic_library_item));
+    item->path = strdup(path);
+    // never fresh, gets parsed on the next refresh
+    item->size = -1;
+
+    viewInsert(&library->index, comparePath, item);
+    attachItem(library, item);
+
+    return item;
+}
+
+const tic_library_item* tic_library_find(tic_library* library, const char* path)
+{
+    return findItem(library, path);
+}
+
+void tic_library_set(tic_library* library, const tic_library_item* item)
+{
+    tic_library_item* dst = findItem(library, item->path);
+
+    if(!dst)
+        dst = addItem(library, item->path);
+
+    detachItem(library, dst);
+
+    // played and favorite belong to the index, the workers only refresh the cart data
+    tic_library_item copy;
+    tic_library_copy(&copy, item);
+    copy.played = dst->played;
+    copy.favorite = dst->favorite;
+
+    tic_library_free(dst);
+    *dst = copy;
+
+    attachItem(library, dst);
+
+    library->changed = true;
+}
+
+bool tic_library_remove(tic_library* library, const char* path)
+{
+    tic_library_item* item = findItem(library, path);
+
+    if(item)
+    {
+        detachItem(library, item);
+        viewRemove(&library->index, comparePath, item);
+
+        tic_library_free(item);
+        free(item);
+
+        library->changed = true;
+    }
+
+    return item != NULL;
+}
+
+void tic_library_played(tic_library* library, const char* path, u64 time)
+{
+    tic_library_item* item = findItem(library, path);
+
+    if(!item)
+        item = addItem(library, path);
+
+    detachItem(library, item);
+    item->played = time;
+    attachItem(library, item);
+
+    library->changed = true;
+}
+
+void tic_library_favorite(tic_library* library, const char* path, bool favorite)
+{
+    tic_library_item* item = findItem(library, path);
+
+    if(!item)
+        item = addItem(library, path);
+
+    detachItem(library, item);
+    item->favorite = favorite;
+    attachItem(library, item);
+
+    library->changed = true;
+}
+
+void tic_library_prune(tic_library* library, char** paths, s32 count)
+{
+    // both lists are sorted by path, walking from the end keeps the positions valid while removing
+    s32 i = library->index.count - 1, j = count - 1;
+
+    while(i >= 0)
+    {
+        tic_library_item* item = library->index.items[i];
+        s32 cmp = j >= 0 ? strcmp(item->path, paths[j]) : 1;
+
+        if(cmp < 0)
+        {
+            j--;
+            continue;
+        }
+
+        if(cmp > 0)
+            tic_library_remove(library, item->path);
+        else j--;
+
+        i--;
+    }
+}
+
+s32 tic_library_index(tic_library* library, tic_library_view view, const char* path)
+{
+    const tic_library_item* item = findItem(library, path);
+
+    if(item && viewContains(view, item))
+    {
+        bool found;
+        s32 pos = viewFind(&library->views[view], ViewCompare[view], item, &found);
+        return found ? pos : -1;
+    }
+
+    return -1;
+}
+
+s32 tic_library_count(tic_library* library, tic_library_view view)
+{
+    return library->views[view].count;
+}
+
+const tic_library_item* tic_library_get(tic_library* library, tic_library_view view, s32 index)
+{
+    return library->views[view].items[index];
+}
+
+static ItemCompare SortCompare;
+
+static s32 sortCompare(const void* a, const void* b)
+{
+    return SortCompare(*(const tic_library_item**)a, *(const tic_library_item**)b);
+}
+
+static void freeIndex(View* index)
+{
+    for(s32 i = 0; i < index->count; i++)
+    {
+        tic_library_free(index->items[i]);
+        free(index->items[i]);
+    }
+
+    FREE(index->items);
+    index->count = 0;
+}
+
+static void loadIndex(tic_library* library)
+{
+    s32 size = 0;
+    u8* buffer = tic_fs_loadroot(library->fs, LIBRARY_FILE, &size);
+
+    if(!buffer)
+        return;
+
+    const u8* ptr = buffer;
+    const u8* end = buffer + size;
+
+    Header header;
+
+    if(size >= sizeof header)
+    {
+        memcpy(&header, ptr, sizeof header);
+        ptr += sizeof header;
+
+        if(memcmp(header.magic, LibraryMagic, sizeof header.magic) == 0 && header.version == LibraryVersion)
+        {
+            View* index = &library->index;
+
+            // a corrupt count can't ask for more items than the file holds records
+            u32 count = MIN(header.count, (u32)((end - ptr) / sizeof(Record)));
+            index->items = malloc(sizeof(tic_library_item*) * count);
+
+            for(u32 i = 0; index->items && i < count; i++)
+            {
+                Record rec;
+
+                if(ptr + sizeof rec > end)
+                    break;
+
+                memcpy(&rec, ptr, sizeof rec);
+                ptr += sizeof rec;
+
+                if(rec.path == 0 || ptr + rec.path + rec.title + rec.author > end)
+                    break;
+
+                tic_library_item* item = malloc(sizeof(tic_library_item));
+
+                // without memory the index is dropped and rebuilt by the next scan
+                if(!item)
+                {
+                    freeIndex(index);
+                    break;
+                }
+
+                *item = (tic_library_item)
+                {
+                    .path = strndupsafe((const char*)ptr, rec.path),
+                    .title = strndupsafe((const char*)ptr + rec.path, rec.title),
+                    .author = strndupsafe((const char*)ptr + rec.path + rec.title, rec.author),
+                    .size = rec.size,
+                    .mtime = rec.mtime,
+                    .played = rec.played,
+                    .lang = rec.lang,
+                    .cover = rec.cover,
+                    .favorite = rec.favorite,
+                    .palette = rec.palette,
+                };
+
+                memcpy(item->hash, rec.hash, sizeof rec.hash);
+
+                index->items[index->count++] = item;
+
+                ptr += rec.path + rec.title + rec.author;
+            }
+        }
+    }
+
+    free(buffer);
+
+    // the views are sorted once here and kept sorted by the updates
+    for(s32 i = 0; i < tic_library_views; i++)
+    {
+        View* view = &library->views[i];
+        view->items = malloc(sizeof(tic_library_item*) * library->index.count);
+
+        for(s32 j = 0; j < library->index.count; j++)
+            if(viewContains(i, library->index.items[j]))
+                view->items[view->count++] = library->index.items[j];
+
+        SortCompare = ViewCompare[i];
+        qsort(view->items, view->count, sizeof *view->items, sortCompare);
+    }
+}
+
+void tic_library_save(tic_library* library)
+{
+    if(!library->changed)
+        return;
+
+    s32 size = sizeof(Header);
+
+    for(s32 i = 0; i < library->index.count; i++)
+    {
+        const tic_library_item* item = library->index.items[i];
+        size += sizeof(Record) + strlensafe(item->path) + strlensafe(item->title) + strlensafe(item->author);
+    }
+
+    u8* buffer = malloc(size);
+
+    if(buffer)
+    {
+        u8* ptr = buffer;
+
+        Header header = {.version = LibraryVersion, .count = library->index.count};
+        memcpy(header.magic, LibraryMagic, sizeof header.magic);
+        memcpy(ptr, &header, sizeof header);
+        ptr += sizeof header;
+
+        for(s32 i = 0; i < library->index.count; i++)
+        {
+            const tic_library_item* item = library->index.items[i];
+
+            Record rec;
+            ZEROMEM(rec);
+
+            rec.mtime = item->mtime;
+            rec.played = item->played;
+            rec.size = item->size;
+            rec.lang = item->lang;
+            rec.cover = item->cover;
+            rec.favorite = item->favorite;
+            rec.path = strlensafe(item->path);
+            rec.title = strlensafe(item->title);
+            rec.author = strlensafe(item->author);
+            rec.palette = item->palette;
+            memcpy(rec.hash, item->hash, sizeof rec.hash);
+
+            memcpy(ptr, &rec, sizeof rec);
+            ptr += sizeof rec;
+
+            memcpy(ptr, item->path, rec.path); ptr += rec.path;
+            memcpy(ptr, item->title, rec.title); ptr += rec.title;
+            memcpy(ptr, item->author, rec.author); ptr += rec.author;
+        }
+
+        if(tic_fs_saveroot(library->fs, LIBRARY_FILE, buffer, size, true))
+            library->changed = false;
+
+        free(buffer);
+    }
+}
+
+tic_library* tic_library_create(tic_fs* fs)
+{
+    tic_library* library = calloc(1, sizeof(tic_library));
+
+    library->fs = fs;
+    tic_fs_makedir(fs, TIC_CACHE);
+    strncpy(library->cache, tic_fs_pathroot(fs, TIC_CACHE), sizeof library->cache - 1);
+
+    loadIndex(library);
+
+    return library;
+}
+
+void tic_library_close(tic_library* library)
+{
+    tic_library_save(library);
+    freeIndex(&library->index);
+
+    for(s32 i = 0; i < tic_library_views; i++)
+        FREE(library->views[i].items);
+
+    free(library);
+}
+
+bool tic_library_fresh(const tic_library_item* item, s32 size, u64 mtime)
+{
+    return item && item->size == size && item->mtime == mtime;
+}
+
+static const tic_script_config* getScriptConfig(const tic_cart_info* info)
+{
+    FOR_EACH_LANG(it)
+    {
+        if(it->id == info->lang)
+            return it;
+
+        char* script = tic_tool_metatag(info->code, "script", it->singleComment);
+
+        if(script)
+        {
+            bool found = strcmp(script, it->name) == 0;
+            free(script);
+
+            if(found)
+                return it;
+        }
+    }
+    FOR_EACH_LANG_END
+
+    return Languages[0];
+}
+
+void tic_library_parse(tic_library_item* item, const tic_cart_info* info, const void* data, s32 size)
+{
+    {
+        enum {Size = 512};
+
+        MD5_CTX c;
+        MD5_Init(&c);
+
+        for(const u8* ptr = data; size > 0; size -= Size, ptr += Size)
+            MD5_Update(&c, ptr, size > Size ? Size : size);
+
+        MD5_Final(item->hash, &c);
+    }
+
+    const tic_script_config* config = getScriptConfig(info);
+
+    item->lang = config->id;
+    item->title = tic_tool_metatag(info->code, "title", config->singleComment);
+    item->author = tic_tool_metatag(info->code, "author", config->singleComment);
+    item->palette = info->palette;
+    item->cover = !EMPTY(info->screen.data) && !EMPTY(info->palette.data);
+}
+
+static void coverPath(tic_library* library, const tic_library_item* item, char* path, s32 size)
+{
+    s32 len = snprintf(path, size, "%s", library->cache);
+
+    for(s32 i = 0; i < TIC_LIBRARY_HASHSIZE && len < size; i++)
+        len += snprintf(path + len, size - len, "%02x", item->hash[i]);
+
+    snprintf(path + len, size - len, LIBRARY_COVER_EXT);
+}
+
+tic_screen* tic_library_loadcover(tic_library* library, const tic_library_item* item)
+{
+    if(!item->cover)
+        return NULL;
+
+    char path[TICNAME_MAX];
+    coverPath(library, item, path, sizeof path);
+
+    s32 size = 0;
+    tic_screen* cover = fs_read(path, &size);
+
+    if(cover && size != sizeof(tic_screen))
+    {
+        free(cover);
+        cover = NULL;
+    }
+
+    return cover;
+}
+
+void tic_library_savecover(tic_library* library, const tic_library_item* item, const tic_screen* cover)
+{
+    char path[TICNAME_MAX];
+    coverPath(library, item, path, sizeof path);
+
+    fs_write(path, cover, sizeof(tic_screen));
+}
@@ -0,0 +1,87 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include "tic.h"
+#include "fs.h"
+#include "cart.h"
+
+#define TIC_LIBRARY_HASHSIZE 16
+
+typedef struct
+{
+    // path relative to the fs root
+    char* path;
+    char* title;
+    char* author;
+
+    s32 size;
+    u64 mtime;
+    // last time the cart was run, 0 if never
+    u64 played;
+    u8 hash[TIC_LIBRARY_HASHSIZE];
+    u8 lang;
+
+    bool cover;
+    bool favorite;
+    tic_palette palette;
+} tic_library_item;
+
+typedef enum
+{
+    // sorted by name
+    tic_library_all,
+    // played carts, the last played first
+    tic_library_recent,
+    // favorite carts, sorted by name
+    tic_library_favorites,
+
+    tic_library_views,
+} tic_library_view;
+
+typedef struct tic_library tic_library;
+
+tic_library*            tic_library_create  (tic_fs* fs);
+const tic_library_item* tic_library_find    (tic_library* library, const char* path);
+void                    tic_library_set     (tic_library* library, const tic_library_item* item);
+bool                    tic_library_remove  (tic_library* library, const char* path);
+void                    tic_library_played  (tic_library* library, const char* path, u64 time);
+void                    tic_library_favorite(tic_library* library, const char* path, bool favorite);
+// removes the items missing in the sorted list of paths
+void                    tic_library_prune   (tic_library* library, char** paths, s32 count);
+s32                     tic_library_count   (tic_library* library, tic_library_view view);
+// position of the item in the view, -1 if it isn't there
+s32                     tic_library_index   (tic_library* library, tic_library_view view, const char* path);
+const tic_library_item* tic_library_get     (tic_library* library, tic_library_view view, s32 index);
+void                    tic_library_save    (tic_library* library);
+void                    tic_library_close   (tic_library* library);
+
+// the functions below don't touch the index and can be called from any thread
+bool        tic_library_fresh       (const tic_library_item* item, s32 size, u64 mtime);
+void        tic_library_parse       (tic_library_item* item, const tic_cart_info* info, const void* data, s32 size);
+tic_screen* tic_library_loadcover   (tic_library* library, const tic_library_item* item);
+void        tic_library_savecover   (tic_library* library, const tic_library_item* item, const tic_screen* cover);
+void        tic_library_copy        (tic_library_item* dst, const tic_library_item* src);
+void        tic_library_free        (tic_library_item* item);
+// title or file name
+const char* tic_library_name        (const tic_library_item* item);
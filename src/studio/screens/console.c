@@ -1657,6 +1657,189 @@ static void onGameMenuCommand(Console* console)
     commandDone(console);
 }
 
+static void printPerfStats(Console* console)
+{
+    static const char* Names[TIC80_PERF_PHASES] = {"script", "draw", "callbacks", "blit", "sound", "studio", "upload"};
+
+    tic80_perf_frame frames[TIC80_PERF_FRAMES];
+    s32 count = tic_core_perf_frames(console->tic, frames, COUNT_OF(frames));
+
+    if(!count)
+    {
+        printBack(console, "\nno frames recorded yet, run a cart and try again");
+        return;
+    }
+
+    char buf[TICNAME_MAX];
+    snprintf(buf, sizeof buf, "\nlast %i frames, ms:\n\nphase        avg     max", count);
+    printFront(console, buf);
+
+    double totalAvg = 0, totalMax = 0;
+
+    for(s32 phase = 0; phase < TIC80_PERF_PHASES; phase++)
+    {
+        u64 sum = 0, max = 0;
+
+        for(s32 i = 0; i < count; i++)
+        {
+            sum += frames[i].ns[phase];
+            max = MAX(max, frames[i].ns[phase]);
+        }
+
+        totalAvg += sum / 1e6 / count;
+
+        snprintf(buf, sizeof buf, "\n%-10s%6.2f  %6.2f", Names[phase], sum / 1e6 / count, max / 1e6);
+        printBack(console, buf);
+    }
+
+    for(s32 i = 0; i < count; i++)
+    {
+        u64 ns = 0;
+        for(s32 phase = 0; phase < TIC80_PERF_PHASES; phase++)
+            ns += frames[i].ns[phase];
+
+        totalMax = MAX(totalMax, ns / 1e6);
+    }
+
+    snprintf(buf, sizeof buf, "\n%-10s%6.2f  %6.2f", "total", totalAvg, totalMax);
+    printFront(console, buf);
+}
+
+static void printApiStats(Console* console)
+{
+    s32 frames = 0;
+    const tic_api_stat* stats = tic_core_api_stats(console->tic, &frames);
+
+    // slowest apis first
+    s32 order[tic_api_id_count], count = 0;
+    for(s32 id = 0; id < tic_api_id_count; id++)
+    {
+        if(!stats[id].calls)
+            continue;
+
+        s32 i = count++;
+        for(; i > 0 && stats[order[i - 1]].ns < stats[id].ns; i--)
+            order[i] = order[i - 1];
+
+        order[i] = id;
+    }
+
+    if(!count)
+    {
+        printBack(console, "\nno api calls recorded yet, run a cart and try again");
+        return;
+    }
+
+    char buf[TICNAME_MAX];
+    snprintf(buf, sizeof buf, "\napi calls over %i frames:\n\napi      calls/f  us/call  size/call", frames);
+    printFront(console, buf);
+
+    for(s32 i = 0; i < count; i++)
+    {
+        const tic_api_stat* api = &stats[order[i]];
+
+        snprintf(buf, sizeof buf, "\n%-7s%9.1f%9.2f%11llu", tic_core_api_name(order[i]), 
+            (double)api->calls / MAX(frames, 1), api->ns / 1e3 / api->calls, 
+            (unsigned long long)(api->size / api->calls));
+        printBack(console, buf);
+    }
+}
+
+static void saveApiTrace(Console* console, const char* name)
+{
+    tic_mem* tic = console->tic;
+    s32 size = tic_core_api_trace(tic, NULL, 0) + 1;
+    char* data = malloc(size);
+
+    if(data)
+    {
+        tic_core_api_trace(tic, data, size);
+
+        if(tic_fs_save(console->fs, name, data, size - 1, true))
+        {
+            printBack(console, "\ntrace saved to ");
+            printFront(console, name);
+            printBack(console, "\nopen it in chrome://tracing or ui.perfetto.dev");
+        }
+        else printError(console, "\nerror: trace not saved :(");
+
+        free(data);
+    }
+}
+
+static void onPerfCommand(Console* console)
+{
+    tic_mem* tic = console->tic;
+    const char* param = console->desc->count ? console->desc->params->key : NULL;
+
+    if(!param)
+    {
+        if(tic_core_perf_enabled(tic))
+            printPerfStats(console);
+        else
+        {
+            tic_core_perf_enable(tic, true);
+            printBack(console, "\nprofiler is on, run a cart and call `perf` again");
+        }
+    }
+    else if(strcmp(param, "on") == 0)
+    {
+        tic_core_perf_enable(tic, true);
+        printBack(console, "\nprofiler is on");
+    }
+    else if(strcmp(param, "off") == 0)
+    {
+        tic_core_perf_enable(tic, false);
+        tic_core_api_stats_enable(tic, false);
+        setStudioPerfOverlay(console->studio, false);
+        printBack(console, "\nprofiler is off");
+    }
+    else if(strcmp(param, "api") == 0)
+    {
+        if(tic_core_api_stats_enabled(tic))
+            printApiStats(console);
+        else
+        {
+            tic_core_api_stats_enable(tic, true);
+            printBack(console, "\napi stats are on, run a cart and call `perf api` again");
+        }
+    }
+    else if(strcmp(param, "trace") == 0)
+    {
+        if(tic_core_api_stats_enabled(tic))
+            saveApiTrace(console, console->desc->count > 1 ? console->desc->params[1].key : "trace.json");
+        else
+            printError(console, "\napi stats are off, call `perf api` first");
+    }
+    else if(strcmp(param, "overlay") == 0)
+    {
+        bool show = !getStudioPerfOverlay(console->studio);
+
+        if(show)
+            tic_core_perf_enable(tic, true);
+
+        setStudioPerfOverlay(console->studio, show);
+        printBack(console, show ? "\nperf overlay is shown" : "\nperf overlay is hidden");
+    }
+    else
+    {
+        printError(console, "\nunknown parameter:\n");
+        printError(console, param);
+    }
+
+    commandDone(console);
+}
+
+static void tabCompletePerf(TabCompleteData* data)
+{
+    addTabCompleteOption(data, "on");
+    addTabCompleteOption(data, "off");
+    addTabCompleteOption(data, "overlay");
+    addTabCompleteOption(data, "api");
+    addTabCompleteOption(data, "trace");
+    finishTabComplete(data);
+}
+
 static void onSurfCommand(Console* console)
 {
     gotoSurf(console->studio);
@@ -1682,6 +1865,13 @@ static void loadExternal(Console* console, const char* path)
     onLoadCommandConfirmed(console);
 }
 
+static void loadDecoded(Console* console, const char* name, const tic_cartridge* cart)
+{
+    loadCartSection(console, cart, NULL);
+    onCartLoaded(console, name, NULL);
+    commandDone(console);
+}
+
 static void onConfigCommand(Console* console)
 {
     if(console->desc->count)
@@ -2973,6 +3163,18 @@ static const char HelpUsage[] = "help [<text>"
         NULL,                                                                           \
         onLauncherCommand,                                                                  \
         NULL,                                                                           \
+        NULL)                                                                           \
+                                                                                        \
+    macro("perf",                                                                       \
+        NULL,                                                                           \
+        "show time spent per frame in script, draw, blit, sound, ...\n"                 \
+        "use `on`/`off` to toggle the profiler,\n"                                      \
+        "use `overlay` to toggle the on-screen stats,\n"                                \
+        "use `api` to count and time every api call,\n"                                 \
+        "use `trace` to save them as chrome trace json.",                               \
+        "perf [on|off|overlay|api|trace [file]]",                                       \
+        onPerfCommand,                                                                  \
+        tabCompletePerf,                                                                \
         NULL)                                                                           \
     ADDGET_FILE(macro)
 
@@ -4335,6 +4537,7 @@ void initConsole(Console* console, Studio* studio, tic_fs* fs, tic_net* net, Con
         .loadByHash = loadByHash,
         .load = loadExternal,
         .loadCart = cmdLoadCart,
+        .loadDecoded = loadDecoded,
         .updateProject = updateProject,
         .error = error,
         .trace = trace,
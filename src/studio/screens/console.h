@@ -104,6 +104,8 @@ struct Console
 
     void(*load)(Console*, const char* path);
     bool(*loadCart)(Console*, const char* path);
+    // takes the cart decoded by the caller, the name is what load would get
+    void(*loadDecoded)(Console*, const char* name, const tic_cartridge* cart);
     void(*loadByHash)(Console*, const char* name, const char* hash, const char* section, fs_done_callback callback, void* data);
     void(*updateProject)(Console*);
     void(*error)(Console*, const char*);
@@ -23,6 +23,8 @@
 #include "launcher.h"
 #include "studio/fs.h"
 #include "studio/net.h"
+#include "studio/library.h"
+#include "studio/covers.h"
 #include "console.h"
 #include "menu.h"
 #include "ext/gif.h"
@@ -35,6 +37,7 @@
 #endif
 
 #include <string.h>
+#include <time.h>
 
 #define MAIN_OFFSET 4
 #define MENU_HEIGHT 10
@@ -47,6 +50,9 @@
 #define COVER_FADEIN 96
 #define COVER_FADEOUT 256
 #define CAN_OPEN_URL (__TIC_WINDOWS__ || __TIC_LINUX__ || __TIC_MACOSX__ || __TIC_ANDROID__)
+#define COVER_WORKERS 1
+#define VIEW_REFRESH 15
+#define PRELOAD_DWELL 20
 
 static const char* PngExt = PNG_EXT;
 
@@ -60,12 +66,11 @@ struct SurfItem
     s32 id;
     s32 screen_id;
     s32 column;
-    tic_screen* cover;
-
-    tic_palette* palette;
 
+    // the covers are kept by the studio cover cache
     bool coverLoading;
     bool menuButton;
+    bool favorite;
     bool dir;
     bool project;
 };
@@ -77,6 +82,8 @@ typedef struct
     Launcher* launcher;
     fs_done_callback done;
     void* data;
+    // folders go first, sorted by name
+    s32 dirs;
 } AddMenuItemData;
 
 static void drawTopToolbar(Launcher* launcher, s32 x, s32 y)
@@ -118,7 +125,24 @@ static void drawTopToolbar(Launcher* launcher, s32 x, s32 y)
 static SurfItem* getMenuItem(Launcher* launcher)
 {
     //printf("\nlauncher.c getMenuItem Called");
-    return &launcher->menu.items[launcher->menu.pos];
+    return &launcher->menu.items[launcher->menu.target];
+}
+
+static bool isButtonScreen(Launcher* launcher)
+{
+    return launcher->screen == SCREEN_MAIN || launcher->screen == SCREEN_LOCAL_SELECT;
+}
+
+static bool isLibraryView(enum Screens screen)
+{
+    return screen == SCREEN_LOCAL_ALL 
+        || screen == SCREEN_LOCAL_RECENT 
+        || screen == SCREEN_LOCAL_FAVORITES;
+}
+
+static bool isLibraryScreen(Launcher* launcher)
+{
+    return isLibraryView(launcher->screen);
 }
 
 static void drawBottomToolbar(Launcher* launcher, s32 x, s32 y)
@@ -143,6 +167,18 @@ static void drawBottomToolbar(Launcher* launcher, s32 x, s32 y)
         {
             strcpy(label, "SORTING SELECT");
         }
+        if (launcher->screen == SCREEN_LOCAL_ALL)
+        {
+            strcpy(label, "ALL");
+        }
+        if (launcher->screen == SCREEN_LOCAL_RECENT)
+        {
+            strcpy(label, "RECENT");
+        }
+        if (launcher->screen == SCREEN_LOCAL_FAVORITES)
+        {
+            strcpy(label, "FAVORITES");
+        }
         s32 xl = x + MAIN_OFFSET;
         s32 yl = y + (Height - TIC_FONT_HEIGHT)/2;
         tic_api_print(tic, label, xl, yl+1, tic_color_black, true, 1, false);
@@ -189,47 +225,51 @@ static void drawMenu(Launcher* launcher, s32 x, s32 y)
     s32 h_pad = 20;
     s32 icon_h = div_y - h_pad;
     s32 y_pos = div_y - (icon_h / 2);
-    // Drawing the Selector position based on launcher->menu.pos
-    tic_api_rect(tic, launcher->menu.pos - 1, y_pos - 1, icon_w + 2, icon_h + 2, tic_color_red);
 
-    if (launcher->screen == SCREEN_MAIN)
+    if (isButtonScreen(launcher))
     {
-        // Create 3 Icons.
-        // Icon One
-        tic_api_rect(tic, w_pad / 2, y_pos, icon_w, icon_h, tic_color_white);
-        // Icon Two
-        tic_api_rect(tic, div_x + (w_pad / 2), y_pos, icon_w, icon_h, tic_color_white);
-        // Icon Three
-        tic_api_rect(tic, div_x * 2 + (w_pad / 2), y_pos, icon_w, icon_h, tic_color_white);
-        // Label One
-        const char* label_1 = "LIBRARY";
-        tic_api_print(tic, label_1, w_pad / 2, y_pos + icon_h + 5, tic_color_black, false, 1, false);
-        tic_api_print(tic, label_1, w_pad / 2, y_pos + icon_h + 4, tic_color_white, false, 1, false);
-        // Label Two
-        const char* label_2 = "WEB";
-        tic_api_print(tic, label_2, div_x + (w_pad / 2), y_pos + icon_h + 5, tic_color_black, false, 1, false);
-        tic_api_print(tic, label_2, div_x + (w_pad / 2), y_pos + icon_h + 4, tic_color_white, false, 1, false);
-        // Label Three
-        const char* label_3 = "SETTINGS";
-        tic_api_print(tic, label_3, div_x * 2 + (w_pad / 2), y_pos + icon_h + 5, tic_color_black, false, 1, false);
-        tic_api_print(tic, label_3, div_x * 2 + (w_pad / 2), y_pos + icon_h + 4, tic_color_white, false, 1, false);
-        //printf("\nlauncher.c drawMenu: Icon One X Pos = %i", w_pad / 2);
-        //printf("\nlauncher.c drawMenu: Icon Two X Pos = %i", div_x + (w_pad / 2));
-        //printf("\nlauncher.c drawMenu: Icon Three X Pos = %i", div_x * 2 + (w_pad / 2));
-        // 7, 87, 167
+        // Drawing the Selector position based on launcher->menu.pos
+        tic_api_rect(tic, launcher->menu.pos - 1, y_pos - 1, icon_w + 2, icon_h + 2, tic_color_red);
+
+        // One icon per button, 7, 87, 167
+        for(s32 i = 0; i < launcher->menu.count; i++)
+        {
+            s32 x_pos = div_x * i + (w_pad / 2);
+            const char* label = launcher->menu.items[i].name;
+
+            tic_api_rect(tic, x_pos, y_pos, icon_w, icon_h, tic_color_white);
+            tic_api_print(tic, label, x_pos, y_pos + icon_h + 5, tic_color_black, false, 1, false);
+            tic_api_print(tic, label, x_pos, y_pos + icon_h + 4, tic_color_white, false, 1, false);
+        }
     }
     else
     {
-        // What is s32 ym?
-        s32 ym = y - launcher->menu.pos * MENU_HEIGHT + (MENU_HEIGHT - TIC_FONT_HEIGHT) / 2 - launcher->anim.val.pos;
-        for(s32 i = 0; i < launcher->menu.count; i++, ym += Height)
+        tic_api_rect(tic, 0, y + (MENU_HEIGHT - launcher->anim.val.menuHeight) / 2, TIC80_WIDTH, launcher->anim.val.menuHeight, tic_color_red);
+
+        // only the visible rows are drawn, the library views can be huge
+        s32 first = MAX(0, launcher->menu.target - y / Height - 1);
+        s32 last = MIN(launcher->menu.count, launcher->menu.target + (TIC80_HEIGHT - y) / Height + 1);
+
+        s32 ym = y + (first - launcher->menu.target) * MENU_HEIGHT + (MENU_HEIGHT - TIC_FONT_HEIGHT) / 2 - launcher->anim.val.pos;
+        for(s32 i = first; i < last; i++, ym += Height)
         {
-            const char* name = launcher->menu.items[i].label;
+            const SurfItem* item = &launcher->menu.items[i];
+            const char* name = item->label;
 
             if (ym > (-(TIC_FONT_HEIGHT + 1)) && ym <= TIC80_HEIGHT)
             {
-                tic_api_print(tic, name, x + MAIN_OFFSET, ym + 1, tic_color_black, false, 1, false);
-                tic_api_print(tic, name, x + MAIN_OFFSET, ym, tic_color_white, false, 1, false);
+                s32 xl = x + MAIN_OFFSET;
+
+                if(item->favorite)
+                {
+                    tic_api_print(tic, "*", xl, ym + 1, tic_color_black, false, 1, false);
+                    tic_api_print(tic, "*", xl, ym, tic_color_yellow, false, 1, false);
+                }
+
+                xl += TIC_FONT_WIDTH;
+
+                tic_api_print(tic, name, xl, ym + 1, tic_color_black, false, 1, false);
+                tic_api_print(tic, name, xl, ym, tic_color_white, false, 1, false);
             }
         }
     }
@@ -240,6 +280,18 @@ static inline void cutExt(char* name, const char* ext)
     name[strlen(name)-strlen(ext)] = '\0';
 }
 
+static bool isCartFile(const char* name)
+{
+    static const char CartExt[] = CART_EXT;
+
+    return tic_tool_has_ext(name, CartExt)
+        || tic_tool_has_ext(name, PngExt)
+#if defined(TIC80_PRO)
+        || tic_project_ext(name)
+#endif
+        ;
+}
+
 static bool addMenuItem(const char* name, const char* title, const char* hash, s32 id, void* ptr, bool dir)
 {
     printf("\nlauncher.c addMenuItem Called");
@@ -249,17 +301,22 @@ static bool addMenuItem(const char* name, const char* title, const char* hash, s
 
     static const char CartExt[] = CART_EXT;
 
-    if(dir 
-        || tic_tool_has_ext(name, CartExt)
-        || tic_tool_has_ext(name, PngExt)
-#if defined(TIC80_PRO)
-        || tic_project_ext(name)
-#endif
-        )
+    if(dir || isCartFile(name))
     {
         data->items = realloc(data->items, sizeof(SurfItem) * ++data->count);
         SurfItem* item = &data->items[data->count-1];
 
+        if(dir)
+        {
+            // keep the folders sorted while they come, no need to sort the whole list later
+            s32 pos = data->dirs++;
+            while(pos > 0 && strcmp(data->items[pos - 1].name, name) > 0)
+                pos--;
+
+            memmove(data->items + pos + 1, data->items + pos, sizeof(SurfItem) * (data->count - 1 - pos));
+            item = &data->items[pos];
+        }
+
         *item = (SurfItem)
         {
             .name = strdup(name),
@@ -311,18 +368,7 @@ static bool addMenuButton(const char* name, s32 screen_id, s32 id, void* ptr)
     return true;
 }
 
-static s32 itemcmp(const void* a, const void* b)
-{
-    const SurfItem* item1 = a;
-    const SurfItem* item2 = b;
-
-    if(item1->dir != item2->dir)
-        return item1->dir ? -1 : 1;
-    else if(item1->dir && item2->dir)
-        return strcmp(item1->name, item2->name);
-
-    return 0;
-}
+static void indexItems(Launcher* launcher);
 
 static void addMenuItemsDone(void* data)
 {
@@ -336,9 +382,7 @@ static void addMenuItemsDone(void* data)
     launcher->menu.count = addMenuItemData->count;
     printf("\nlauncher.c addMenuItemsDone: menu.count = %i", launcher->menu.count);
 
-    if(!tic_fs_ispubdir(launcher->fs))
-        printf("\nlauncher.c addMenuItemsDone calling qsort");
-        qsort(launcher->menu.items, launcher->menu.count, sizeof *launcher->menu.items, itemcmp);
+    indexItems(launcher);
 
     if (addMenuItemData->done)
         addMenuItemData->done(addMenuItemData->data);
@@ -360,9 +404,7 @@ static void resetMenu(Launcher* launcher)
             free(item->name);
 
             FREE(item->hash);
-            FREE(item->cover);
             FREE(item->label);
-            FREE(item->palette);
         }
 
         free(launcher->menu.items);
@@ -371,48 +413,65 @@ static void resetMenu(Launcher* launcher)
         launcher->menu.count = 0;
     }
 
+    // covers still being decoded belong to the old items
+    launcher->covers.generation++;
+
     launcher->menu.pos = 7;
+    launcher->menu.target = 0;
     launcher->menu.column = 0;
 }
 
-static void updateMenuItemCover(Launcher* launcher, s32 pos, const u8* cover, s32 size)
+static void updateCover(Launcher* launcher, const char* hash, const u8* cover, s32 size)
 {
-    SurfItem* item = &launcher->menu.items[pos];
+    tic_screen* screen = NULL;
+    tic_palette* palette = NULL;
 
     gif_image* image = gif_read_data(cover, size);
 
     if(image)
     {
-        item->cover = malloc(sizeof(tic_screen));
-        item->palette = malloc(sizeof(tic_palette));
+        screen = calloc(1, sizeof(tic_screen));
+        palette = calloc(1, sizeof(tic_palette));
 
         if (image->width == TIC80_WIDTH 
             && image->height == TIC80_HEIGHT 
             && image->colors <= TIC_PALETTE_SIZE)
         {
-            memcpy(item->palette, image->palette, image->colors * sizeof(tic_rgb));
+            memcpy(palette, image->palette, image->colors * sizeof(tic_rgb));
 
             for(s32 i = 0; i < TIC80_WIDTH * TIC80_HEIGHT; i++)
-                tic_tool_poke4(item->cover->data, i, image->buffer[i]);
-        }
-        else
-        {
-            memset(item->cover, 0, sizeof(tic_screen));
-            memset(item->palette, 0, sizeof(tic_palette));
+                tic_tool_poke4(screen->data, i, image->buffer[i]);
         }
 
         gif_close(image);
     }
+
+    tic_covers_put(getCovers(launcher->studio), hash, screen, palette);
 }
 
 typedef struct
 {
     Launcher* launcher;
     s32 pos;
+    char hash[TICNAME_MAX];
     char cachePath[TICNAME_MAX];
     char dir[TICNAME_MAX];
 } CoverLoadingData;
 
+static void coverDone(Launcher* launcher, const CoverLoadingData* data)
+{
+    char dir[TICNAME_MAX];
+    tic_fs_dir(launcher->fs, dir);
+
+    if(strcmp(dir, data->dir) == 0 && data->pos < launcher->menu.count)
+    {
+        SurfItem* item = &launcher->menu.items[data->pos];
+
+        if(item->hash && strcmp(item->hash, data->hash) == 0)
+            item->coverLoading = false;
+    }
+}
+
 static void coverLoaded(const net_get_data* netData)
 {
     CoverLoadingData* coverLoadingData = netData->calldata;
@@ -421,18 +480,14 @@ static void coverLoaded(const net_get_data* netData)
     if (netData->type == net_get_done)
     {
         tic_fs_saveroot(launcher->fs, coverLoadingData->cachePath, netData->done.data, netData->done.size, false);
-
-        char dir[TICNAME_MAX];
-        tic_fs_dir(launcher->fs, dir);
-
-        if(strcmp(dir, coverLoadingData->dir) == 0)
-            updateMenuItemCover(launcher, coverLoadingData->pos, netData->done.data, netData->done.size);
+        updateCover(launcher, coverLoadingData->hash, netData->done.data, netData->done.size);
     }
 
     switch (netData->type)
     {
     case net_get_done:
     case net_get_error:
+        coverDone(launcher, coverLoadingData);
         free(coverLoadingData);
         break;
     default: break;
@@ -441,20 +496,24 @@ static void coverLoaded(const net_get_data* netData)
 
 static void requestCover(Launcher* launcher, SurfItem* item)
 {
-    CoverLoadingData coverLoadingData = {launcher, launcher->menu.pos};
+    CoverLoadingData coverLoadingData = {launcher, launcher->menu.target};
     tic_fs_dir(launcher->fs, coverLoadingData.dir);
 
     const char* hash = item->hash;
+    strncpy(coverLoadingData.hash, hash, sizeof coverLoadingData.hash - 1);
     sprintf(coverLoadingData.cachePath, TIC_CACHE "%s.gif", hash);
 
     {
         s32 size = 0;
         void* data = tic_fs_loadroot(launcher->fs, coverLoadingData.cachePath, &size);
 
+        // the cover of the same cart doesn't change, the evicted ones come from the disk
         if (data)
         {
-            updateMenuItemCover(launcher, launcher->menu.pos, data, size);
+            updateCover(launcher, hash, data, size);
+            coverDone(launcher, &coverLoadingData);
             free(data);
+            return;
         }
     }
 
@@ -464,66 +523,743 @@ static void requestCover(Launcher* launcher, SurfItem* item)
     tic_net_get(launcher->net, path, coverLoaded, MOVE(coverLoadingData));
 }
 
+typedef struct
+{
+    tic_job_node node;
+    Launcher* launcher;
+    s32 generation;
+    // menu position to put the cover to, -1 if only the index entry is wanted
+    s32 pos;
+    char* path;
+    // snapshot of the library entry, refreshed by the worker if the file changed
+    tic_library_item entry;
+    bool updated;
+    tic_screen* cover;
+    tic_palette* palette;
+} CoverJob;
+
+typedef struct
+{
+    Launcher* launcher;
+    s32 generation;
+    s32 count;
+    CoverJob** jobs;
+} IndexJob;
+
+static void refreshEntry(CoverJob* job)
+{
+    // runs on a worker thread, must not touch the launcher state
+    fs_stat_data stat;
+    if(!fs_stat(job->path, &stat) || stat.dir)
+        return;
+
+    tic_library* library = job->launcher->library;
+    bool wantCover = job->pos >= 0;
+
+    if(tic_library_fresh(&job->entry, stat.size, stat.mtime))
+    {
+        if(!wantCover || !job->entry.cover)
+            return;
+
+        if((job->cover = tic_library_loadcover(library, &job->entry)))
+        {
+            job->palette = MOVE(job->entry.palette);
+            return;
+        }
+    }
+
+    s32 size = 0;
+    void* buffer = fs_read(job->path, &size);
+
+    if(buffer)
+    {
+        tic_cart_info* info = malloc(sizeof(tic_cart_info));
+
+        if(info)
+        {
+            loadCartInfo(info, job->path, buffer, size);
+
+            tic_library_item entry = {.path = job->entry.path};
+            job->entry.path = NULL;
+            tic_library_free(&job->entry);
+
+            entry.size = stat.size;
+            entry.mtime = stat.mtime;
+            tic_library_parse(&entry, info, buffer, size);
+
+            if(entry.cover)
+            {
+                tic_library_savecover(library, &entry, &info->screen);
+
+                if(wantCover)
+                {
+                    job->palette = MOVE(entry.palette);
+                    job->cover = MOVE(info->screen);
+                }
+            }
+
+            job->entry = entry;
+            job->updated = true;
+
+            free(info);
+        }
+
+        free(buffer);
+    }
+}
+
+static void decodeCover(void* data)
+{
+    CoverJob* job = data;
+
+    refreshEntry(job);
+
+    tic_job_list_push(&job->launcher->covers.done, &job->node);
+}
+
+static void indexCarts(void* data)
+{
+    IndexJob* index = data;
+    Launcher* launcher = index->launcher;
+
+    for(s32 i = 0; i < index->count; i++)
+    {
+        CoverJob* job = index->jobs[i];
+
+        // the folder was left, the rest of the entries will be indexed next time
+        if(!launcher->covers.quit 
+            && (index->generation < 0 || index->generation == launcher->covers.generation))
+            refreshEntry(job);
+
+        tic_job_list_push(&launcher->covers.done, &job->node);
+    }
+
+    free(index->jobs);
+    free(index);
+}
+
+static void freeCoverJob(CoverJob* job)
+{
+    FREE(job->cover);
+    FREE(job->palette);
+    tic_library_free(&job->entry);
+    free(job->path);
+    free(job);
+}
+
+static void processDecodedCovers(Launcher* launcher)
+{
+    tic_job_node* node = tic_job_list_take(&launcher->covers.done);
+
+    if(!node)
+        return;
+
+    while(node)
+    {
+        CoverJob* job = (CoverJob*)node;
+        node = node->next;
+
+        if(job->updated)
+        {
+            tic_library_set(launcher->library, &job->entry);
+            launcher->view.dirty = true;
+        }
+
+        // the cart was changed, the cached cover is outdated
+        if(job->updated && job->pos < 0)
+            tic_covers_remove(getCovers(launcher->studio), job->entry.path);
+
+        if(job->pos >= 0)
+        {
+            tic_covers_put(getCovers(launcher->studio), job->entry.path, job->cover, job->palette);
+            job->cover = NULL;
+            job->palette = NULL;
+
+            if(job->generation == launcher->covers.generation && job->pos < launcher->menu.count)
+                launcher->menu.items[job->pos].coverLoading = false;
+        }
+
+        freeCoverJob(job);
+        launcher->covers.pending--;
+    }
+
+    // write the index once the workers are idle
+    if(launcher->covers.pending == 0)
+        tic_library_save(launcher->library);
+}
+
+static void freeCovers(Launcher* launcher)
+{
+    if(launcher->covers.jobs)
+    {
+        // stops the indexing
+        launcher->covers.quit = true;
+
+        tic_jobs_close(launcher->covers.jobs);
+        tic_jobs_close(launcher->covers.index);
+        launcher->covers.jobs = NULL;
+        launcher->covers.index = NULL;
+    }
+
+    if(launcher->library)
+        processDecodedCovers(launcher);
+}
+
+static void itemPath(Launcher* launcher, const SurfItem* item, char* path)
+{
+    char dir[TICNAME_MAX];
+    tic_fs_dir(launcher->fs, dir);
+
+    // library items are relative to the root
+    if(*item->name == '/')
+        snprintf(path, TICNAME_MAX, "%s", item->name + 1);
+    else if(*dir)
+        snprintf(path, TICNAME_MAX, "%s/%s", dir, item->name);
+    else
+        snprintf(path, TICNAME_MAX, "%s", item->name);
+}
+
+static CoverJob* createCoverJob(Launcher* launcher, const char* path, s32 pos)
+{
+    CoverJob job =
+    {
+        .launcher = launcher,
+        .generation = launcher->covers.generation,
+        .pos = pos,
+        .path = strdup(tic_fs_pathroot(launcher->fs, path)),
+    };
+
+    const tic_library_item* entry = tic_library_find(launcher->library, path);
+
+    if(entry)
+        tic_library_copy(&job.entry, entry);
+    else
+        job.entry.path = strdup(path);
+
+    launcher->covers.pending++;
+
+    return MOVE(job);
+}
+
+static void indexItems(Launcher* launcher)
+{
+    // the library views are already indexed, the highlighted cart is refreshed by its cover job
+    if(tic_fs_ispubdir(launcher->fs) || isButtonScreen(launcher) || isLibraryScreen(launcher))
+        return;
+
+    IndexJob index = {launcher, launcher->covers.generation};
+
+    for(s32 i = 0; i < launcher->menu.count; i++)
+    {
+        SurfItem* item = &launcher->menu.items[i];
+
+        if(item->dir || item->menuButton)
+            continue;
+
+        char path[TICNAME_MAX];
+        itemPath(launcher, item, path);
+
+        CoverJob* job = createCoverJob(launcher, path, -1);
+        item->favorite = job->entry.favorite;
+
+        index.jobs = realloc(index.jobs, sizeof(CoverJob*) * ++index.count);
+        index.jobs[index.count - 1] = job;
+    }
+
+    if(index.count)
+        tic_jobs_push(launcher->covers.index, indexCarts, MOVE(index));
+}
+
+// the cache key, the cart hash for the online carts and the path for the local ones
+static bool coverKey(Launcher* launcher, const SurfItem* item, char* key)
+{
+    if(!tic_fs_ispubdir(launcher->fs))
+        itemPath(launcher, item, key);
+    else if(item->hash)
+        snprintf(key, TICNAME_MAX, "%s", item->hash);
+    else return false;
+
+    return true;
+}
+
+static const tic_screen* getCover(Launcher* launcher)
+{
+    const tic_screen* cover = NULL;
+    char key[TICNAME_MAX];
+
+    if(coverKey(launcher, getMenuItem(launcher), key))
+        tic_covers_get(getCovers(launcher->studio), key, &cover, NULL);
+
+    return cover;
+}
+
 static void loadCover(Launcher* launcher)
 {
-    tic_mem* tic = launcher->tic;
-    
     SurfItem* item = getMenuItem(launcher);
     
     if(item->coverLoading)
         return;
 
+    char key[TICNAME_MAX];
+
+    // evicted covers are loaded again
+    if(!coverKey(launcher, item, key) || tic_covers_get(getCovers(launcher->studio), key, NULL, NULL))
+        return;
+
     item->coverLoading = true;
 
     if(!tic_fs_ispubdir(launcher->fs))
     {
+        tic_jobs_push(launcher->covers.jobs, decodeCover, 
+            createCoverJob(launcher, key, (s32)(item - launcher->menu.items)));
+    }
+    else
+    {
+        requestCover(launcher, item);
+    }
+}
 
-        s32 size = 0;
-        void* data = tic_fs_load(launcher->fs, item->name, &size);
+typedef struct
+{
+    tic_job_node node;
+    Launcher* launcher;
+    // relative to the root
+    char* name;
+    char* path;
+    fs_stat_data stat;
+    tic_cartridge* cart;
+} PreloadJob;
 
-        if(data)
-        {
-            tic_cartridge* cart = (tic_cartridge*)malloc(sizeof(tic_cartridge));
+// the same decoding the console does on load, but thread safe
+static tic_cartridge* decodeCart(const char* name, const void* data, s32 size)
+{
+    if(tic_tool_has_ext(name, PngExt))
+        return loadPngCart((png_buffer){(u8*)data, size});
 
-            if(cart)
-            {
+    tic_cartridge* cart = malloc(sizeof(tic_cartridge));
 
-                if(tic_tool_has_ext(item->name, PngExt))
-                {
-                    tic_cartridge* pngcart = loadPngCart((png_buffer){data, size});
-
-                    if(pngcart)
-                    {
-                        memcpy(cart, pngcart, sizeof(tic_cartridge));
-                        free(pngcart);
-                    }
-                    else memset(cart, 0, sizeof(tic_cartridge));
-                }
+    if(cart)
+    {
 #if defined(TIC80_PRO)
-                else if(tic_project_ext(item->name))
-                    tic_project_load(item->name, data, size, cart);
+        if(tic_project_ext(name))
+        {
+            if(!tic_project_load(name, data, size, cart))
+            {
+                free(cart);
+                cart = NULL;
+            }
+        }
+        else
 #endif
-                else
-                    tic_cart_load(cart, data, size);
+            tic_cart_load(cart, data, size);
+    }
+
+    return cart;
+}
+
+static void preloadJob(void* data)
+{
+    PreloadJob* job = data;
+
+    if(!job->launcher->covers.quit && fs_stat(job->path, &job->stat))
+    {
+        s32 size = 0;
+        void* buffer = fs_read(job->path, &size);
+
+        if(buffer)
+        {
+            job->cart = decodeCart(job->name, buffer, size);
+            free(buffer);
+        }
+    }
+
+    tic_job_list_push(&job->launcher->preload.done, &job->node);
+}
+
+static void freePreloadJob(PreloadJob* job)
+{
+    FREE(job->cart);
+    free(job->name);
+    free(job->path);
+    free(job);
+}
+
+static void processPreload(Launcher* launcher)
+{
+    for(tic_job_node* node = tic_job_list_take(&launcher->preload.done); node;)
+    {
+        PreloadJob* job = (PreloadJob*)node;
+        node = node->next;
+
+        // the cursor could move on while the cart was decoded
+        if(job->cart && launcher->preload.path && strcmp(job->name, launcher->preload.path) == 0)
+        {
+            FREE(launcher->preload.cart);
+            launcher->preload.cart = job->cart;
+            launcher->preload.mtime = job->stat.mtime;
+            launcher->preload.size = job->stat.size;
+            job->cart = NULL;
+        }
+
+        freePreloadJob(job);
+    }
+}
+
+static void freePreload(Launcher* launcher)
+{
+    processPreload(launcher);
+
+    FREE(launcher->preload.cart);
+    FREE(launcher->preload.path);
+    launcher->preload.cart = NULL;
+    launcher->preload.path = NULL;
+}
+
+static void preloadCart(Launcher* launcher)
+{
+    if(launcher->menu.target != launcher->preload.target)
+    {
+        launcher->preload.target = launcher->menu.target;
+        launcher->preload.ticks = launcher->ticks;
+        return;
+    }
+
+    if(launcher->ticks - launcher->preload.ticks < PRELOAD_DWELL 
+        || launcher->menu.count == 0 || tic_fs_ispubdir(launcher->fs))
+        return;
+
+    SurfItem* item = getMenuItem(launcher);
+
+    if(item->dir || item->menuButton || item->hash)
+        return;
+
+    char path[TICNAME_MAX];
+    itemPath(launcher, item, path);
+
+    if(launcher->preload.path && strcmp(launcher->preload.path, path) == 0)
+        return;
+
+    // only the last highlighted cart is kept
+    freePreload(launcher);
+    launcher->preload.path = strdup(path);
+
+    PreloadJob job =
+    {
+        .launcher = launcher,
+        .name = strdup(path),
+        .path = strdup(tic_fs_pathroot(launcher->fs, path)),
+    };
+
+    tic_jobs_push(launcher->covers.jobs, preloadJob, MOVE(job));
+}
+
+static const tic_cartridge* getPreloaded(Launcher* launcher, const char* path)
+{
+    processPreload(launcher);
+
+    if(launcher->preload.cart && strcmp(launcher->preload.path, path) == 0)
+    {
+        // the file could be changed after it was decoded
+        fs_stat_data stat;
+        if(fs_stat(tic_fs_pathroot(launcher->fs, path), &stat) 
+            && stat.mtime == launcher->preload.mtime && stat.size == launcher->preload.size)
+            return launcher->preload.cart;
+    }
+
+    return NULL;
+}
+
+static void initItemsAsync(Launcher* launcher, fs_done_callback callback, void* calldata);
 
-                if(!EMPTY(cart->bank0.screen.data) && !EMPTY(cart->bank0.palette.vbank0.data))
+static tic_library_view getLibraryView(Launcher* launcher)
+{
+    switch(launcher->screen)
+    {
+    case SCREEN_LOCAL_RECENT: return tic_library_recent;
+    case SCREEN_LOCAL_FAVORITES: return tic_library_favorites;
+    default: return tic_library_all;
+    }
+}
+
+static void addLibraryItems(Launcher* launcher, AddMenuItemData* data)
+{
+    // the views are kept sorted by the library, the items are just copied in order
+    tic_library_view view = getLibraryView(launcher);
+    s32 count = tic_library_count(launcher->library, view);
+
+    data->items = malloc(sizeof(SurfItem) * count);
+
+    for(s32 i = 0; i < count; i++)
+    {
+        const tic_library_item* entry = tic_library_get(launcher->library, view, i);
+
+        char name[TICNAME_MAX];
+        snprintf(name, sizeof name, "/%s", entry->path);
+
+        SurfItem* item = &data->items[data->count++];
+
+        *item = (SurfItem)
+        {
+            .name = strdup(name),
+            .label = strdup(tic_library_name(entry)),
+            .favorite = entry->favorite,
+            .project = !tic_tool_has_ext(entry->path, CART_EXT),
+        };
+
+        if(!entry->title && !item->project)
+            cutExt(item->label, CART_EXT);
+    }
+
+    launcher->view.dirty = false;
+    launcher->view.ticks = launcher->ticks;
+}
+
+static void refreshLibraryItems(Launcher* launcher)
+{
+    // the selected cart stays selected
+    char* name = launcher->menu.count ? strdup(getMenuItem(launcher)->name) : NULL;
+
+    resetMenu(launcher);
+
+    AddMenuItemData data = {NULL, 0, launcher};
+    addLibraryItems(launcher, &data);
+    launcher->menu.items = data.items;
+    launcher->menu.count = data.count;
+
+    if(name)
+    {
+        s32 pos = tic_library_index(launcher->library, getLibraryView(launcher), name + 1);
+
+        if(pos >= 0)
+            launcher->menu.target = pos;
+
+        free(name);
+    }
+}
+
+typedef struct
+{
+    Launcher* launcher;
+    IndexJob* index;
+} ScanData;
+
+static void updateLibraryItem(Launcher* launcher, IndexJob* index, const char* path, const fs_stat_data* stat)
+{
+    const tic_library_item* entry = tic_library_find(launcher->library, path);
+
+    if(!entry)
+    {
+        // shows up in the views right away, the cart data comes with the index job
+        tic_library_set(launcher->library, &(tic_library_item){.path = (char*)path, .size = -1});
+        launcher->view.dirty = true;
+    }
+
+    if(!tic_library_fresh(entry, stat->size, stat->mtime))
+    {
+        index->jobs = realloc(index->jobs, sizeof(CoverJob*) * ++index->count);
+        index->jobs[index->count - 1] = createCoverJob(launcher, path, -1);
+    }
+}
+
+static void onScanItem(const fs_scan_item* item, void* data)
+{
+    ScanData* scanData = data;
+    Launcher* launcher = scanData->launcher;
+
+    // the folders are watched as they're found, nothing changed behind the scan is missed
+    if(item->stat.dir)
+    {
+        if(launcher->scan.watch)
+            tic_fs_watch_add(launcher->scan.watch, item->path);
+
+        return;
+    }
+
+    launcher->scan.paths = realloc(launcher->scan.paths, sizeof(char*) * (launcher->scan.count + 1));
+    launcher->scan.paths[launcher->scan.count++] = strdup(item->path);
+
+    updateLibraryItem(launcher, scanData->index, item->path, &item->stat);
+}
+
+static s32 pathcmp(const void* a, const void* b)
+{
+    return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+static void freeScan(Launcher* launcher)
+{
+    if(launcher->scan.scan)
+    {
+        tic_fs_scan_close(launcher->scan.scan);
+        launcher->scan.scan = NULL;
+    }
+
+    for(s32 i = 0; i < launcher->scan.count; i++)
+        free(launcher->scan.paths[i]);
+
+    FREE(launcher->scan.paths);
+    launcher->scan.paths = NULL;
+    launcher->scan.count = 0;
+}
+
+static void startScan(Launcher* launcher)
+{
+    if(!launcher->scan.watch && (launcher->scan.watch = tic_fs_watch_create(tic_fs_pathroot(launcher->fs, ""))))
+        tic_fs_watch_add(launcher->scan.watch, "");
+
+    if(!launcher->scan.scan && !launcher->scan.done)
+        launcher->scan.scan = tic_fs_scan_start(launcher->fs, "", isCartFile);
+}
+
+static void processScan(Launcher* launcher)
+{
+    if(!launcher->scan.scan)
+        return;
+
+    // changed carts of every batch are indexed by one sequential job, not tied to the menu
+    IndexJob index = {launcher, -1};
+    ScanData data = {launcher, &index};
+
+    bool done = tic_fs_scan_poll(launcher->scan.scan, onScanItem, &data);
+
+    if(index.count)
+        tic_jobs_push(launcher->covers.index, indexCarts, MOVE(index));
+
+    if(done)
+    {
+        // the carts which weren't found are gone
+        qsort(launcher->scan.paths, launcher->scan.count, sizeof(char*), pathcmp);
+        tic_library_prune(launcher->library, launcher->scan.paths, launcher->scan.count);
+        tic_library_save(launcher->library);
+
+        freeScan(launcher);
+        launcher->scan.done = true;
+        launcher->view.dirty = true;
+    }
+}
+
+static void removeLibraryDir(Launcher* launcher, const char* dir)
+{
+    size_t len = strlen(dir);
+    s32 count = tic_library_count(launcher->library, tic_library_all);
+
+    char** paths = NULL;
+    s32 found = 0;
+
+    for(s32 i = 0; i < count; i++)
+    {
+        const tic_library_item* entry = tic_library_get(launcher->library, tic_library_all, i);
+
+        if(strncmp(entry->path, dir, len) == 0 && entry->path[len] == '/')
+        {
+            paths = realloc(paths, sizeof(char*) * (found + 1));
+            paths[found++] = strdup(entry->path);
+        }
+    }
+
+    for(s32 i = 0; i < found; i++)
+    {
+        tic_library_remove(launcher->library, paths[i]);
+        free(paths[i]);
+    }
+
+    FREE(paths);
+}
+
+static void onWatchEvent(fs_watch_event event, const char* path, bool dir, void* data)
+{
+    ScanData* watchData = data;
+    Launcher* launcher = watchData->launcher;
+
+    switch(event)
+    {
+    case fs_watch_added:
+    case fs_watch_changed:
+        if(!dir && isCartFile(path))
+        {
+            fs_stat_data stat;
+
+            if(fs_stat(tic_fs_pathroot(launcher->fs, path), &stat) && !stat.dir)
+            {
+                // the running scan could have passed the folder already
+                if(launcher->scan.scan)
                 {
-                    memcpy((item->palette = malloc(sizeof(tic_palette))), &cart->bank0.palette.vbank0, sizeof(tic_palette));
-                    memcpy((item->cover = malloc(sizeof(tic_screen))), &cart->bank0.screen, sizeof(tic_screen));
+                    launcher->scan.paths = realloc(launcher->scan.paths, sizeof(char*) * (launcher->scan.count + 1));
+                    launcher->scan.paths[launcher->scan.count++] = strdup(path);
                 }
 
-                free(cart);
+                updateLibraryItem(launcher, watchData->index, path, &stat);
             }
-
-            free(data);
         }
+        break;
+    case fs_watch_removed:
+        if(dir)
+            removeLibraryDir(launcher, path);
+        else
+            tic_library_remove(launcher->library, path);
+
+        launcher->view.dirty = true;
+        break;
+    case fs_watch_overflow:
+        // the events are lost, only the full scan can tell what changed
+        freeScan(launcher);
+        launcher->scan.done = false;
+        startScan(launcher);
+        break;
     }
-    else if(item->hash && !item->cover)
+}
+
+static void processWatch(Launcher* launcher)
+{
+    if(!launcher->scan.watch)
+        return;
+
+    IndexJob index = {launcher, -1};
+    ScanData data = {launcher, &index};
+
+    tic_fs_watch_poll(launcher->scan.watch, onWatchEvent, &data);
+
+    if(index.count)
+        tic_jobs_push(launcher->covers.index, indexCarts, MOVE(index));
+    // the removed carts are written right away, the rest when the index job is done
+    else if(launcher->covers.pending == 0)
+        tic_library_save(launcher->library);
+}
+
+static void toggleFavorite(Launcher* launcher)
+{
+    SurfItem* item = getMenuItem(launcher);
+
+    if(item->dir || item->menuButton || item->hash)
+        return;
+
+    char path[TICNAME_MAX];
+    itemPath(launcher, item, path);
+
+    item->favorite = !item->favorite;
+    tic_library_favorite(launcher->library, path, item->favorite);
+
+    // the item has to leave the view
+    if(launcher->screen == SCREEN_LOCAL_FAVORITES && !item->favorite)
     {
-        requestCover(launcher, item);
+        s32 target = launcher->menu.target;
+        initItemsAsync(launcher, NULL, NULL);
+        launcher->menu.target = MIN(target, launcher->menu.count - 1);
+        launcher->menu.target = MAX(launcher->menu.target, 0);
     }
 }
 
+static void openScreen(Launcher* launcher, enum Screens screen)
+{
+    playSystemSfx(launcher->studio, 2);
+
+    if(screen == SCREEN_LOCAL_SELECT || isLibraryView(screen))
+        startScan(launcher);
+
+    launcher->screen = screen;
+    initItemsAsync(launcher, NULL, NULL);
+}
+
 static void initItemsAsync(Launcher* launcher, fs_done_callback callback, void* calldata)
 {
     printf("\nlauncher.c initItemsAsync Called");
@@ -542,9 +1278,21 @@ static void initItemsAsync(Launcher* launcher, fs_done_callback callback, void*
     // then sort out drawing them in columns later in the drawMenu function... maybe lol
     if(launcher->screen == SCREEN_MAIN)
     {
-        addMenuButton("LIBRARY", SCREEN_MAIN, 0, &data);
-        addMenuButton("WEB", SCREEN_MAIN, 1, &data);
-        addMenuButton("SETTINGS", SCREEN_MAIN, 2, &data);
+        addMenuButton("LIBRARY", SCREEN_LOCAL_SELECT, 0, &data);
+        addMenuButton("WEB", SCREEN_BROWSE_WEB, 1, &data);
+        addMenuButton("SETTINGS", SCREEN_SETTINGS, 2, &data);
+        addMenuItemsDone(MOVE(data));
+    }
+    else if(launcher->screen == SCREEN_LOCAL_SELECT)
+    {
+        addMenuButton("ALL", SCREEN_LOCAL_ALL, 0, &data);
+        addMenuButton("RECENT", SCREEN_LOCAL_RECENT, 1, &data);
+        addMenuButton("FAVORITES", SCREEN_LOCAL_FAVORITES, 2, &data);
+        addMenuItemsDone(MOVE(data));
+    }
+    else if(isLibraryScreen(launcher))
+    {
+        addLibraryItems(launcher, &data);
         addMenuItemsDone(MOVE(data));
     }
     else
@@ -587,7 +1335,7 @@ static void onGoBackDirDone(void* data)
 
             if(strcmp(path, goBackDirDoneData->last) == 0)
             {
-                launcher->menu.pos = i;
+                launcher->menu.target = i;
                 break;
             }
         }
@@ -679,8 +1427,18 @@ static void onLoadCommandConfirmed(Studio* studio, bool yes, void* data)
         }
         else
         {
+            char path[TICNAME_MAX];
+            itemPath(launcher, item, path);
+            tic_library_played(launcher->library, path, time(NULL));
+
+            const tic_cartridge* cart = getPreloaded(launcher, path);
+
+            if(cart)
+                launcher->console->loadDecoded(launcher->console, item->name, cart);
+            else
+                launcher->console->load(launcher->console, item->name);
+
             printf("\nlauncher.c onLoadCommandConfirmed calling runGame");
-            launcher->console->load(launcher->console, item->name);
             runGame(launcher->studio);
         }
     }
@@ -705,7 +1463,13 @@ static void loadCart(Launcher* launcher)
     printf("\nlauncher.c loadCart Called");
     SurfItem* item = getMenuItem(launcher);
 
-    if(tic_tool_has_ext(item->name, PngExt))
+    char path[TICNAME_MAX];
+    itemPath(launcher, item, path);
+
+    // the decoded cart is valid already
+    if(!item->hash && getPreloaded(launcher, path))
+        launcher->anim.movie = resetMovie(&launcher->anim.play);
+    else if(tic_tool_has_ext(item->name, PngExt))
     {
         s32 size = 0;
         void* data = tic_fs_load(launcher->fs, item->name, &size);
@@ -737,6 +1501,12 @@ static void move(Launcher* launcher, s32 dir)
     //printf("\nlauncher.c move: anim.move.items->start = %i before", anim->start);
     //printf("\nlauncher.c move: anim.move.items->end = %i before", anim->end);
 
+    if(!isButtonScreen(launcher))
+    {
+        launcher->menu.target = CLAMP(launcher->menu.target + dir, 0, launcher->menu.count - 1);
+        return;
+    }
+
     // Okay so like, i'm done with this animation thing right now lol
     printf("\nlauncher.c move: launcher->menu.target = %i before", launcher->menu.target);
     if(dir > 0)
@@ -802,6 +1572,16 @@ static void processGamepad(Launcher* launcher)
             Up, Down, Left, Right, A, B, X, Y
         };
 
+        if(launcher->menu.count == 0)
+        {
+            // empty library view, only going back is possible
+            if(tic_api_btnp(tic, B, -1, -1)
+                || tic_api_keyp(tic, tic_key_backspace, -1, -1))
+                openScreen(launcher, SCREEN_LOCAL_SELECT);
+
+            return;
+        }
+
         if(tic_api_btnp(tic, Up, Hold, Period)
             || tic_api_keyp(tic, tic_key_up, Hold, Period))
         {
@@ -850,7 +1630,9 @@ static void processGamepad(Launcher* launcher)
             }
             else if(item->menuButton)
             {
-                printf("\nlauncher.c processGamepad: Time to make a function that changes menu screens!");
+                // web and settings screens aren't there yet
+                if(item->screen_id != SCREEN_BROWSE_WEB && item->screen_id != SCREEN_SETTINGS)
+                    openScreen(launcher, item->screen_id);
             }
             else
             {
@@ -861,7 +1643,17 @@ static void processGamepad(Launcher* launcher)
         if(tic_api_btnp(tic, B, -1, -1)
             || tic_api_keyp(tic, tic_key_backspace, -1, -1))
         {
-            goBackDir(launcher);
+            if(isLibraryScreen(launcher))
+                openScreen(launcher, SCREEN_LOCAL_SELECT);
+            else if(launcher->screen == SCREEN_LOCAL_SELECT)
+                openScreen(launcher, SCREEN_MAIN);
+            else
+                goBackDir(launcher);
+        }
+
+        if(tic_api_btnp(tic, X, -1, -1))
+        {
+            toggleFavorite(launcher);
         }
 
 #ifdef CAN_OPEN_URL
@@ -902,12 +1694,25 @@ static void tick(Launcher* launcher)
         launcher->init = true;
     }
 
+    processDecodedCovers(launcher);
+    processScan(launcher);
+    processWatch(launcher);
+    processPreload(launcher);
+
+    if(isIdle(launcher))
+        preloadCart(launcher);
+
+    // new carts stream into the view, but the list isn't rebuilt every frame
+    if(launcher->view.dirty && isLibraryScreen(launcher) && isIdle(launcher)
+        && (launcher->menu.count == 0 || launcher->ticks - launcher->view.ticks >= VIEW_REFRESH))
+        refreshLibraryItems(launcher);
+
     tic_mem* tic = launcher->tic;
     tic_api_cls(tic, TIC_COLOR_BG);
 
     studio_menu_anim(launcher->tic, launcher->ticks++);
 
-    if (isIdle(launcher) && launcher->menu.count > 0)
+    if (isIdle(launcher) && (launcher->menu.count > 0 || isLibraryScreen(launcher)))
     {
         //printf("\nlauncher.tick: isIdle(launcher) == true AND launcher->menu.count > 0");
         processGamepad(launcher);
@@ -920,7 +1725,7 @@ static void tick(Launcher* launcher)
     if (launcher->menu.count > 0)
     {
         //printf("\nlauncher.c tick: launcher->menu.count > 0");
-        if(launcher->screen == SCREEN_MAIN)
+        if(isButtonScreen(launcher))
         {
             //printf("\nlauncher.c tick: launcher->screen == SCREEN_MAIN");
         }
@@ -929,7 +1734,7 @@ static void tick(Launcher* launcher)
             //printf("\nlauncher.c tick: calling loadCover");
             loadCover(launcher);
             //printf("\nlauncher.c tick: assigning cover from return of getMenuItem");
-            tic_screen* cover = getMenuItem(launcher)->cover;
+            const tic_screen* cover = getCover(launcher);
             if(cover)
                 //printf("\nlauncher.c tick: cover == true");
                 memcpy(tic->ram->vram.screen.data, cover->data, sizeof(tic_screen));
@@ -1010,6 +1815,17 @@ void initLauncher(Launcher* launcher, Studio* studio, struct Console* console)
     printf("\nlauncher.c initLauncher Called");
     printf("\nlauncher.c initLauncher calling freeAnim");
     freeAnim(launcher);
+    freeScan(launcher);
+    freeCovers(launcher);
+    freePreload(launcher);
+
+    // the index outlives the launcher screens
+    tic_library* library = launcher->library ? launcher->library : tic_library_create(console->fs);
+
+    // the watched library doesn't need another scan
+    tic_fs_watch* watch = launcher->scan.watch;
+    bool scanned = watch && launcher->scan.done;
+
     printf("\nlauncher.c initLauncher initializing Launcher Object");
     *launcher = (Launcher)
     {
@@ -1019,6 +1835,12 @@ void initLauncher(Launcher* launcher, Studio* studio, struct Console* console)
         .screen = SCREEN_MAIN,
         .fs = console->fs,
         .net = console->net,
+        .library = library,
+        .scan =
+        {
+            .watch = watch,
+            .done = scanned,
+        },
         .tick = tick,
         .ticks = 0,
         .init = false,
@@ -1030,6 +1852,12 @@ void initLauncher(Launcher* launcher, Studio* studio, struct Console* console)
             .items = NULL,
             .count = 0,
         },
+        .covers =
+        {
+            .jobs = tic_jobs_create(MIN(tic_jobs_cpus(), COVER_WORKERS)),
+            // indexing gets its own worker, the highlighted cover doesn't wait for it
+            .index = tic_jobs_create(1),
+        },
         .anim =
         {
             .idle = {.done = emptyDone,},
@@ -1107,6 +1935,14 @@ void freeLauncher(Launcher* launcher)
 {
     printf("\nlauncher.c freeLauncher Called");
     freeAnim(launcher);
+    freeScan(launcher);
+    freeCovers(launcher);
+    freePreload(launcher);
     resetMenu(launcher);
+
+    if(launcher->scan.watch)
+        tic_fs_watch_close(launcher->scan.watch);
+
+    tic_library_close(launcher->library);
     free(launcher);
 }
@@ -23,6 +23,7 @@
 #pragma once
 
 #include "studio/studio.h"
+#include "jobs.h"
 
 enum Screens
 {
@@ -43,6 +44,7 @@ struct Launcher
     tic_mem* tic;
     struct tic_fs* fs;
     struct tic_net* net;
+    struct tic_library* library;
     struct Console* console;
     enum Screens screen;
 
@@ -59,6 +61,47 @@ struct Launcher
         s32 column;
     } menu;
 
+    struct
+    {
+        tic_jobs* jobs;
+        tic_jobs* index;
+        tic_job_list done;
+        // items still being decoded or indexed
+        s32 pending;
+        volatile s32 generation;
+        volatile bool quit;
+    } covers;
+
+    struct
+    {
+        struct tic_fs_scan* scan;
+        // keeps the library up to date once the scan is over, NULL where not supported
+        struct tic_fs_watch* watch;
+        // found carts, the rest is dropped from the library when the scan is over
+        char** paths;
+        s32 count;
+        bool done;
+    } scan;
+
+    struct
+    {
+        // the library changed since the view items were built
+        bool dirty;
+        s32 ticks;
+    } view;
+
+    struct
+    {
+        // the highlighted cart is decoded in the background once the cursor stays on it
+        s32 target;
+        s32 ticks;
+        char* path;
+        tic_cartridge* cart;
+        u64 mtime;
+        s32 size;
+        tic_job_list done;
+    } preload;
+
     struct
     {
         struct
@@ -23,6 +23,7 @@
 #include "surf.h"
 #include "studio/fs.h"
 #include "studio/net.h"
+#include "studio/covers.h"
 #include "console.h"
 #include "menu.h"
 #include "ext/gif.h"
@@ -58,10 +59,8 @@ struct SurfItem
     char* name;
     char* hash;
     s32 id;
-    tic_screen* cover;
-
-    tic_palette* palette;
 
+    // the covers are kept by the studio cover cache
     bool coverLoading;
     bool dir;
     bool project;
@@ -272,9 +271,7 @@ static void resetMenu(Surf* surf)
             free(item->name);
 
             FREE(item->hash);
-            FREE(item->cover);
             FREE(item->label);
-            FREE(item->palette);
         }
 
         free(surf->menu.items);
@@ -286,44 +283,57 @@ static void resetMenu(Surf* surf)
     surf->menu.pos = 0;
 }
 
-static void updateMenuItemCover(Surf* surf, s32 pos, const u8* cover, s32 size)
+static void updateCover(Surf* surf, const char* hash, const u8* cover, s32 size)
 {
-    SurfItem* item = &surf->menu.items[pos];
+    tic_screen* screen = NULL;
+    tic_palette* palette = NULL;
 
     gif_image* image = gif_read_data(cover, size);
 
     if(image)
     {
-        item->cover = malloc(sizeof(tic_screen));
-        item->palette = malloc(sizeof(tic_palette));
+        screen = calloc(1, sizeof(tic_screen));
+        palette = calloc(1, sizeof(tic_palette));
 
         if (image->width == TIC80_WIDTH 
             && image->height == TIC80_HEIGHT 
             && image->colors <= TIC_PALETTE_SIZE)
         {
-            memcpy(item->palette, image->palette, image->colors * sizeof(tic_rgb));
+            memcpy(palette, image->palette, image->colors * sizeof(tic_rgb));
 
             for(s32 i = 0; i < TIC80_WIDTH * TIC80_HEIGHT; i++)
-                tic_tool_poke4(item->cover->data, i, image->buffer[i]);
-        }
-        else
-        {
-            memset(item->cover, 0, sizeof(tic_screen));
-            memset(item->palette, 0, sizeof(tic_palette));
+                tic_tool_poke4(screen->data, i, image->buffer[i]);
         }
 
         gif_close(image);
     }
+
+    tic_covers_put(getCovers(surf->studio), hash, screen, palette);
 }
 
 typedef struct
 {
     Surf* surf;
     s32 pos;
+    char hash[TICNAME_MAX];
     char cachePath[TICNAME_MAX];
     char dir[TICNAME_MAX];
 } CoverLoadingData;
 
+static void coverDone(Surf* surf, const CoverLoadingData* data)
+{
+    char dir[TICNAME_MAX];
+    tic_fs_dir(surf->fs, dir);
+
+    if(strcmp(dir, data->dir) == 0 && data->pos < surf->menu.count)
+    {
+        SurfItem* item = &surf->menu.items[data->pos];
+
+        if(item->hash && strcmp(item->hash, data->hash) == 0)
+            item->coverLoading = false;
+    }
+}
+
 static void coverLoaded(const net_get_data* netData)
 {
     CoverLoadingData* coverLoadingData = netData->calldata;
@@ -332,18 +342,14 @@ static void coverLoaded(const net_get_data* netData)
     if (netData->type == net_get_done)
     {
         tic_fs_saveroot(surf->fs, coverLoadingData->cachePath, netData->done.data, netData->done.size, false);
-
-        char dir[TICNAME_MAX];
-        tic_fs_dir(surf->fs, dir);
-
-        if(strcmp(dir, coverLoadingData->dir) == 0)
-            updateMenuItemCover(surf, coverLoadingData->pos, netData->done.data, netData->done.size);
+        updateCover(surf, coverLoadingData->hash, netData->done.data, netData->done.size);
     }
 
     switch (netData->type)
     {
     case net_get_done:
     case net_get_error:
+        coverDone(surf, coverLoadingData);
         free(coverLoadingData);
         break;
     default: break;
@@ -357,16 +363,20 @@ static void requestCover(Surf* surf, SurfItem* item)
     tic_fs_dir(surf->fs, coverLoadingData.dir);
 
     const char* hash = item->hash;
+    strncpy(coverLoadingData.hash, hash, sizeof coverLoadingData.hash - 1);
     sprintf(coverLoadingData.cachePath, TIC_CACHE "%s.gif", hash);
 
     {
         s32 size = 0;
         void* data = tic_fs_loadroot(surf->fs, coverLoadingData.cachePath, &size);
 
+        // the cover of the same cart doesn't change, the evicted ones come from the disk
         if (data)
         {
-            updateMenuItemCover(surf, surf->menu.pos, data, size);
+            updateCover(surf, hash, data, size);
+            coverDone(surf, &coverLoadingData);
             free(data);
+            return;
         }
     }
 
@@ -376,6 +386,33 @@ static void requestCover(Surf* surf, SurfItem* item)
     tic_net_get(surf->net, path, coverLoaded, MOVE(coverLoadingData));
 }
 
+// the cache key, the cart hash for the online carts and the path for the local ones
+static bool coverKey(Surf* surf, const SurfItem* item, char* key)
+{
+    if(!tic_fs_ispubdir(surf->fs))
+    {
+        char dir[TICNAME_MAX];
+        tic_fs_dir(surf->fs, dir);
+        snprintf(key, TICNAME_MAX, "%s%s%s", dir, *dir ? "/" : "", item->name);
+    }
+    else if(item->hash)
+        snprintf(key, TICNAME_MAX, "%s", item->hash);
+    else return false;
+
+    return true;
+}
+
+static const tic_screen* getCover(Surf* surf, const tic_palette** palette)
+{
+    const tic_screen* cover = NULL;
+    char key[TICNAME_MAX];
+
+    if(coverKey(surf, getMenuItem(surf), key))
+        tic_covers_get(getCovers(surf->studio), key, &cover, palette);
+
+    return cover;
+}
+
 static void loadCover(Surf* surf)
 {
     //printf("\nsurf.c loadCover Called");
@@ -386,53 +423,45 @@ static void loadCover(Surf* surf)
     if(item->coverLoading)
         return;
 
-    item->coverLoading = true;
+    char key[TICNAME_MAX];
+
+    // evicted covers are loaded again
+    if(!coverKey(surf, item, key) || tic_covers_get(getCovers(surf->studio), key, NULL, NULL))
+        return;
 
     if(!tic_fs_ispubdir(surf->fs))
     {
+        tic_screen* cover = NULL;
+        tic_palette* palette = NULL;
 
         s32 size = 0;
         void* data = tic_fs_load(surf->fs, item->name, &size);
 
         if(data)
         {
-            tic_cartridge* cart = (tic_cartridge*)malloc(sizeof(tic_cartridge));
+            tic_cart_info* info = malloc(sizeof(tic_cart_info));
 
-            if(cart)
+            if(info)
             {
+                loadCartInfo(info, item->name, data, size);
 
-                if(tic_tool_has_ext(item->name, PngExt))
+                if(!EMPTY(info->screen.data) && !EMPTY(info->palette.data))
                 {
-                    tic_cartridge* pngcart = loadPngCart((png_buffer){data, size});
-
-                    if(pngcart)
-                    {
-                        memcpy(cart, pngcart, sizeof(tic_cartridge));
-                        free(pngcart);
-                    }
-                    else memset(cart, 0, sizeof(tic_cartridge));
-                }
-#if defined(TIC80_PRO)
-                else if(tic_project_ext(item->name))
-                    tic_project_load(item->name, data, size, cart);
-#endif
-                else
-                    tic_cart_load(cart, data, size);
-
-                if(!EMPTY(cart->bank0.screen.data) && !EMPTY(cart->bank0.palette.vbank0.data))
-                {
-                    memcpy((item->palette = malloc(sizeof(tic_palette))), &cart->bank0.palette.vbank0, sizeof(tic_palette));
-                    memcpy((item->cover = malloc(sizeof(tic_screen))), &cart->bank0.screen, sizeof(tic_screen));
+                    palette = MOVE(info->palette);
+                    cover = MOVE(info->screen);
                 }
 
-                free(cart);
+                free(info);
             }
 
             free(data);
         }
+
+        tic_covers_put(getCovers(surf->studio), key, cover, palette);
     }
-    else if(item->hash && !item->cover)
+    else
     {
+        item->coverLoading = true;
         requestCover(surf, item);    
     }
 }
@@ -749,7 +778,7 @@ static void tick(Surf* surf)
     {
         loadCover(surf);
 
-        tic_screen* cover = getMenuItem(surf)->cover;
+        const tic_screen* cover = getCover(surf, NULL);
 
         if(cover)
             memcpy(tic->ram->vram.screen.data, cover->data, sizeof(tic_screen));
@@ -787,18 +816,20 @@ static void scanline(tic_mem* tic, s32 row, void* data)
 
     if(surf->menu.count > 0)
     {
-        const SurfItem* item = getMenuItem(surf);
-
-        if(item->palette)
+        if(row == 0)
         {
-            if(row == 0)
+            const tic_palette* palette = NULL;
+            getCover(surf, &palette);
+
+            if((surf->palette = palette != NULL))
             {
-                memcpy(&tic->ram->vram.palette, item->palette, sizeof(tic_palette));
+                memcpy(&tic->ram->vram.palette, palette, sizeof(tic_palette));
                 fadePalette(&tic->ram->vram.palette, surf->anim.val.coverFade);
             }
+        }
 
+        if(surf->palette)
             return;
-        }
     }
 
     studio_menu_anim_scanline(tic, row, NULL);
@@ -36,6 +36,8 @@ struct Surf
 
     bool init;
     bool loading;
+    // the highlighted cart has a palette, looked up on the first scanline
+    bool palette;
     s32 ticks;
 
     struct
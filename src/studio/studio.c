@@ -51,6 +51,11 @@
 #include "screens/mainmenu.h"
 
 #include "fs.h"
+#include "covers.h"
+
+#if defined(TIC80_PRO)
+#include "project.h"
+#endif
 
 #include "argparse.h"
 
@@ -134,6 +139,9 @@ struct Studio
     {
         CartHash hash;
         u64 mdate;
+        // the cart folder is watched, the date is read only when it reports a change
+        tic_fs_watch* watch;
+        char watched[TICNAME_MAX];
     }cart;
 
     struct
@@ -208,6 +216,7 @@ struct Studio
     Launcher*   launcher;
 
     tic_net* net;
+    tic_covers* covers;
 #endif
 
     Start*      start;
@@ -220,6 +229,11 @@ struct Studio
     tic_fs* fs;
     s32 samplerate;
     tic_font systemFont;
+
+    struct
+    {
+        bool overlay;
+    } perf;
 };
 
 #if defined(BUILD_EDITORS)
@@ -1005,6 +1019,8 @@ static void drawPopup(Studio* studio)
             for(s32 i = 0, y = 0; y < (Height + studio->anim.pos.popup); y++, dst += TIC80_MARGIN_RIGHT + TIC80_MARGIN_LEFT)
                 for(s32 x = 0; x < Width; x++)
                 *dst++ = tic_rgba(&bank->palette.vbank0.colors[tic_tool_peek4(tic->ram->vram.screen.data, i++)]);
+
+            tic_core_invalidate_rows(tic, TIC80_MARGIN_TOP, TIC80_MARGIN_TOP + Height + studio->anim.pos.popup);
         }        
     }
 }
@@ -1521,10 +1537,45 @@ static void updateHash(Studio* studio)
     md5(&studio->tic->cart, sizeof(tic_cartridge), studio->cart.hash.data);
 }
 
+static void watchCart(Studio* studio)
+{
+    const char* path = studio->console->rom.path;
+
+    if(strcmp(studio->cart.watched, path) == 0)
+        return;
+
+    if(studio->cart.watch)
+    {
+        tic_fs_watch_close(studio->cart.watch);
+        studio->cart.watch = NULL;
+    }
+
+    strncpy(studio->cart.watched, path, sizeof studio->cart.watched - 1);
+
+    // editors save by renaming a new file over the cart, so the folder is watched, not the file
+    char dir[TICNAME_MAX];
+    strncpy(dir, path, sizeof dir - 1);
+    dir[sizeof dir - 1] = '\0';
+
+    char* name = strrchr(dir, '/');
+
+    if(name)
+    {
+        name[1] = '\0';
+
+        if((studio->cart.watch = tic_fs_watch_create(dir)) && !tic_fs_watch_add(studio->cart.watch, ""))
+        {
+            tic_fs_watch_close(studio->cart.watch);
+            studio->cart.watch = NULL;
+        }
+    }
+}
+
 static void updateMDate(Studio* studio)
 {
     printf("\nstudio.c updateMDate Called");
     studio->cart.mdate = fs_date(studio->console->rom.path);
+    watchCart(studio);
 }
 #endif
 
@@ -1566,6 +1617,41 @@ tic_cartridge* loadPngCart(png_buffer buffer)
     return NULL;
 }
 
+static void cartInfo(tic_cart_info* info, const tic_cartridge* cart)
+{
+    memset(info, 0, sizeof(tic_cart_info));
+    info->screen = cart->bank0.screen;
+    info->palette = cart->bank0.palette.vbank0;
+    info->lang = cart->lang;
+    strncpy(info->code, cart->code.data, sizeof info->code - 1);
+}
+
+void loadCartInfo(tic_cart_info* info, const char* name, const void* data, s32 size)
+{
+    tic_cartridge* cart = NULL;
+
+#if defined(TIC80_PRO)
+    if(tic_project_ext(name))
+    {
+        cart = calloc(1, sizeof(tic_cartridge));
+        tic_project_load(name, data, size, cart);
+    }
+    else
+#endif
+    if(tic_cart_peek(info, data, size))
+        return;
+    // PNG cover without cart chunk, the cart is hidden in the pixels
+    else if(tic_tool_has_ext(name, PNG_EXT))
+        cart = loadPngCart((png_buffer){(u8*)data, size});
+
+    if(cart)
+    {
+        cartInfo(info, cart);
+        free(cart);
+    }
+    else memset(info, 0, sizeof(tic_cart_info));
+}
+
 void studioRomSaved(Studio* studio)
 {
     printf("\nstudio.c studioRomSaved Called");
@@ -1900,6 +1986,20 @@ static void reloadConfirm(Studio* studio, bool yes, void* data)
         updateMDate(studio);
 }
 
+typedef struct
+{
+    const char* name;
+    bool changed;
+} CartWatchData;
+
+static void onCartEvent(fs_watch_event event, const char* path, bool dir, void* data)
+{
+    CartWatchData* watchData = data;
+
+    if(event == fs_watch_overflow || (!dir && strcmp(path, watchData->name) == 0))
+        watchData->changed = true;
+}
+
 static void checkChanges(Studio* studio)
 {
     switch(studio->mode)
@@ -1910,6 +2010,15 @@ static void checkChanges(Studio* studio)
         {
             Console* console = studio->console;
 
+            if(studio->cart.watch)
+            {
+                CartWatchData data = {strrchr(studio->cart.watched, '/') + 1};
+                tic_fs_watch_poll(studio->cart.watch, onCartEvent, &data);
+
+                if(!data.changed)
+                    break;
+            }
+
             u64 date = fs_date(console->rom.path);
 
             if(studio->cart.mdate && date > studio->cart.mdate)
@@ -2158,6 +2267,8 @@ void studioConfigChanged(Studio* studio)
     if(code->update)
         code->update(code);
 
+    tic_covers_budget(studio->covers, studio->config->data.coverCache * 1024);
+
     s32 scale = studio->config->data.uiScale;
     studio->video.buffer = realloc(studio->video.buffer, TIC80_FULLWIDTH * scale * TIC80_FULLHEIGHT * scale * sizeof(u32));
 #endif
@@ -2233,6 +2344,8 @@ static void blitCursor(Studio* studio)
         tic_point s = {m->x - hot.x, m->y - hot.y};
         u32* dst = tic->product.screen + TIC80_FULLWIDTH * s.y + s.x;
 
+        tic_core_invalidate_rows(tic, s.y, s.y + TIC_SPRITESIZE);
+
         for(s32 y = s.y, endy = MIN(y + TIC_SPRITESIZE, TIC80_FULLHEIGHT), i = 0; y != endy; ++y, dst += TIC80_FULLWIDTH - TIC_SPRITESIZE)
             for(s32 x = s.x, endx = x + TIC_SPRITESIZE; x != endx; ++x, ++i, ++dst)
                 if(x < TIC80_FULLWIDTH)
@@ -2244,11 +2357,105 @@ static void blitCursor(Studio* studio)
     }
 }
 
+static void drawPerfText(Studio* studio, s32 x, s32 y, const char* text, u32 color)
+{
+    const tic_font_data* font = &studio->systemFont.regular;
+
+    for(const char* c = text; *c; ++c, x += TIC_FONT_WIDTH)
+        for(s32 row = 0; row < TIC_FONT_HEIGHT; ++row)
+        {
+            u8 bits = font->data[(u8)*c * BITS_IN_BYTE + row];
+            u32* dst = studio->tic->product.screen + (y + row) * TIC80_FULLWIDTH + x;
+
+            for(s32 col = 0; col < TIC_FONT_WIDTH; ++col)
+                if(bits & (1 << col))
+                    dst[col] = color;
+        }
+}
+
+// drawn over the final image after the blit, so it never ends up in the cart's vram
+static void drawPerfOverlay(Studio* studio)
+{
+    tic_mem* tic = studio->tic;
+
+    if(!studio->perf.overlay || !tic_core_perf_enabled(tic))
+        return;
+
+    enum
+    {
+        Frames = TIC80_FRAMERATE / 2,
+        Rows = TIC80_PERF_PHASES + 1,
+        LineHeight = TIC_FONT_HEIGHT + 1,
+        Width = 10 * TIC_FONT_WIDTH + 1,
+        Height = Rows * LineHeight + 1,
+        Left = TIC80_MARGIN_LEFT + TIC80_WIDTH - Width,
+        Top = TIC80_MARGIN_TOP,
+    };
+
+    static const char* Names[TIC80_PERF_PHASES] = {"scr", "drw", "scn", "blt", "snd", "std", "upl"};
+
+    tic80_perf_frame frames[Frames];
+    s32 count = tic_core_perf_frames(tic, frames, Frames);
+
+    if(!count)
+        return;
+
+    const tic_palette* pal = &getConfig(studio)->cart->bank0.palette.vbank0;
+    u32 bg = tic_rgba(&pal->colors[tic_color_black]);
+
+    for(s32 y = Top; y < Top + Height; ++y)
+        for(s32 x = Left; x < Left + Width; ++x)
+            tic->product.screen[y * TIC80_FULLWIDTH + x] = bg;
+
+    u64 total = 0;
+
+    for(s32 phase = 0; phase <= TIC80_PERF_PHASES; ++phase)
+    {
+        u64 ns = 0;
+
+        if(phase < TIC80_PERF_PHASES)
+        {
+            for(s32 i = 0; i < count; ++i)
+                ns += frames[i].ns[phase];
+
+            total += ns;
+        }
+        else ns = total;
+
+        double ms = ns / 1e6 / count;
+        u8 color = phase < TIC80_PERF_PHASES ? tic_color_white 
+            : ms > 1000.0 / TIC80_FRAMERATE ? tic_color_red : tic_color_green;
+
+        char text[16];
+        snprintf(text, sizeof text, "%s%6.2f", phase < TIC80_PERF_PHASES ? Names[phase] : "all", ms);
+        drawPerfText(studio, Left + 1, Top + 1 + phase * LineHeight, text, tic_rgba(&pal->colors[color]));
+    }
+
+    tic_core_invalidate_rows(tic, Top, Top + Height);
+}
+
+void setStudioPerfOverlay(Studio* studio, bool show)
+{
+    studio->perf.overlay = show;
+}
+
+bool getStudioPerfOverlay(Studio* studio)
+{
+    return studio->perf.overlay;
+}
+
 tic_mem* getMemory(Studio* studio)
 {
     return studio->tic;
 }
 
+#if defined(BUILD_EDITORS)
+tic_covers* getCovers(Studio* studio)
+{
+    return studio->covers;
+}
+#endif
+
 const tic_mem* studio_mem(Studio* studio)
 {
     return getMemory(studio);
@@ -2260,6 +2467,8 @@ void studio_tick(Studio* studio, tic80_input input)
     tic_mem* tic = studio->tic;
     tic->ram->input = input;
 
+    s32 phase = tic_core_perf_begin(tic, TIC80_PERF_STUDIO);
+
 #if defined(BUILD_EDITORS)
     processAnim(studio->anim.movie, studio);
     checkChanges(studio);
@@ -2312,11 +2521,15 @@ void studio_tick(Studio* studio, tic80_input input)
 
         drawPopup(studio);
 #endif
+
+        drawPerfOverlay(studio);
     }
 
 #if defined(BUILD_EDITORS)
     tic_net_end(studio->net);
 #endif
+
+    tic_core_perf_end(tic, phase);
 }
 
 void studio_sound(Studio* studio)
@@ -2406,6 +2619,10 @@ void studio_delete(Studio* studio)
         freeWorld   (studio->world);
         freeSurf    (studio->surf);
         freeLauncher(studio->launcher);
+        tic_covers_close(studio->covers);
+
+        if(studio->cart.watch)
+            tic_fs_watch_close(studio->cart.watch);
 
         FREE(studio->anim.show.items);
         FREE(studio->anim.hide.items);
@@ -2580,6 +2797,7 @@ Studio* studio_create(s32 argc, char **argv, s32 samplerate, tic80_pixel_color_f
         studio->world      = calloc(1, sizeof(World));
         studio->surf       = calloc(1, sizeof(Surf));
         studio->launcher   = calloc(1, sizeof(Launcher));
+        studio->covers     = tic_covers_create(TIC_COVER_CACHE * 1024);
 
         studio->anim.show = (Movie)MOVIE_DEF(STUDIO_ANIM_TIME, setPopupWait,
         {
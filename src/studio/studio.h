@@ -35,6 +35,7 @@
 #include "system.h"
 #include "anim.h"
 #include "ext/png.h"
+#include "cart.h"
 
 #define KEYBOARD_HOLD 20
 #define KEYBOARD_PERIOD 3
@@ -42,6 +43,8 @@
 #define TIC_LOCAL ".local/"
 #define TIC_LOCAL_VERSION TIC_LOCAL TIC_VERSION_HASH "/"
 #define TIC_CACHE TIC_LOCAL "cache/"
+// KB
+#define TIC_COVER_CACHE (4 * 1024)
 
 #define TOOLBAR_SIZE 7
 #define STUDIO_TEXT_WIDTH (TIC_FONT_WIDTH)
@@ -196,6 +199,8 @@ void drawToolbar(Studio* studio, tic_mem* tic, bool bg);
 void drawBitIcon(Studio* studio, s32 id, s32 x, s32 y, u8 color);
 
 tic_cartridge* loadPngCart(png_buffer buffer);
+// reads the cover, palette, language and code header without loading the whole cart
+void loadCartInfo(tic_cart_info* info, const char* name, const void* data, s32 size);
 void studioRomLoaded(Studio* studio);
 void studioRomSaved(Studio* studio);
 void studioConfigChanged(Studio* studio);
@@ -208,6 +213,9 @@ void setStudioViMode(Studio* studio, ViMode mode);
 ViMode getStudioViMode(Studio* studio);
 bool checkStudioViMode(Studio* studio, ViMode mode);
 
+void setStudioPerfOverlay(Studio* studio, bool show);
+bool getStudioPerfOverlay(Studio* studio);
+
 void toClipboard(const void* data, s32 size, bool flip);
 bool fromClipboard(void* data, s32 size, bool flip, bool remove_white_spaces, bool sameSize);
 
@@ -271,6 +279,7 @@ const char* studioExportMusic(Studio* studio, s32 track, s32 bank, const char* f
 const char* studioExportSfx(Studio* studio, s32 sfx, const char* filename);
 
 tic_mem* getMemory(Studio* studio);
+struct tic_covers* getCovers(Studio* studio);
 
 const char* md5str(const void* data, s32 length);
 void sfx_stop(tic_mem* tic, s32 channel);
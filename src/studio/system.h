@@ -143,6 +143,8 @@ typedef struct
     const tic_cartridge* cart;
 
     s32 uiScale;
+    // launcher and surf covers memory, KB
+    s32 coverCache;
 
 } StudioConfig;
 
@@ -0,0 +1,370 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <tic80.h>
+#include "api.h"
+
+#define TIC80_EXECUTABLE_NAME "tic80-bench"
+#define TIC80_DEFAULT_FRAMES 600
+
+// the fake clock advances exactly one frame per tick, so every run sees the same time()
+#define FAKE_FREQ 1000000
+
+// bunnymarks add this many bunnies for every frame the first button is held
+#define BUNNIES_PER_FRAME 5
+// the ramp stops once the median of this many frames misses the 60 fps budget
+#define RAMP_WINDOW 30
+#define RAMP_MAX_FRAMES 20000
+
+#define FRAME_BUDGET_NS (1000000000ull / TIC80_FRAMERATE)
+
+enum
+{
+    PhaseTick,
+    PhaseBlit,
+    PhaseSound,
+    PhaseFrame,
+    PhasesCount,
+};
+
+static const char* PhaseNames[] = {"tick", "blit", "sound", "frame"};
+
+static struct
+{
+    s32 frame;
+    bool quit;
+    char error[256];
+} state;
+
+static u64 fakeCounter(void* data)
+{
+    return (u64)state.frame * FAKE_FREQ / TIC80_FRAMERATE;
+}
+
+static u64 fakeFreq(void* data)
+{
+    return FAKE_FREQ;
+}
+
+static void onTrace(void* data, const char* text, u8 color) {}
+
+static void onError(void* data, const char* info)
+{
+    snprintf(state.error, sizeof state.error, "%s", info);
+    state.quit = true;
+}
+
+static void onExit(void* data)
+{
+    state.quit = true;
+}
+
+static u64 nanos()
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (u64)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static s32 compareU64(const void* a, const void* b)
+{
+    u64 x = *(const u64*)a, y = *(const u64*)b;
+    return (x > y) - (x < y);
+}
+
+// sorts a copy, the ramp window is a ring and has to keep its order
+static u64 percentile(const u64* samples, s32 count, s32 pct)
+{
+    u64* sorted = malloc(sizeof *sorted * count);
+    memcpy(sorted, samples, sizeof *sorted * count);
+    qsort(sorted, count, sizeof *sorted, compareU64);
+
+    u64 value = sorted[MIN(count - 1, count * pct / 100)];
+    free(sorted);
+
+    return value;
+}
+
+static void* loadFile(const char* path, s32* size)
+{
+    FILE* file = fopen(path, "rb");
+    void* data = NULL;
+
+    if(file)
+    {
+        fseek(file, 0, SEEK_END);
+        *size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        data = malloc(*size);
+        if(data && fread(data, *size, 1, file) != 1)
+        {
+            free(data);
+            data = NULL;
+        }
+
+        fclose(file);
+    }
+
+    return data;
+}
+
+// one frame split into the phases tic80_tick() runs, plus the sound synthesis
+static void stepFrame(tic_mem* tic, tic80_input input, u64 times[PhasesCount])
+{
+    tic_tick_data tickData =
+    {
+        .error = onError,
+        .trace = onTrace,
+        .exit = onExit,
+        .data = tic,
+        .counter = fakeCounter,
+        .freq = fakeFreq,
+    };
+
+    u64 start = nanos();
+
+    tic->ram->input = input;
+    tic_core_tick_start(tic);
+    tic_core_tick(tic, &tickData);
+    tic_core_tick_end(tic);
+
+    u64 ticked = nanos();
+    tic_core_blit(tic);
+
+    u64 blitted = nanos();
+    tic_core_synth_sound(tic);
+
+    u64 end = nanos();
+
+    times[PhaseTick] = ticked - start;
+    times[PhaseBlit] = blitted - ticked;
+    times[PhaseSound] = end - blitted;
+    times[PhaseFrame] = end - start;
+}
+
+static void printStats(FILE* out, const u64* samples, s32 count)
+{
+    u64 total = 0;
+    for(s32 i = 0; i < count; i++)
+        total += samples[i];
+
+    fprintf(out, "{\"mean\": %llu, ", (unsigned long long)(total / count));
+    fprintf(out, "\"p50\": %llu, ", (unsigned long long)percentile(samples, count, 50));
+    fprintf(out, "\"p95\": %llu, ", (unsigned long long)percentile(samples, count, 95));
+    fprintf(out, "\"p99\": %llu}", (unsigned long long)percentile(samples, count, 99));
+}
+
+static void printString(FILE* out, const char* str)
+{
+    fputc('"', out);
+
+    for(; *str; str++)
+    {
+        if(*str == '"' || *str == '\\') fprintf(out, "\\%c", *str);
+        else if((u8)*str < ' ') fprintf(out, "\\u%04x", (u8)*str);
+        else fputc(*str, out);
+    }
+
+    fputc('"', out);
+}
+
+static const char* cartName(const char* path)
+{
+    const char* name = path;
+
+    for(const char* ptr = path; *ptr; ptr++)
+        if(*ptr == '/' || *ptr == '\\')
+            name = ptr + 1;
+
+    return name;
+}
+
+// runs the cart for a fixed number of frames without input and, for bunnymarks,
+// ramps the bunnies up until a frame no longer fits the 60 fps budget
+static bool benchCart(FILE* out, const char* path, s32 frames, bool ramp)
+{
+    s32 size = 0;
+    void* cart = loadFile(path, &size);
+
+    // every cart gets an entry, the separators are written before they run
+    if(!cart)
+    {
+        fprintf(stderr, "Error: Could not load %s.\n", path);
+
+        fprintf(out, "    {\"cart\": ");
+        printString(out, cartName(path));
+        fprintf(out, ", \"error\": \"could not load the cart\"}");
+
+        return false;
+    }
+
+    tic_mem* tic = tic_core_create(TIC80_SAMPLERATE, TIC80_PIXEL_COLOR_RGBA8888);
+    tic80_load((tic80*)tic, cart, size);
+    free(cart);
+
+    memset(&state, 0, sizeof state);
+
+    u64* samples[PhasesCount];
+    for(s32 p = 0; p < PhasesCount; p++)
+        samples[p] = malloc(sizeof(u64) * frames);
+
+    tic80_input input = {0};
+    s32 count = 0;
+
+    for(; count < frames && !state.quit; count++, state.frame++)
+    {
+        u64 times[PhasesCount];
+        stepFrame(tic, input, times);
+
+        for(s32 p = 0; p < PhasesCount; p++)
+            samples[p][count] = times[p];
+    }
+
+    s32 bunnies = -1;
+
+    if(ramp && !state.quit)
+    {
+        u64 window[RAMP_WINDOW];
+        input.gamepads.first.up = 1;
+
+        for(s32 held = 0; held < RAMP_MAX_FRAMES && !state.quit; held++, state.frame++)
+        {
+            u64 times[PhasesCount];
+            stepFrame(tic, input, times);
+            window[held % RAMP_WINDOW] = times[PhaseFrame];
+
+            bunnies = (held + 1) * BUNNIES_PER_FRAME;
+
+            if(held + 1 >= RAMP_WINDOW && percentile(window, RAMP_WINDOW, 50) > FRAME_BUDGET_NS)
+            {
+                bunnies = (held + 1 - RAMP_WINDOW) * BUNNIES_PER_FRAME;
+                break;
+            }
+        }
+    }
+
+    fprintf(out, "    {\"cart\": ");
+    printString(out, cartName(path));
+    fprintf(out, ", \"frames\": %d", count);
+
+    if(count)
+    {
+        fprintf(out, ", \"ns_per_frame\": ");
+        printStats(out, samples[PhaseFrame], count);
+
+        fprintf(out, ", \"phases\": {");
+        for(s32 p = 0; p < PhaseFrame; p++)
+        {
+            fprintf(out, "%s\"%s\": ", p ? ", " : "", PhaseNames[p]);
+            printStats(out, samples[p], count);
+        }
+        fprintf(out, "}");
+    }
+
+    if(bunnies >= 0)
+        fprintf(out, ", \"bunnies_at_60fps\": %d", bunnies);
+
+    if(*state.error)
+    {
+        fprintf(out, ", \"error\": ");
+        printString(out, state.error);
+    }
+
+    fprintf(out, "}");
+
+    for(s32 p = 0; p < PhasesCount; p++)
+        free(samples[p]);
+
+    tic_core_close(tic);
+
+    return true;
+}
+
+static void usage(const char* executable)
+{
+    printf("Usage: %s [options] <cart>...\n\n"
+        "  --frames <n>     frames measured per cart, %d by default\n"
+        "  --ramp           the following carts are bunnymarks, hold the first button\n"
+        "                   after the measured frames until 60 fps can't be sustained\n"
+        "  --json <file>    write the report to a file instead of stdout\n\n"
+        "Times are reported in ns, per frame and per phase (tick, blit, sound).\n",
+        executable, TIC80_DEFAULT_FRAMES);
+}
+
+s32 main(s32 argc, char **argv)
+{
+    const char* executable = argc > 0 ? argv[0] : TIC80_EXECUTABLE_NAME;
+    const char* jsonPath = NULL;
+    s32 frames = TIC80_DEFAULT_FRAMES;
+
+    for(s32 i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--help") == 0 || strcmp(argv[i], "-h") == 0)
+            return usage(executable), 0;
+        else if(strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if(strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+        {
+            frames = atoi(argv[++i]);
+            frames = MAX(frames, 1);
+        }
+    }
+
+    FILE* out = jsonPath ? fopen(jsonPath, "w") : stdout;
+
+    if(!out)
+    {
+        fprintf(stderr, "Error: Could not write %s.\n", jsonPath);
+        return 1;
+    }
+
+    fprintf(out, "{\n  \"frame_budget_ns\": %llu,\n  \"carts\": [\n", FRAME_BUDGET_NS);
+
+    bool ramp = false, first = true, ok = true;
+
+    for(s32 i = 1; i < argc; i++)
+    {
+        if(strcmp(argv[i], "--json") == 0 || strcmp(argv[i], "--frames") == 0)
+            i++;
+        else if(strcmp(argv[i], "--ramp") == 0)
+            ramp = true;
+        else if(argv[i][0] != '-')
+        {
+            if(!first) fprintf(out, ",\n");
+            ok &= benchCart(out, argv[i], frames, ramp);
+            first = false;
+        }
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+
+    if(out != stdout)
+        fclose(out);
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,306 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <tic80.h>
+#include "api.h"
+
+#define TIC80_EXECUTABLE_NAME "tic80-headless"
+#define TIC80_DEFAULT_FRAMES 600
+
+// the fake clock advances exactly one frame per tick, so carts reading time() stay deterministic
+#define FAKE_FREQ 1000000
+
+static struct
+{
+    s32 frame;
+    bool quit;
+    bool failed;
+} state;
+
+static u64 fakeCounter()
+{
+    return (u64)state.frame * FAKE_FREQ / TIC80_FRAMERATE;
+}
+
+static u64 fakeFreq()
+{
+    return FAKE_FREQ;
+}
+
+static void onTrace(const char* text, u8 color)
+{
+    fprintf(stderr, "%s\n", text);
+}
+
+static void onError(const char* info)
+{
+    fprintf(stderr, "frame %d: %s\n", state.frame, info);
+    state.failed = state.quit = true;
+}
+
+static void onExit()
+{
+    state.quit = true;
+}
+
+static double now()
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static u64 hash(const void* data, size_t size, u64 value)
+{
+    const u8* ptr = data;
+
+    // FNV-1a
+    while(size--)
+        value = (value ^ *ptr++) * 0x100000001b3ull;
+
+    return value;
+}
+
+static void* loadFile(const char* path, s32* size)
+{
+    FILE* file = fopen(path, "rb");
+    void* data = NULL;
+
+    if(file)
+    {
+        fseek(file, 0, SEEK_END);
+        *size = ftell(file);
+        fseek(file, 0, SEEK_SET);
+
+        data = malloc(*size + 1);
+        if(data && fread(data, *size, 1, file) != 1 && *size)
+        {
+            free(data);
+            data = NULL;
+        }
+
+        fclose(file);
+    }
+
+    return data;
+}
+
+typedef struct
+{
+    s32 frame;
+    tic80_input input;
+} ScriptEntry;
+
+// input script lines are '<frame> <gamepads> [<keyboard>]', every entry is held until the next one
+static ScriptEntry* parseScript(char* text, s32* count)
+{
+    ScriptEntry* entries = NULL;
+    *count = 0;
+
+    for(char* line = strtok(text, "\r\n"); line; line = strtok(NULL, "\r\n"))
+    {
+        char* ptr = line;
+        while(*ptr == ' ' || *ptr == '\t') ptr++;
+
+        if(*ptr == '\0' || *ptr == '#')
+            continue;
+
+        ScriptEntry entry = {0};
+        entry.frame = strtol(ptr, &ptr, 0);
+        entry.input.gamepads.data = strtoul(ptr, &ptr, 0);
+        entry.input.keyboard.data = strtoul(ptr, &ptr, 0);
+
+        entries = realloc(entries, sizeof(ScriptEntry) * (*count + 1));
+        entries[(*count)++] = entry;
+    }
+
+    return entries;
+}
+
+static void usage(const char* executable)
+{
+    printf("Usage: %s <cart> [options]\n\n"
+        "  --frames <n>     frames to run, %d by default\n"
+        "  --input <file>   recorded input, raw tic80_input records, one per frame\n"
+        "  --script <file>  scripted input, '<frame> <gamepads> [<keyboard>]' lines\n"
+        "  --summary        print only the final hashes\n"
+        "  --trace <file>   save api call stats as chrome trace json, the last frames and totals\n\n"
+        "Prints '<frame> <vram hash> <audio hash>' per frame, timing goes to stderr.\n",
+        executable, TIC80_DEFAULT_FRAMES);
+}
+
+s32 main(s32 argc, char **argv)
+{
+    const char* executable = argc > 0 ? argv[0] : TIC80_EXECUTABLE_NAME;
+    const char* cartPath = NULL;
+    const char* inputPath = NULL;
+    const char* scriptPath = NULL;
+    const char* tracePath = NULL;
+    s32 frames = TIC80_DEFAULT_FRAMES;
+    bool summary = false;
+
+    for(s32 i = 1; i < argc; i++)
+    {
+        const char* arg = argv[i];
+        bool value = i + 1 < argc;
+
+        if(strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0)
+            return usage(executable), 0;
+        else if(strcmp(arg, "--frames") == 0 && value)
+            frames = atoi(argv[++i]);
+        else if(strcmp(arg, "--input") == 0 && value)
+            inputPath = argv[++i];
+        else if(strcmp(arg, "--script") == 0 && value)
+            scriptPath = argv[++i];
+        else if(strcmp(arg, "--trace") == 0 && value)
+            tracePath = argv[++i];
+        else if(strcmp(arg, "--summary") == 0)
+            summary = true;
+        else if(arg[0] != '-' && !cartPath)
+            cartPath = arg;
+        else
+            return usage(executable), 1;
+    }
+
+    if(!cartPath)
+        return usage(executable), 1;
+
+    s32 cartSize = 0;
+    void* cart = loadFile(cartPath, &cartSize);
+    if(!cart)
+    {
+        fprintf(stderr, "Error: Could not load %s.\n", cartPath);
+        return 1;
+    }
+
+    tic80_input* records = NULL;
+    s32 recordsCount = 0;
+
+    if(inputPath)
+    {
+        s32 size = 0;
+        if(!(records = loadFile(inputPath, &size)))
+        {
+            fprintf(stderr, "Error: Could not load %s.\n", inputPath);
+            return 1;
+        }
+
+        recordsCount = size / sizeof(tic80_input);
+    }
+
+    ScriptEntry* script = NULL;
+    s32 scriptCount = 0;
+
+    if(scriptPath)
+    {
+        s32 size = 0;
+        char* text = loadFile(scriptPath, &size);
+        if(!text)
+        {
+            fprintf(stderr, "Error: Could not load %s.\n", scriptPath);
+            return 1;
+        }
+
+        text[size] = '\0';
+        script = parseScript(text, &scriptCount);
+        free(text);
+    }
+
+    tic80* tic = tic80_create(TIC80_SAMPLERATE, TIC80_PIXEL_COLOR_RGBA8888);
+    tic->callback.trace = onTrace;
+    tic->callback.error = onError;
+    tic->callback.exit = onExit;
+    tic80_load(tic, cart, cartSize);
+    free(cart);
+
+    if(tracePath)
+        tic80_api_stats_enable(tic, true);
+
+    const tic_vram* vram = &((tic_mem*)tic)->ram->vram;
+    const u64 Seed = 0xcbf29ce484222325ull;
+
+    tic80_input input = {0};
+    s32 scriptPos = 0;
+    u64 vramHash = Seed, audioHash = Seed;
+    double total = 0, slowest = 0, fastest = 0;
+
+    for(state.frame = 0; state.frame < frames && !state.quit; state.frame++)
+    {
+        if(state.frame < recordsCount)
+            input = records[state.frame];
+        else if(records)
+            memset(&input, 0, sizeof input);
+
+        while(scriptPos < scriptCount && script[scriptPos].frame <= state.frame)
+            input = script[scriptPos++].input;
+
+        double start = now();
+        tic80_tick(tic, input, fakeCounter, fakeFreq);
+        tic80_sound(tic);
+        double elapsed = now() - start;
+
+        total += elapsed;
+        if(state.frame == 0 || elapsed > slowest) slowest = elapsed;
+        if(state.frame == 0 || elapsed < fastest) fastest = elapsed;
+
+        vramHash = hash(vram, sizeof *vram, Seed);
+        audioHash = hash(tic->samples.buffer, tic->samples.count * TIC80_SAMPLESIZE, Seed);
+
+        if(!summary)
+            printf("%d %016llx %016llx\n", state.frame, (unsigned long long)vramHash, (unsigned long long)audioHash);
+    }
+
+    if(summary)
+        printf("%d %016llx %016llx\n", state.frame, (unsigned long long)vramHash, (unsigned long long)audioHash);
+
+    if(state.frame)
+        fprintf(stderr, "%d frames in %.3f s, %.1f fps, frame min %.3f ms, avg %.3f ms, max %.3f ms\n",
+            state.frame, total, state.frame / total, fastest * 1e3, total / state.frame * 1e3, slowest * 1e3);
+
+    if(tracePath)
+    {
+        s32 size = tic80_api_stats_trace(tic, NULL, 0) + 1;
+        char* trace = malloc(size);
+        FILE* file = trace ? fopen(tracePath, "wb") : NULL;
+
+        if(file)
+        {
+            tic80_api_stats_trace(tic, trace, size);
+            fwrite(trace, size - 1, 1, file);
+            fclose(file);
+        }
+        else fprintf(stderr, "Error: Could not write %s.\n", tracePath);
+
+        free(trace);
+    }
+
+    tic80_delete(tic);
+    free(records);
+    free(script);
+
+    return state.failed ? 1 : 0;
+}
@@ -59,6 +59,8 @@ struct tic80_state
 	tic80_input input;
 	int keymap[RETROK_LAST];
 	bool cropBorder;
+	bool canDupe;
+	bool forceFrame;
 	enum pointer_device_type pointerDevice;
 	float pointerSpeed;
 	bool slowGamepadMouse;
@@ -159,6 +161,8 @@ RETRO_API void retro_init(void)
 	state = (struct tic80_state*) malloc(sizeof(struct tic80_state));
 	state->quit = false;
 	state->cropBorder = false;
+	state->canDupe = false;
+	state->forceFrame = true;
 	state->pointerDevice = POINTER_DEVICE_MOUSE;
 	state->pointerSpeed = 1.0f;
 	state->slowGamepadMouse = false;
@@ -850,12 +854,16 @@ void tic80_libretro_draw(tic80* game)
 	// Render the mouse cursor if needed.
 	tic80_libretro_mousecursor((tic80*)game, &state->input.mouse, state->mouseCursor);
 
+	// Let the frontend show the previous frame again when nothing changed.
+	bool dupe = state->canDupe && game->dirty.unchanged && !state->forceFrame;
+	state->forceFrame = false;
+
 	// Render to the screen.
 	if (state->cropBorder) {
 		u32 *screen = (u32*)game->screen + (TIC80_FULLWIDTH * TIC80_OFFSET_TOP) + TIC80_OFFSET_LEFT;
-		video_cb(screen, TIC80_WIDTH, TIC80_HEIGHT, TIC80_FULLWIDTH << 2);
+		video_cb(dupe ? NULL : screen, TIC80_WIDTH, TIC80_HEIGHT, TIC80_FULLWIDTH << 2);
 	} else {
-		video_cb(game->screen, TIC80_FULLWIDTH, TIC80_FULLHEIGHT, TIC80_FULLWIDTH << 2);
+		video_cb(dupe ? NULL : game->screen, TIC80_FULLWIDTH, TIC80_FULLHEIGHT, TIC80_FULLWIDTH << 2);
 	}
 }
 
@@ -895,6 +903,7 @@ void tic80_libretro_variables(bool startup)
 		struct retro_system_av_info av_info;
 		retro_get_system_av_info(&av_info);
 		environ_cb(RETRO_ENVIRONMENT_SET_GEOMETRY, &av_info);
+		state->forceFrame = true;
 	}
 
 	// Pointer device
@@ -1026,6 +1035,12 @@ RETRO_API bool retro_load_game(const struct retro_game_info *info)
 		return false;
 	}
 
+	// Frame duping lets unchanged frames skip the upload.
+	if (!environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &state->canDupe)) {
+		state->canDupe = false;
+	}
+	state->forceFrame = true;
+
 	// Check for the content.
 	if (info == NULL) {
 		log_cb(RETRO_LOG_ERROR, "[TIC-80] No content information provided.\n");
@@ -104,6 +104,7 @@ static struct
     {
         Renderer renderer;
         Texture texture;
+        bool uploaded;
 
 #if defined(CRT_SHADER_SUPPORT)
         u32 shader;
@@ -371,6 +372,52 @@ static void updateTextureBytes(Texture texture, const void* data, s32 width, s32
     }
 }
 
+static void updateTextureRows(Texture texture, const u32* data, s32 width, s32 y, s32 height)
+{
+    data += y * width;
+
+#if defined(CRT_SHADER_SUPPORT)
+    if(!studio_config(platform.studio)->soft)
+    {
+        GPU_Rect rect = {0, (float)y, (float)width, (float)height};
+        GPU_UpdateImageBytes(texture.gpu, &rect, (const u8*)data, width * sizeof(u32));
+    }
+    else
+#endif
+    {
+        SDL_Rect rect = {0, y, width, height};
+        SDL_UpdateTexture(texture.sdl, &rect, data, width * sizeof(u32));
+    }
+}
+
+// uploads only the rows changed by the last blit
+static void updateScreenTexture(const tic80* product)
+{
+    if(!platform.screen.uploaded)
+    {
+        updateTextureBytes(platform.screen.texture, product->screen, TIC80_FULLWIDTH, TIC80_FULLHEIGHT);
+        platform.screen.uploaded = true;
+    }
+    else if(!product->dirty.unchanged)
+    {
+        for(s32 row = 0; row < TIC80_FULLHEIGHT; )
+        {
+            if(!TIC80_DIRTY_ROW(product, row))
+            {
+                row++;
+                continue;
+            }
+
+            s32 end = row + 1;
+            while(end < TIC80_FULLHEIGHT && TIC80_DIRTY_ROW(product, end))
+                end++;
+
+            updateTextureRows(platform.screen.texture, product->screen, TIC80_FULLWIDTH, row, end - row);
+            row = end;
+        }
+    }
+}
+
 #if defined(TOUCH_INPUT_SUPPORT)
 
 static void drawKeyboardLabels(tic_mem* tic, s32 shift)
@@ -570,6 +617,8 @@ static void initGPU()
             SDL_TEXTUREACCESS_STREAMING, TIC80_FULLWIDTH, TIC80_FULLHEIGHT);
     }
 
+    platform.screen.uploaded = false;
+
 #if defined(TOUCH_INPUT_SUPPORT)
     initTouchGamepad();
     initTouchKeyboard();
@@ -1174,6 +1223,10 @@ static void pollEvents()
         case SDL_DROPFILE:
             studio_load(platform.studio, event.drop.file);
             break;
+        case SDL_RENDER_TARGETS_RESET:
+        case SDL_RENDER_DEVICE_RESET:
+            platform.screen.uploaded = false;
+            break;
         case SDL_QUIT:
             studio_exit(platform.studio);
             break;
@@ -1703,7 +1756,12 @@ static void gpuTick()
     }
 
     renderClear(platform.screen.renderer);
-    updateTextureBytes(platform.screen.texture, tic->product.screen, TIC80_FULLWIDTH, TIC80_FULLHEIGHT);
+
+    {
+        u64 start = tic_core_perf_now();
+        updateScreenTexture(&tic->product);
+        tic_core_perf_add((tic_mem*)tic, TIC80_PERF_UPLOAD, tic_core_perf_now() - start);
+    }
 
     SDL_Rect rect;
     calcTextureRect(&rect);
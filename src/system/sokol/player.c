@@ -68,7 +68,7 @@ static void app_frame(void)
         tic80_sound(tic);        
     }
 
-    sokol_gfx_draw(tic->screen);
+    sokol_gfx_draw(tic->dirty.unchanged ? NULL : tic->screen);
 
     static float floatSamples[TIC80_SAMPLERATE * TIC80_SAMPLE_CHANNELS / TIC80_FRAMERATE];
 
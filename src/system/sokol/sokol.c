@@ -179,7 +179,7 @@ static void app_frame(void)
     handleKeyboard();
     studio_tick(platform.studio, platform.input);
 
-    sokol_gfx_draw(product->screen);
+    sokol_gfx_draw(product->dirty.unchanged ? NULL : product->screen);
 
     studio_sound(platform.studio);
     s32 count = product->samples.count;
@@ -210,13 +210,15 @@ static void apply_viewport(void) {
 
 void sokol_gfx_draw(const uint32_t* ptr) {
 
-    /* copy pixel data into the source texture */
-    sg_update_image(sokol_gfx.draw_state.fs_images[0], &(sg_image_content){
-        .subimage[0][0] = { 
-            .ptr = ptr,
-            .size = sokol_gfx.fb_width*sokol_gfx.fb_height*sizeof ptr[0]
-        }
-    });
+    /* copy pixel data into the source texture, NULL keeps the previous frame */
+    if (ptr) {
+        sg_update_image(sokol_gfx.draw_state.fs_images[0], &(sg_image_content){
+            .subimage[0][0] = { 
+                .ptr = ptr,
+                .size = sokol_gfx.fb_width*sokol_gfx.fb_height*sizeof ptr[0]
+            }
+        });
+    }
 
     /* draw to the screen */
     sg_begin_default_pass(&gfx_draw_pass_action, sapp_width(), sapp_height());
@@ -27,6 +27,8 @@
 #include "api.h"
 #include "tools.h"
 #include "cart.h"
+#include "jobs.h"
+#include "core/core.h"
 
 static void onTrace(void* data, const char* text, u8 color)
 {
@@ -99,3 +101,239 @@ TIC80_API void tic80_delete(tic80* tic)
     tic_mem* mem = (tic_mem*)tic;
     tic_core_close(mem);
 }
+
+TIC80_API void tic80_perf_enable(tic80* tic, bool enable)
+{
+    tic_core_perf_enable((tic_mem*)tic, enable);
+}
+
+TIC80_API s32 tic80_perf_frames(tic80* tic, tic80_perf_frame* frames, s32 count)
+{
+    return tic_core_perf_frames((tic_mem*)tic, frames, count);
+}
+
+TIC80_API void tic80_perf_add(tic80* tic, tic80_perf_phase phase, u64 ns)
+{
+    tic_core_perf_add((tic_mem*)tic, phase, ns);
+}
+
+TIC80_API void tic80_api_stats_enable(tic80* tic, bool enable)
+{
+    tic_core_api_stats_enable((tic_mem*)tic, enable);
+}
+
+TIC80_API s32 tic80_api_stats_trace(tic80* tic, char* buffer, s32 size)
+{
+    return tic_core_api_trace((tic_mem*)tic, buffer, size);
+}
+
+typedef struct
+{
+    tic80_batch* batch;
+    s32 from;
+    s32 to;
+} BatchChunk;
+
+struct tic80_batch
+{
+    tic80** instances;
+    s32 count;
+
+    tic80_batch_frame_format format;
+    s32 scale;
+    s32 frameSize;
+    u8* frames;
+
+    tic_jobs* jobs;
+    BatchChunk* chunks;
+    s32 chunksCount;
+
+    // the loaded cart's vm isn't reentrant, step every instance on the calling thread
+    bool serial;
+
+    // arguments of the running step
+    const tic80_input* inputs;
+    CounterCallback counter;
+    FreqCallback freq;
+};
+
+// averages scale x scale blocks of the visible part of an RGBA8888 screen
+static void downscaleFrame(const u32* screen, u8* dst, s32 scale)
+{
+    const u8* src = (const u8*)(screen + TIC80_MARGIN_TOP * TIC80_FULLWIDTH + TIC80_MARGIN_LEFT);
+    const s32 area = scale * scale;
+
+    for(s32 y = 0; y < TIC80_HEIGHT; y += scale)
+        for(s32 x = 0; x < TIC80_WIDTH; x += scale)
+        {
+            u32 r = 0, g = 0, b = 0;
+
+            for(s32 j = 0; j < scale; j++)
+            {
+                const u8* pixel = src + ((y + j) * TIC80_FULLWIDTH + x) * sizeof(u32);
+
+                for(s32 i = 0; i < scale; i++, pixel += sizeof(u32))
+                    r += pixel[0], g += pixel[1], b += pixel[2];
+            }
+
+            *dst++ = r / area;
+            *dst++ = g / area;
+            *dst++ = b / area;
+        }
+}
+
+static void stepBatchChunk(void* data)
+{
+    const BatchChunk* chunk = data;
+    tic80_batch* batch = chunk->batch;
+
+    for(s32 i = chunk->from; i < chunk->to; i++)
+    {
+        tic80* tic = batch->instances[i];
+        tic_mem* mem = (tic_mem*)tic;
+        u8* frame = batch->frames + (size_t)i * batch->frameSize;
+
+        if(batch->inputs)
+            mem->ram->input = batch->inputs[i];
+
+        tic_tick_data tickData = (tic_tick_data)
+        {
+            .error = onError,
+            .trace = onTrace,
+            .exit = onExit,
+            .data = tic,
+            .start = 0,
+            .counter = batch->counter,
+            .freq = batch->freq
+        };
+
+        tic_core_tick_start(mem);
+        tic_core_tick(mem, &tickData);
+        tic_core_tick_end(mem);
+
+        switch(batch->format)
+        {
+        case TIC80_BATCH_FRAME_INDEXED:
+            tic_core_blit_indexed(mem, frame);
+            break;
+        case TIC80_BATCH_FRAME_RGB:
+            tic_core_blit(mem);
+            downscaleFrame(tic->screen, frame, batch->scale);
+            break;
+        }
+    }
+}
+
+TIC80_API tic80_batch* tic80_batch_create(s32 count, s32 samplerate, tic80_batch_frame_format format, s32 scale, s32 threads)
+{
+    if(count <= 0)
+        return NULL;
+
+    if(format == TIC80_BATCH_FRAME_INDEXED)
+        scale = 1;
+    else if(scale != 1 && scale != 2 && scale != 4 && scale != 8)
+        return NULL;
+
+    tic80_batch* batch = calloc(1, sizeof(tic80_batch));
+
+    batch->count = count;
+    batch->format = format;
+    batch->scale = scale;
+    batch->frameSize = format == TIC80_BATCH_FRAME_INDEXED
+        ? TIC80_WIDTH * TIC80_HEIGHT * TIC_PALETTE_BPP / BITS_IN_BYTE
+        : (TIC80_WIDTH / scale) * (TIC80_HEIGHT / scale) * 3;
+    batch->frames = calloc(count, batch->frameSize);
+    batch->instances = malloc(sizeof(tic80*) * count);
+
+    for(s32 i = 0; i < count; i++)
+    {
+        tic_core* core = (tic_core*)tic_core_create(samplerate, TIC80_PIXEL_COLOR_RGBA8888);
+
+        // instances already run in parallel, banded ttri would only oversubscribe the cpus
+        core->tris.enabled = false;
+        batch->instances[i] = &core->memory.product;
+    }
+
+    batch->jobs = tic_jobs_create(threads > 0 ? threads : tic_jobs_cpus());
+
+    // a few chunks per worker to even out carts with uneven frame costs
+    batch->chunksCount = MIN(count, MAX(tic_jobs_count(batch->jobs), 1) * 4);
+    batch->chunks = malloc(sizeof(BatchChunk) * batch->chunksCount);
+
+    for(s32 i = 0; i < batch->chunksCount; i++)
+        batch->chunks[i] = (BatchChunk)
+        {
+            .batch = batch,
+            .from = (s32)((s64)count * i / batch->chunksCount),
+            .to = (s32)((s64)count * (i + 1) / batch->chunksCount),
+        };
+
+    return batch;
+}
+
+TIC80_API void tic80_batch_load(tic80_batch* batch, void* cart, s32 size)
+{
+    tic_mem* first = (tic_mem*)batch->instances[0];
+
+    tic_cart_load(&first->cart, cart, size);
+
+    batch->serial = tic_core_script_config(first)->singleThreaded;
+
+    for(s32 i = 0; i < batch->count; i++)
+    {
+        tic_mem* mem = (tic_mem*)batch->instances[i];
+
+        if(mem != first)
+            mem->cart = first->cart;
+
+        tic_api_reset(mem);
+    }
+}
+
+TIC80_API void tic80_batch_reset(tic80_batch* batch, s32 index)
+{
+    if(index >= 0 && index < batch->count)
+        tic_api_reset((tic_mem*)batch->instances[index]);
+}
+
+TIC80_API tic80* tic80_batch_get(tic80_batch* batch, s32 index)
+{
+    return index >= 0 && index < batch->count ? batch->instances[index] : NULL;
+}
+
+TIC80_API const u8* tic80_batch_step(tic80_batch* batch, const tic80_input* inputs, CounterCallback counter, FreqCallback freq)
+{
+    batch->inputs = inputs;
+    batch->counter = counter;
+    batch->freq = freq;
+
+    if(batch->serial)
+        stepBatchChunk(&(BatchChunk){batch, 0, batch->count});
+    else
+    {
+        for(s32 i = 0; i < batch->chunksCount; i++)
+            tic_jobs_push(batch->jobs, stepBatchChunk, &batch->chunks[i]);
+
+        tic_jobs_wait(batch->jobs);
+    }
+
+    return batch->frames;
+}
+
+TIC80_API s32 tic80_batch_frame_size(const tic80_batch* batch)
+{
+    return batch->frameSize;
+}
+
+TIC80_API void tic80_batch_delete(tic80_batch* batch)
+{
+    tic_jobs_close(batch->jobs);
+
+    for(s32 i = 0; i < batch->count; i++)
+        tic_core_close((tic_mem*)batch->instances[i]);
+
+    free(batch->chunks);
+    free(batch->instances);
+    free(batch->frames);
+    free(batch);
+}
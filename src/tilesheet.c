@@ -30,24 +30,25 @@ static const tic_blit_segment segments[] = {
     //   |  +bank +bank_size
     //   |  |  |  |     +sheet_width
     //   |  |  |  |     |   +tile_width
-        {0, 0, 1, 256,  16, 8,  TIC_SPRITESIZE,   tic_tool_peek1, tic_tool_poke1}, // system gfx
-        {0, 0, 1, 256,  16, 8,  TIC_SPRITESIZE,   tic_tool_peek1, tic_tool_poke1}, // system font
-        {0, 0, 1, 256,  16, 8,  sizeof(tic_tile), tic_tool_peek4, tic_tool_poke4}, // 4bpp p0 bg
-        {0, 1, 1, 256,  16, 8,  sizeof(tic_tile), tic_tool_peek4, tic_tool_poke4}, // 4bpp p0 fg
-
-        {0, 0, 2, 512,  32, 16, sizeof(tic_tile), tic_tool_peek2, tic_tool_poke2}, // 2bpp p0 bg
-        {1, 0, 2, 512,  32, 16, sizeof(tic_tile), tic_tool_peek2, tic_tool_poke2}, // 2bpp p1 bg
-        {0, 1, 2, 512,  32, 16, sizeof(tic_tile), tic_tool_peek2, tic_tool_poke2}, // 2bpp p0 fg
-        {1, 1, 2, 512,  32, 16, sizeof(tic_tile), tic_tool_peek2, tic_tool_poke2}, // 2bpp p1 fg
-
-        {0, 0, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p0 bg
-        {1, 0, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p1 bg
-        {2, 0, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p2 bg
-        {3, 0, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p3 bg
-        {0, 1, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p0 fg
-        {1, 1, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p1 fg
-        {2, 1, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p2 fg
-        {3, 1, 4, 1024, 64, 32, sizeof(tic_tile), tic_tool_peek1, tic_tool_poke1}, // 1bpp p3 fg
+    //   |  |  |  |     |   |   +ptr_size         +bpp
+        {0, 0, 1, 256,  16, 8,  TIC_SPRITESIZE,   1, tic_tool_peek1, tic_tool_poke1}, // system gfx
+        {0, 0, 1, 256,  16, 8,  TIC_SPRITESIZE,   1, tic_tool_peek1, tic_tool_poke1}, // system font
+        {0, 0, 1, 256,  16, 8,  sizeof(tic_tile), 4, tic_tool_peek4, tic_tool_poke4}, // 4bpp p0 bg
+        {0, 1, 1, 256,  16, 8,  sizeof(tic_tile), 4, tic_tool_peek4, tic_tool_poke4}, // 4bpp p0 fg
+
+        {0, 0, 2, 512,  32, 16, sizeof(tic_tile), 2, tic_tool_peek2, tic_tool_poke2}, // 2bpp p0 bg
+        {1, 0, 2, 512,  32, 16, sizeof(tic_tile), 2, tic_tool_peek2, tic_tool_poke2}, // 2bpp p1 bg
+        {0, 1, 2, 512,  32, 16, sizeof(tic_tile), 2, tic_tool_peek2, tic_tool_poke2}, // 2bpp p0 fg
+        {1, 1, 2, 512,  32, 16, sizeof(tic_tile), 2, tic_tool_peek2, tic_tool_poke2}, // 2bpp p1 fg
+
+        {0, 0, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p0 bg
+        {1, 0, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p1 bg
+        {2, 0, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p2 bg
+        {3, 0, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p3 bg
+        {0, 1, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p0 fg
+        {1, 1, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p1 fg
+        {2, 1, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p2 fg
+        {3, 1, 4, 1024, 64, 32, sizeof(tic_tile), 1, tic_tool_peek1, tic_tool_poke1}, // 1bpp p3 fg
 };
 
 extern u8 tic_tilesheet_getpix(const tic_tilesheet* sheet, s32 x, s32 y);
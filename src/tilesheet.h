@@ -34,6 +34,7 @@ typedef struct
     u32    sheet_width;
     u32    tile_width;
     size_t ptr_size;
+    u32    bpp;
     u8     (*peek)(const void*, u32);
     void   (*poke)(void*, u32, u8);
 } tic_blit_segment;
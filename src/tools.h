@@ -101,6 +101,12 @@ void    tic_tool_str2buf(const char* str, s32 size, void* buf, bool flip);
 u32     tic_tool_zip(void* dest, s32 destSize, const void* source, s32 size);
 u32     tic_tool_unzip(void* dest, s32 bufSize, const void* source, s32 size);
 
+// streaming unzip, reads the data in parts without inflating the whole buffer
+typedef struct tic_unzip tic_unzip;
+tic_unzip*  tic_tool_unzip_open(const void* source, s32 size);
+s32         tic_tool_unzip_read(tic_unzip* zip, void* dest, s32 size); // skips the data if dest is NULL
+void        tic_tool_unzip_close(tic_unzip* zip);
+
 bool    tic_tool_empty(const void* buffer, s32 size);
 #define EMPTY(BUFFER) (tic_tool_empty((BUFFER), sizeof (BUFFER)))
 
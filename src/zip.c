@@ -22,6 +22,7 @@
 
 #include "tools.h"
 
+#include <stdlib.h>
 #include <zlib.h>
 
 u32 tic_tool_zip(void* dest, s32 destSize, const void* source, s32 size)
@@ -35,3 +36,58 @@ u32 tic_tool_unzip(void* dest, s32 destSize, const void* source, s32 size)
     unsigned long destSizeLong = destSize;
     return uncompress(dest, &destSizeLong, source, size) == Z_OK ? destSizeLong : 0;
 }
+
+struct tic_unzip
+{
+    z_stream stream;
+    bool done;
+};
+
+tic_unzip* tic_tool_unzip_open(const void* source, s32 size)
+{
+    tic_unzip* zip = calloc(1, sizeof(tic_unzip));
+
+    if(zip)
+    {
+        zip->stream.next_in = (Bytef*)source;
+        zip->stream.avail_in = size;
+
+        if(inflateInit(&zip->stream) != Z_OK)
+        {
+            free(zip);
+            zip = NULL;
+        }
+    }
+
+    return zip;
+}
+
+s32 tic_tool_unzip_read(tic_unzip* zip, void* dest, s32 size)
+{
+    enum {SkipSize = 1024};
+    u8 skip[SkipSize];
+
+    s32 total = 0;
+
+    while(total < size && !zip->done)
+    {
+        s32 part = dest ? size - total : MIN(size - total, SkipSize);
+
+        zip->stream.next_out = dest ? (u8*)dest + total : skip;
+        zip->stream.avail_out = part;
+
+        s32 ret = inflate(&zip->stream, Z_NO_FLUSH);
+        total += part - zip->stream.avail_out;
+
+        if(ret != Z_OK)
+            zip->done = true;
+    }
+
+    return total;
+}
+
+void tic_tool_unzip_close(tic_unzip* zip)
+{
+    inflateEnd(&zip->stream);
+    free(zip);
+}
@@ -0,0 +1,200 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// scans a deep folder tree over and over and checks that the scan reports
+// every folder and cart, once, before it says it's done, the launcher prunes
+// the library by what was reported at that moment
+
+#include "studio/system.h"
+#include "studio/fs.h"
+#include "tools.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+enum
+{
+    Depth = 8,
+    Leaves = 4,
+    Carts = 64,
+    Runs = 50,
+};
+
+typedef struct
+{
+    char** paths;
+    s32 count;
+} Paths;
+
+static void addPath(Paths* paths, const char* path)
+{
+    paths->paths = realloc(paths->paths, sizeof(char*) * (paths->count + 1));
+    paths->paths[paths->count++] = strdup(path);
+}
+
+static void freePaths(Paths* paths)
+{
+    for(s32 i = 0; i < paths->count; i++)
+        free(paths->paths[i]);
+
+    free(paths->paths);
+    *paths = (Paths){0};
+}
+
+static s32 pathcmp(const void* a, const void* b)
+{
+    return strcmp(*(const char**)a, *(const char**)b);
+}
+
+static bool isCart(const char* name)
+{
+    return tic_tool_has_ext(name, ".tic");
+}
+
+static void onItem(const fs_scan_item* item, void* data)
+{
+    addPath(data, item->path);
+}
+
+static void makeDir(const char* root, const char* dir, Paths* expected)
+{
+    char path[TICNAME_MAX];
+    snprintf(path, sizeof path, "%s/%s", root, dir);
+    mkdir(path, 0755);
+    addPath(expected, dir);
+}
+
+static void makeCart(const char* root, const char* cart, Paths* expected)
+{
+    char path[TICNAME_MAX];
+    snprintf(path, sizeof path, "%s/%s", root, cart);
+
+    FILE* file = fopen(path, "wb");
+    fputs("tic", file);
+    fclose(file);
+
+    addPath(expected, cart);
+}
+
+// a chain of Depth folders, each with Carts carts and Leaves empty folders, which are
+// scanned well before the folder that queued them has listed all its carts
+static void makeTree(const char* root, Paths* expected)
+{
+    char dir[TICNAME_MAX] = "";
+
+    for(s32 d = 0; d < Depth; d++)
+    {
+        char sub[TICNAME_MAX], name[TICNAME_MAX];
+
+        snprintf(sub, sizeof sub, "%s%sd%i", dir, *dir ? "/" : "", d);
+        strcpy(dir, sub);
+        makeDir(root, dir, expected);
+
+        for(s32 l = 0; l < Leaves; l++)
+        {
+            snprintf(sub, sizeof sub, "%s/l%i", dir, l);
+            makeDir(root, sub, expected);
+        }
+
+        for(s32 c = 0; c < Carts; c++)
+        {
+            snprintf(name, sizeof name, "%s/c%i.tic", dir, c);
+            makeCart(root, name, expected);
+        }
+    }
+
+    // a linked cart is reported, a link back to the root is not followed
+    char path[TICNAME_MAX], name[TICNAME_MAX];
+
+    snprintf(path, sizeof path, "%s/%s/link.tic", root, dir);
+    symlink("c0.tic", path);
+    snprintf(name, sizeof name, "%s/link.tic", dir);
+    addPath(expected, name);
+
+    snprintf(path, sizeof path, "%s/%s/loop", root, dir);
+    symlink(root, path);
+}
+
+static void removeTree(const char* root)
+{
+    char command[TICNAME_MAX + 16];
+    snprintf(command, sizeof command, "rm -rf '%s'", root);
+    system(command);
+}
+
+// studio only hook fs.c links against
+void tic_sys_open_path(const char* path) {}
+
+int main()
+{
+    char root[] = "/tmp/tic80-fs-scan-XXXXXX";
+
+    if(!mkdtemp(root))
+    {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    Paths expected = {0};
+    makeTree(root, &expected);
+    qsort(expected.paths, expected.count, sizeof(char*), pathcmp);
+
+    tic_fs* fs = tic_fs_create(root, NULL);
+    s32 failed = 0;
+
+    for(s32 run = 0; run < Runs; run++)
+    {
+        Paths found = {0};
+        tic_fs_scan* scan = tic_fs_scan_start(fs, "", isCart);
+
+        while(!tic_fs_scan_poll(scan, onItem, &found))
+            usleep(10);
+
+        tic_fs_scan_close(scan);
+
+        qsort(found.paths, found.count, sizeof(char*), pathcmp);
+
+        bool same = found.count == expected.count;
+        for(s32 i = 0; same && i < found.count; i++)
+            same = strcmp(found.paths[i], expected.paths[i]) == 0;
+
+        if(!same)
+        {
+            printf("run %i: %i items reported when done, %i expected\n", run, found.count, expected.count);
+            failed++;
+        }
+
+        freePaths(&found);
+    }
+
+    free(fs);
+    freePaths(&expected);
+    removeTree(root);
+
+    printf("%i of %i scans complete\n", Runs - failed, Runs);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,187 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// runs a few dozen instances of the demo carts at once on a worker pool and
+// checks that every frame of vram matches a run of the same cart on its own,
+// carts are given on the command line
+
+#include <tic80.h>
+#include "api.h"
+#include "jobs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+enum
+{
+    Instances = 32,
+    Threads = 8,
+    Frames = 120,
+};
+
+typedef struct
+{
+    const char* path;
+    void* data;
+    s32 size;
+
+    u64 hashes[Frames];
+} Cart;
+
+typedef struct
+{
+    const Cart* cart;
+    u64 hashes[Frames];
+} Run;
+
+static s32 errors;
+
+static u64 hash(const void* data, size_t size, u64 value)
+{
+    const u8* ptr = data;
+
+    // FNV-1a
+    while(size--)
+        value = (value ^ *ptr++) * 0x100000001b3ull;
+
+    return value;
+}
+
+// time() doesn't move, frames depend on the cart alone
+static u64 counter() {return 0;}
+static u64 freq() {return 1000;}
+
+static void onError(const char* info)
+{
+    printf("error: %s\n", info);
+    errors++;
+}
+
+static void onThreadError(const char* info)
+{
+    printf("error: %s\n", info);
+}
+
+static void runCart(const Cart* cart, u64* hashes, void(*error)(const char*))
+{
+    tic80* tic = tic80_create(TIC80_SAMPLERATE, TIC80_PIXEL_COLOR_RGBA8888);
+    tic->callback.error = error;
+
+    tic80_load(tic, cart->data, cart->size);
+
+    tic80_input input = {0};
+    const tic_ram* ram = ((tic_mem*)tic)->ram;
+
+    for(s32 i = 0; i < Frames; i++)
+    {
+        tic80_tick(tic, input, counter, freq);
+        hashes[i] = hash(&ram->vram, sizeof(tic_vram), 0xcbf29ce484222325ull);
+    }
+
+    tic80_delete(tic);
+}
+
+static void runJob(void* data)
+{
+    Run* run = data;
+    runCart(run->cart, run->hashes, onThreadError);
+}
+
+static bool loadCart(Cart* cart, const char* path)
+{
+    FILE* file = fopen(path, "rb");
+
+    if(!file)
+        return false;
+
+    fseek(file, 0, SEEK_END);
+    cart->size = (s32)ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    cart->path = path;
+    cart->data = malloc(cart->size);
+    bool done = fread(cart->data, cart->size, 1, file) == 1;
+    fclose(file);
+
+    return done;
+}
+
+int main(int argc, char** argv)
+{
+    s32 count = argc - 1;
+
+    if(count == 0)
+    {
+        printf("usage: %s <cart.tic>...\n", argv[0]);
+        return 1;
+    }
+
+    Cart* carts = calloc(count, sizeof(Cart));
+
+    for(s32 i = 0; i < count; i++)
+    {
+        if(!loadCart(&carts[i], argv[i + 1]))
+        {
+            printf("can't read %s\n", argv[i + 1]);
+            return 1;
+        }
+
+        runCart(&carts[i], carts[i].hashes, onError);
+    }
+
+    if(errors)
+        return 1;
+
+    Run* runs = calloc(Instances, sizeof(Run));
+    tic_jobs* jobs = tic_jobs_create(Threads);
+
+    for(s32 i = 0; i < Instances; i++)
+    {
+        runs[i].cart = &carts[i % count];
+        tic_jobs_push(jobs, runJob, &runs[i]);
+    }
+
+    tic_jobs_wait(jobs);
+    tic_jobs_close(jobs);
+
+    s32 failed = 0;
+
+    for(s32 i = 0; i < Instances; i++)
+        for(s32 f = 0; f < Frames; f++)
+            if(runs[i].hashes[f] != runs[i].cart->hashes[f])
+            {
+                printf("instance %i, %s: frame %i differs\n", i, runs[i].cart->path, f);
+                failed++;
+                break;
+            }
+
+    printf("%i of %i instances match\n", Instances - failed, Instances);
+
+    for(s32 i = 0; i < count; i++)
+        free(carts[i].data);
+
+    free(carts);
+    free(runs);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,258 @@
+// MIT License
+
+// Copyright (c) 2017 Vadim Grigoruk @nesbox // grigoruk@gmail.com
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+// renders a fixed set of tri(), trib() and ttri() cases and compares the
+// screen against hashes of the output before tri/ttri moved to row spans,
+// run with --update to print the table again after an intended change
+
+#include <tic80.h>
+#include "api.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef void(*DrawCase)(tic_mem* tic);
+
+static u32 seed;
+
+static u32 rnd()
+{
+    // xorshift32
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return seed;
+}
+
+// a random coordinate in quarter pixels, a quarter of them land on a pixel edge or center
+static float coord(s32 from, s32 to)
+{
+    return from + (float)(rnd() % ((to - from) * 4)) / 4;
+}
+
+static u64 hash(const void* data, size_t size, u64 value)
+{
+    const u8* ptr = data;
+
+    // FNV-1a
+    while(size--)
+        value = (value ^ *ptr++) * 0x100000001b3ull;
+
+    return value;
+}
+
+static void texture(tic_mem* tic, float x1, float y1, float x2, float y2, float x3, float y3,
+    float u1, float v1, float u2, float v2, float u3, float v3, tic_texture_src src, s32 chromakey,
+    float z1, float z2, float z3)
+{
+    u8 colors[] = {chromakey};
+    bool depth = z1 != 0 || z2 != 0 || z3 != 0;
+
+    tic_api_ttri(tic, x1, y1, x2, y2, x3, y3, u1, v1, u2, v2, u3, v3, src, colors, chromakey < 0 ? 0 : 1,
+        z1, z2, z3, depth);
+}
+
+// triangles with every corner on a pixel edge, a pixel center or between them
+static void edges(tic_mem* tic)
+{
+    static const float Offsets[] = {0.f, .5f, .25f, .75f, .999f};
+
+    for(s32 i = 0; i < COUNT_OF(Offsets); i++)
+    {
+        float o = Offsets[i], x = 10 + i * 45;
+
+        tic_api_tri(tic, x + o, 10 + o, x + 40 + o, 10 + o, x + o, 50 + o, 1 + i);
+        tic_api_tri(tic, x + 40 + o, 10 + o, x + 40 + o, 50 + o, x + o, 50 + o, 6 + i);
+        tic_api_trib(tic, x + o, 60 + o, x + 40 + o, 70 + o, x + 10 + o, 100 + o, 11 + i);
+        tic_api_tri(tic, x + o, 110 + o, x + 1 + o, 110 + o, x + 40 + o, 111 + o, 12);
+    }
+}
+
+// a grid of quads split into two triangles each, every edge is shared
+static void shared(tic_mem* tic)
+{
+    enum { Cols = 9, Rows = 6 };
+    float xs[Cols + 1][Rows + 1], ys[Cols + 1][Rows + 1];
+
+    for(s32 c = 0; c <= Cols; c++)
+        for(s32 r = 0; r <= Rows; r++)
+        {
+            xs[c][r] = c * 26.f + coord(-6, 6);
+            ys[c][r] = r * 22.f + coord(-5, 5);
+        }
+
+    for(s32 c = 0; c < Cols; c++)
+        for(s32 r = 0; r < Rows; r++)
+        {
+            tic_api_tri(tic, xs[c][r], ys[c][r], xs[c + 1][r], ys[c + 1][r], xs[c][r + 1], ys[c][r + 1], 1 + (c + r) % 15);
+            tic_api_tri(tic, xs[c + 1][r], ys[c + 1][r], xs[c + 1][r + 1], ys[c + 1][r + 1], xs[c][r + 1], ys[c][r + 1], 1 + (c + r + 7) % 15);
+        }
+}
+
+static void randomTris(tic_mem* tic)
+{
+    for(s32 i = 0; i < 200; i++)
+    {
+        float x1 = coord(-40, 280), y1 = coord(-40, 176), x2 = coord(-40, 280), y2 = coord(-40, 176),
+            x3 = coord(-40, 280), y3 = coord(-40, 176);
+
+        if(i % 4)
+            tic_api_tri(tic, x1, y1, x2, y2, x3, y3, rnd() % 16);
+        else
+            tic_api_trib(tic, x1, y1, x2, y2, x3, y3, rnd() % 16);
+    }
+}
+
+static void clipped(tic_mem* tic)
+{
+    tic_api_tri(tic, -1000, -800, 5000, 60, -300, 4000, 3);
+    tic_api_tri(tic, 120, -5000, 121, 5000, 119.5f, 68, 9);
+
+    tic_api_clip(tic, 23, 17, 101, 67);
+    randomTris(tic);
+
+    texture(tic, -300, -200, 500, 20, 40, 300, 0, 0, 128, 0, 0, 128, tic_tiles_texture, -1, 0, 0, 0);
+    texture(tic, 10, 10, 230, 30, 60, 130, 0, 0, 240, 0, 0, 136, tic_map_texture, 0, 0, 0, 0);
+}
+
+static void textures(tic_mem* tic)
+{
+    for(s32 i = 0; i < 120; i++)
+    {
+        float x1 = coord(-40, 280), y1 = coord(-40, 176), x2 = coord(-40, 280), y2 = coord(-40, 176),
+            x3 = coord(-40, 280), y3 = coord(-40, 176);
+        float u1 = coord(-64, 320), v1 = coord(-64, 320), u2 = coord(-64, 320), v2 = coord(-64, 320),
+            u3 = coord(-64, 320), v3 = coord(-64, 320);
+
+        texture(tic, x1, y1, x2, y2, x3, y3, u1, v1, u2, v2, u3, v3, i % 3, (s32)(rnd() % 17) - 1, 0, 0, 0);
+    }
+}
+
+// quads with different depth at every corner, one with its near corners off screen
+static void perspective(tic_mem* tic)
+{
+    typedef struct { float x, y, z; } Vertex;
+
+    static const Vertex Quads[][4] =
+    {
+        {{-60, 150, 1.f}, {300, 150, 1.f}, {200, 20, 4.f}, {40, 20, 4.f}},
+        {{20, -30, 3.f}, {260, 60, .5f}, {180, 180, .75f}, {-30, 120, 2.5f}},
+    };
+
+    for(s32 q = 0; q < COUNT_OF(Quads); q++)
+    {
+        const Vertex* v = Quads[q];
+        tic_texture_src src = q ? tic_map_texture : tic_tiles_texture;
+
+        texture(tic, v[0].x, v[0].y, v[1].x, v[1].y, v[2].x, v[2].y, 0, 128, 128, 128, 128, 0, src, q - 1, v[0].z, v[1].z, v[2].z);
+        texture(tic, v[0].x, v[0].y, v[2].x, v[2].y, v[3].x, v[3].y, 0, 128, 128, 0, 0, 0, src, q - 1, v[0].z, v[2].z, v[3].z);
+    }
+}
+
+// equal depth on a shared edge and over a whole overlapping triangle, the first one drawn keeps the pixel
+static void depthTies(tic_mem* tic)
+{
+    texture(tic, 20, 20, 200, 30, 40, 120, 0, 0, 64, 0, 0, 64, tic_tiles_texture, -1, .5f, .5f, .5f);
+    texture(tic, 200, 30, 220, 130, 40, 120, 64, 0, 64, 64, 0, 64, tic_map_texture, -1, .5f, .5f, .5f);
+    texture(tic, 20, 20, 200, 30, 40, 120, 32, 32, 96, 32, 32, 96, tic_vbank_texture, -1, .5f, .5f, .5f);
+    texture(tic, 60, 10, 180, 100, 10, 90, 0, 0, 128, 0, 0, 128, tic_tiles_texture, 0, .25f, .75f, .5f);
+}
+
+#define CASE(draw, hash) {#draw, draw, hash}
+
+static const struct
+{
+    const char* name;
+    DrawCase draw;
+    u64 hash;
+} Cases[] =
+{
+    CASE(edges,       0xed7828b0796966a8ull),
+    CASE(shared,      0x0c402ccdc402d040ull),
+    CASE(randomTris,  0x2f8ca32e1b8c6538ull),
+    CASE(clipped,     0x65ba438165a7046cull),
+    CASE(textures,    0x0864052201572c0aull),
+    CASE(perspective, 0xd51f8067573a4a14ull),
+    CASE(depthTies,   0xc0c3b191607dad7eull),
+};
+
+#undef CASE
+
+int main(int argc, char** argv)
+{
+    bool update = argc > 1 && strcmp(argv[1], "--update") == 0;
+
+    tic80* tic80 = tic80_create(TIC80_SAMPLERATE, TIC80_PIXEL_COLOR_RGBA8888);
+    tic_mem* tic = (tic_mem*)tic80;
+
+    // the sprite sheets, the map and the second vbank get the same noise on every run
+    seed = 0x7f4a7c15;
+
+    for(s32 i = 0; i < sizeof tic->ram->tiles; i++)
+        ((u8*)&tic->ram->tiles)[i] = rnd();
+
+    for(s32 i = 0; i < sizeof tic->ram->sprites; i++)
+        ((u8*)&tic->ram->sprites)[i] = rnd();
+
+    for(s32 i = 0; i < sizeof tic->ram->map; i++)
+        ((u8*)&tic->ram->map)[i] = rnd();
+
+    tic_api_vbank(tic, 1);
+    for(s32 i = 0; i < sizeof tic->ram->vram.screen; i++)
+        tic->ram->vram.screen.data[i] = rnd();
+    tic_api_vbank(tic, 0);
+
+    s32 failed = 0;
+
+    for(s32 i = 0; i < COUNT_OF(Cases); i++)
+    {
+        seed = 0x2545f491 + i;
+
+        tic_api_clip(tic, 0, 0, TIC80_WIDTH, TIC80_HEIGHT);
+        tic_api_cls(tic, 0);
+
+        Cases[i].draw(tic);
+
+        // any read of ram finishes the queued ttri calls first
+        tic_api_peek(tic, 0, BITS_IN_BYTE);
+
+        u64 value = hash(&tic->ram->vram.screen, sizeof tic->ram->vram.screen, 0xcbf29ce484222325ull);
+
+        if(update)
+            printf("    CASE(%s,%*s0x%016llxull),\n", Cases[i].name, (s32)(12 - strlen(Cases[i].name)), "",
+                (unsigned long long)value);
+        else if(value != Cases[i].hash)
+        {
+            printf("%s: screen hash %016llx, expected %016llx\n", Cases[i].name,
+                (unsigned long long)value, (unsigned long long)Cases[i].hash);
+            failed++;
+        }
+    }
+
+    tic80_delete(tic80);
+
+    if(!update)
+        printf("%i of %i cases match\n", (s32)COUNT_OF(Cases) - failed, (s32)COUNT_OF(Cases));
+
+    return failed ? 1 : 0;
+}